@@ -2,11 +2,13 @@
 
 #include "Component.h"
 #include "Transform.h"
+#include "Coroutine.h"
 
 namespace UniDx {
 
 class Collider;
 struct Collision;
+struct ControllerColliderHit;
 
 // --------------------
 // Behaviour基底クラス
@@ -14,6 +16,14 @@ struct Collision;
 class Behaviour : public Component
 {
 public:
+    // 実行順。小さいほど先に呼ばれる（有効化したときの値で登録される）
+    int executionOrder = 0;
+
+    // 派生クラスで true にすると、Update() をワーカースレッドで並列に呼ぶ
+    // 自身のTransformと自身のメンバだけを書き換えるBehaviourに限ること
+    // Destroy()/AddComponent() はCommandBufferに記録され、並列区間の後で実行される
+    static constexpr bool parallelUpdate = false;
+
     virtual void FixedUpdate() {}
     virtual void Update() {}
     virtual void LateUpdate() {}
@@ -23,8 +33,24 @@ public:
     virtual void OnCollisionEnter(const Collision& collision) {}
     virtual void OnCollisionStay(const Collision& collision) {}
     virtual void OnCollisionExit(const Collision& collision) {}
+    virtual void OnControllerColliderHit(const ControllerColliderHit& hit) {}
+
+    // ObjectPoolから取り出されたとき・戻されたとき。使い回す前の状態のリセットに使う
+    virtual void OnSpawn() {}
+    virtual void OnDespawn() {}
+
+    Behaviour() = default;
+    Behaviour(const Behaviour& other) : Component(other), executionOrder(other.executionOrder) {}   // コルーチンは引き継がない
+    virtual ~Behaviour();
+
+    /** @brief コルーチンを開始する。最初の co_await まではその場で実行される */
+    CoroutineHandle StartCoroutine(Coroutine coroutine);
 
-    virtual ~Behaviour() = default;
+    /** @brief StartCoroutine() で開始したコルーチンを止める */
+    void StopCoroutine(CoroutineHandle handle);
+
+    /** @brief このBehaviourで開始したコルーチンをすべて止める（破棄されたときも止まる） */
+    void StopAllCoroutines();
 
     template<typename T>
     T* GetComponent(bool includeInactive = false) const { return gameObject->GetComponent<T>(includeInactive); }
@@ -36,6 +62,15 @@ public:
         if (c != nullptr || transform->parent == nullptr) return c;
         return transform->parent->gameObject->GetComponent<T>(includeInactive);
     }
+
+protected:
+    // 休眠するときはコルーチンも止める
+    virtual void setDormant(bool value) override;
+
+private:
+    uint32_t coroutineCount_ = 0;   // 実行中のコルーチンの数
+
+    friend class CoroutineScheduler;
 };
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Behaviour.h"
+#include "ConstantBuffer.h"
 
 
 namespace UniDx {
@@ -21,14 +22,12 @@ public:
 
     Matrix4x4 GetProjectionMatrix(float aspect) const;
 
-    // 定数バッファ更新
-    void UpdateConstantBuffer();
+    // カメラと時間の定数バッファの中身を作る
+    void makeConstantBuffer(ConstantBufferPerCamera& cb) const;
 
 protected:
     virtual void OnEnable() override;
     virtual void OnDisable() override;
-
-    ComPtr<ID3D11Buffer> constantBufferPerCamera; // カメラごとにGPUで共通利用する定数バッファ
 };
 
 } // namespace UniDx
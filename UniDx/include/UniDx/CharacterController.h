@@ -0,0 +1,89 @@
+﻿#pragma once
+
+#include <cstdint>
+
+#include "Component.h"
+#include "Collision.h"
+#include "Layer.h"
+
+namespace UniDx {
+
+class Collider;
+class CharacterController;
+class Physics;
+
+
+// Move() で接触した方向（Unity互換）
+enum CollisionFlags
+{
+    CollisionFlags_None = 0,
+    CollisionFlags_Sides = 1,
+    CollisionFlags_Above = 2,
+    CollisionFlags_Below = 4,
+};
+
+
+// --------------------
+// ControllerColliderHit情報
+// --------------------
+struct ControllerColliderHit
+{
+    CharacterController* controller = nullptr;
+    Collider* collider = nullptr;
+    Vector3 point;
+    Vector3 normal;
+    Vector3 moveDirection;
+    float moveLength = 0.0f;
+};
+
+
+// --------------------
+// CharacterControllerクラス
+// Rigidbodyを使わず、球を掃引して静的なコライダーに沿って滑らせるキャラクター移動
+// 物理ワールドには登録しないので、ブロードフェーズや衝突コールバックのコストがかからない
+// --------------------
+class CharacterController : public Component
+{
+public:
+    Vector3 center{ 0, 0, 0 };      // 球の中心（ローカル座標。回転に合わせて向きが変わる）
+    float radius = 0.5f;
+    float stepOffset = 0.3f;        // 登れる段差の高さ
+    float slopeLimit = 45.0f;       // 登れる斜面の角度°
+    float skinWidth = 0.02f;        // コライダーとの間に残す隙間
+
+    // レイヤーベースの衝突フィルタリング（Colliderと同じ規則）.
+    int layer = Layer::Default;
+    uint32_t layerMask = LayerMask::Everything;
+
+    /**
+     * @brief motion だけ移動する。ぶつかったら面に沿って滑る
+     * 接触したコライダーは OnControllerColliderHit() で通知する
+     */
+    CollisionFlags Move(Vector3 motion);
+
+    /** @brief 直前の Move() で足元が接地したか */
+    bool isGrounded() const { return (collisionFlags_ & CollisionFlags_Below) != 0; }
+
+    /** @brief 直前の Move() で接触した方向 */
+    CollisionFlags collisionFlags() const { return collisionFlags_; }
+
+    /** @brief 直前の Move() で実際に動いた速度 */
+    Vector3 velocity() const { return velocity_; }
+
+private:
+    static constexpr int MaxSlideIterations = 4;
+
+    CollisionFlags collisionFlags_ = CollisionFlags_None;
+    Vector3 velocity_;
+    std::vector<Collider*> overlaps_;       // 押し出し用の作業領域
+    std::vector<Collider*> reportedHits_;   // 1回の Move() で通知済みのコライダー
+
+    bool canCollide(const Collider* other) const;
+    bool isWalkable(Vector3 normal) const;
+    bool sweep(Physics* world, Vector3 pos, Vector3 direction, float distance, RaycastHit* hit) const;
+    Vector3 depenetrate(Physics* world, Vector3 pos);
+    Vector3 moveAndSlide(Physics* world, Vector3 pos, Vector3 motion, bool vertical, CollisionFlags& flags);
+    void reportHit(const RaycastHit& hit, Vector3 direction, float length);
+};
+
+} // namespace UniDx
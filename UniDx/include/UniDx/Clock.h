@@ -0,0 +1,119 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "UniDxDefine.h"
+
+
+namespace UniDx
+{
+
+// --------------------
+// Clock基底クラス
+// Time がフレームごとの経過時間を読むクロック
+// 実時間のほか、決まった時間ずつ進むものや、与えた列のとおりに進むものに差し替えられる
+// --------------------
+class Clock
+{
+public:
+    virtual ~Clock() = default;
+
+    /** @brief 計り始めに戻す（ループの開始時に呼ばれる） */
+    virtual void reset() {}
+
+    /** @brief 前回の tick() から経過した秒数。フレームの終わりに1回呼ばれる */
+    virtual double tick() = 0;
+};
+
+
+// --------------------
+// RealTimeClockクラス
+// 実際に経過した時間。待たないので、ヘッドレスでは上限なしで回る
+// --------------------
+class RealTimeClock : public Clock
+{
+public:
+    virtual void reset() override { last_ = std::chrono::steady_clock::now(); }
+
+    virtual double tick() override
+    {
+        auto now = std::chrono::steady_clock::now();
+        double dt = std::chrono::duration<double>(now - last_).count();
+        last_ = now;
+        return dt;
+    }
+
+private:
+    std::chrono::steady_clock::time_point last_ = std::chrono::steady_clock::now();
+};
+
+
+// --------------------
+// FixedStepClockクラス
+// 実時間に関係なく、毎フレーム step 秒ずつ進む仮想の時計
+// --------------------
+class FixedStepClock : public Clock
+{
+public:
+    explicit FixedStepClock(double step = 1.0 / 60.0) : step_(step) {}
+
+    virtual double tick() override { return step_; }
+
+    double step() const { return step_; }
+
+private:
+    double step_;
+};
+
+
+// --------------------
+// ScriptedClockクラス
+// 与えた経過時間の列を順に返す。使い切った後は最後の値を返し続ける
+// --------------------
+class ScriptedClock : public Clock
+{
+public:
+    explicit ScriptedClock(std::vector<double> deltaTimes) : deltaTimes_(std::move(deltaTimes)) {}
+
+    virtual void reset() override { cursor_ = 0; }
+
+    virtual double tick() override
+    {
+        if (deltaTimes_.empty()) return 0.0;
+        double dt = deltaTimes_[std::min(cursor_, deltaTimes_.size() - 1)];
+        if (cursor_ < deltaTimes_.size()) ++cursor_;
+        return dt;
+    }
+
+    /** @brief 列を使い切ったか */
+    bool isFinished() const { return cursor_ >= deltaTimes_.size(); }
+
+private:
+    std::vector<double> deltaTimes_;
+    size_t cursor_ = 0;
+};
+
+
+// --------------------
+// Determinismクラス
+// 実行を再現できるようにする全体の切り替え
+// 有効にすると Time を固定ステップのクロックに差し替え、Random::global() を決まったシードで初期化し直す
+// 以降に既定のシードで作った Random も、作った順に決まったシードになる
+// --------------------
+class Determinism
+{
+public:
+    static constexpr uint64_t DefaultSeed = 0x2545F4914F6CDD1Dull;
+
+    /** @brief 決定的な実行に切り替える。step が 0 なら Time::fixedDeltaTime で進める */
+    static void Enable(uint64_t seed = DefaultSeed, double step = 0.0);
+
+    /** @brief 実時間と時刻由来のシードに戻す */
+    static void Disable();
+
+    static bool isEnabled();
+};
+
+} // namespace UniDx
@@ -19,6 +19,18 @@ namespace UniDx
     class Collider : public Component
     {
     public:
+        Collider() = default;
+
+        // 複製用のコンストラクタ。設定だけをコピーし、登録先と剛体は OnEnable() で探し直す
+        Collider(const Collider& other) :
+            Component(other),
+            isTrigger(other.isTrigger),
+            bounciness(other.bounciness),
+            layer(other.layer),
+            layerMask(other.layerMask)
+        {
+        }
+
         Rigidbody* attachedRigidbody = nullptr;
         bool isTrigger = false;
 
@@ -40,14 +52,18 @@ namespace UniDx
         virtual void OnEnable() override
         {
             attachedRigidbody = findNearestRigidbody(transform);
-            Physics::getInstance()->register3d(this);
+            world_ = Physics::of(gameObject);
+            if (world_ != nullptr) world_->register3d(this);
         }
 
         virtual void OnDisable() override
         {
-            Physics::getInstance()->unregister3d(this);
+            if (world_ != nullptr) world_->unregister3d(this);
         }
 
+        // 登録している物理ワールド
+        Physics* getWorld() const { return world_; }
+
         // ワールド空間における空間境界を取得
         virtual Bounds getBounds() const = 0;
 
@@ -55,6 +71,13 @@ namespace UniDx
         // 始点が内部のときは false を返す
         virtual bool Raycast(Vector3 origin, Vector3 direction, float maxDistance, RaycastHit* hitInfo = nullptr) = 0;
 
+        // 球を direction (正規化済み) に動かしたときの衝突チェック
+        // 始点で既に接触しているときは false を返す
+        virtual bool SphereCast(Vector3 origin, float radius, Vector3 direction, float maxDistance, RaycastHit* hitInfo = nullptr) = 0;
+
+        // コライダー上で指定点に最も近い点。内部の点はそのまま返す
+        virtual Vector3 ClosestPoint(Vector3 position) const = 0;
+
         // トリガーチェック
         virtual bool intersects(Collider* other) = 0;
         virtual bool intersects(SphereCollider* other) = 0;
@@ -66,7 +89,29 @@ namespace UniDx
         virtual bool checkIntersect(SphereCollider* other, PhysicsActor* myActor, PhysicsActor* otherActor) = 0;
         virtual bool checkIntersect(AABBCollider* other, PhysicsActor* myActor, PhysicsActor* otherActor) = 0;
 
+    protected:
+        // 休眠中も物理ワールドへの登録は残し、計算から外すだけにする
+        virtual void setDormant(bool value) override
+        {
+            if (value == isDormant()) return;
+            Component::setDormant(value);
+            if (world_ != nullptr) world_->onDormancyChanged();
+        }
+
+        // 別のシーンへ移ったら、そのシーンの物理ワールドへ登録し直す
+        // 無効のあいだは登録していないので、有効になったときの OnEnable() に任せる
+        virtual void onSceneChanged() override
+        {
+            if (!enabled) return;
+            if (world_ != nullptr) world_->unregister3d(this);
+            attachedRigidbody = findNearestRigidbody(transform);
+            world_ = Physics::of(gameObject);
+            if (world_ != nullptr) world_->register3d(this);
+        }
+
     private:
+        Physics* world_ = nullptr;
+
         Rigidbody* findNearestRigidbody(Transform* t) const;
     };
 
@@ -89,6 +134,12 @@ namespace UniDx
         // 始点が内部のときは false を返す
         virtual bool Raycast(Vector3 origin, Vector3 direction, float maxDistance, RaycastHit* hitInfo = nullptr);
 
+        // 球を動かしたときの衝突チェック
+        virtual bool SphereCast(Vector3 origin, float radius, Vector3 direction, float maxDistance, RaycastHit* hitInfo = nullptr) override;
+
+        // 指定点に最も近い点
+        virtual Vector3 ClosestPoint(Vector3 position) const override;
+
         // トリガーチェック
         virtual bool intersects(Collider* other) { return other->intersects(this); };
         virtual bool intersects(SphereCollider* other);
@@ -120,6 +171,12 @@ namespace UniDx
         // 始点が内部のときは false を返す
         virtual bool Raycast(Vector3 origin, Vector3 direction, float maxDistance, RaycastHit* hitInfo = nullptr);
 
+        // 球を動かしたときの衝突チェック
+        virtual bool SphereCast(Vector3 origin, float radius, Vector3 direction, float maxDistance, RaycastHit* hitInfo = nullptr) override;
+
+        // 指定点に最も近い点
+        virtual Vector3 ClosestPoint(Vector3 position) const override;
+
         // トリガーチェック
         virtual bool intersects(Collider* other) { return other->intersects(this); };
         virtual bool intersects(SphereCollider* other);
@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "UniDxDefine.h"
+
+
+namespace UniDx
+{
+
+// --------------------
+// CommandBufferクラス
+// 並列Update中に行われた構造の変更（Destroy/AddComponentなど）を貯めておき、
+// 並列区間が終わったあとにメインスレッドでまとめて実行する
+// 実行順は記録したBehaviourの実行リスト順で、並列に動かしても結果が変わらない
+// --------------------
+class CommandBuffer
+{
+public:
+    typedef std::function<void()> Command;
+
+    /** @brief 並列区間の中か。true の間は構造の変更をその場で行わずに記録する */
+    static bool isRecording() { return recording; }
+
+    /** @brief コマンドを記録する。並列区間の外ならその場で実行する */
+    static void push(Command command);
+
+    /** @brief 並列区間を開始する（メインスレッドから呼ぶ） */
+    static void begin(size_t workerCount);
+
+    /** @brief 並列区間を終了し、記録したコマンドを順番に実行する */
+    static void end();
+
+    /** @brief このスレッドでこれから記録するコマンドの順番キー */
+    static void setOrder(size_t order);
+
+private:
+    struct Entry
+    {
+        size_t order;
+        Command command;
+    };
+
+    static bool recording;
+    static std::vector<std::vector<Entry>> buffers;    // ワーカーごと（0 はメインスレッド）
+    static std::vector<Entry> otherThreads;             // ワーカー以外のスレッドの分
+    static std::mutex otherThreadsMutex;
+};
+
+}
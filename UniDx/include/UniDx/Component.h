@@ -1,5 +1,10 @@
 ﻿#pragma once
 
+#include <array>
+#include <concepts>
+#include <utility>
+#include <type_traits>
+
 #include "Object.h"
 #include "Property.h"
 
@@ -8,6 +13,9 @@ namespace UniDx {
 // 前方宣言
 class Behaviour;
 class GameObject;
+class Collider;
+struct Collision;
+struct ControllerColliderHit;
 
 /** 
   * @brief コンポーネントを破棄
@@ -16,14 +24,138 @@ class GameObject;
 void Destroy(Component* component);
 
 
+// コンポーネントの種類
+// 追加時に1回だけ判定しておき、毎フレームのdynamic_castを省く
+enum ComponentKind : uint8_t
+{
+    ComponentKind_Behaviour = 1,
+    ComponentKind_Renderer = 2,
+    ComponentKind_Collider = 4,
+};
+
+
+// PlayerLoopの実行フェーズ
+enum UpdatePhase : uint8_t
+{
+    UpdatePhase_Start,
+    UpdatePhase_FixedUpdate,
+    UpdatePhase_Update,
+    UpdatePhase_ParallelUpdate,
+    UpdatePhase_LateUpdate,
+    UpdatePhase_Render,
+    UpdatePhase_Count
+};
+
+
+/**
+ * @brief T が FixedUpdate/Update/LateUpdate をオーバーライドしているフェーズのビット
+ * オーバーライドしていなければ &T::Update は Behaviour のメンバ関数ポインタになる
+ * 静的な型が基底クラスのままのときや、アクセスできないときは実装しているとみなす
+ * T::parallelUpdate が true なら Update は並列実行のリストに回す
+ */
+template<typename T>
+constexpr uint8_t behaviourPhaseMask()
+{
+    constexpr uint8_t all = (1 << UpdatePhase_FixedUpdate) | (1 << UpdatePhase_Update) | (1 << UpdatePhase_LateUpdate);
+    if constexpr (std::is_same_v<T, Component> || std::is_same_v<T, Behaviour>)
+    {
+        return all;
+    }
+    else
+    {
+        uint8_t mask = 0;
+        if constexpr (requires { &T::FixedUpdate; }) {
+            if (!std::is_same_v<decltype(&T::FixedUpdate), void (Behaviour::*)()>) mask |= 1 << UpdatePhase_FixedUpdate;
+        }
+        else mask |= 1 << UpdatePhase_FixedUpdate;
+
+        if constexpr (requires { &T::Update; }) {
+            if (!std::is_same_v<decltype(&T::Update), void (Behaviour::*)()>) mask |= 1 << UpdatePhase_Update;
+        }
+        else mask |= 1 << UpdatePhase_Update;
+
+        if constexpr (requires { &T::LateUpdate; }) {
+            if (!std::is_same_v<decltype(&T::LateUpdate), void (Behaviour::*)()>) mask |= 1 << UpdatePhase_LateUpdate;
+        }
+        else mask |= 1 << UpdatePhase_LateUpdate;
+
+        if constexpr (requires { { T::parallelUpdate } -> std::convertible_to<bool>; }) {
+            if (T::parallelUpdate && (mask & (1 << UpdatePhase_Update))) {
+                mask = (mask & ~(1 << UpdatePhase_Update)) | (1 << UpdatePhase_ParallelUpdate);
+            }
+        }
+        return mask;
+    }
+}
+
+
+// 物理のコールバックの種類
+// 実装しているものだけをビットで持ち、GameObjectは該当するBehaviourにだけ配る
+enum PhysicsEvent : uint8_t
+{
+    PhysicsEvent_TriggerEnter = 1 << 0,
+    PhysicsEvent_TriggerStay = 1 << 1,
+    PhysicsEvent_TriggerExit = 1 << 2,
+    PhysicsEvent_CollisionEnter = 1 << 3,
+    PhysicsEvent_CollisionStay = 1 << 4,
+    PhysicsEvent_CollisionExit = 1 << 5,
+    PhysicsEvent_ControllerColliderHit = 1 << 6,
+};
+
+
+// T::name をオーバーライドしているか。していなければ &T::name は基底の Default 型のメンバ関数ポインタになる
+// 名前が取れない（アクセスできない）ときは実装しているとみなす
+#define UNIDX_OVERRIDES(T, name, Default) \
+    ([]() consteval { if constexpr (requires { &T::name; }) return !std::is_same_v<decltype(&T::name), Default>; else return true; }())
+
+/**
+ * @brief T がオーバーライドしている OnTrigger～, OnCollision～, OnControllerColliderHit のビット
+ * 判定の仕方は behaviourPhaseMask() と同じ。Behaviour以外に対しては使わないこと
+ */
+template<typename T>
+constexpr uint8_t behaviourPhysicsEventMask()
+{
+    constexpr uint8_t all = 0x7f;
+    if constexpr (std::is_same_v<T, Component> || std::is_same_v<T, Behaviour>)
+    {
+        return all;
+    }
+    else
+    {
+        constexpr std::pair<bool, PhysicsEvent> events[] = {
+            { UNIDX_OVERRIDES(T, OnTriggerEnter, void (Behaviour::*)(Collider*)), PhysicsEvent_TriggerEnter },
+            { UNIDX_OVERRIDES(T, OnTriggerStay, void (Behaviour::*)(Collider*)), PhysicsEvent_TriggerStay },
+            { UNIDX_OVERRIDES(T, OnTriggerExit, void (Behaviour::*)(Collider*)), PhysicsEvent_TriggerExit },
+            { UNIDX_OVERRIDES(T, OnCollisionEnter, void (Behaviour::*)(const Collision&)), PhysicsEvent_CollisionEnter },
+            { UNIDX_OVERRIDES(T, OnCollisionStay, void (Behaviour::*)(const Collision&)), PhysicsEvent_CollisionStay },
+            { UNIDX_OVERRIDES(T, OnCollisionExit, void (Behaviour::*)(const Collision&)), PhysicsEvent_CollisionExit },
+            { UNIDX_OVERRIDES(T, OnControllerColliderHit, void (Behaviour::*)(const ControllerColliderHit&)), PhysicsEvent_ControllerColliderHit },
+        };
+
+        uint8_t mask = 0;
+        for (const auto& [overridden, bit] : events)
+        {
+            if (overridden) mask |= bit;
+        }
+        return mask;
+    }
+}
+
+
 // --------------------
 // Component基底クラス
 // --------------------
 class Component : public Object
 {
+    // プロパティのアクセサ
+    bool getEnabled() const { return _enabled && isCalledAwake; }
+    void setEnabled(const bool& value);
+    Transform* getTransform() const;    // GameObject_impl.h で定義
+
 public:
-    Property<bool> enabled;
-    ReadOnlyProperty<Transform*> transform;
+    // 並列Update中に書き換えたときは、並列区間が終わってから切り替わる
+    MemberProperty<&Component::getEnabled, &Component::setEnabled> enabled{ this };
+    ReadOnlyMemberProperty<&Component::getTransform> transform{ this };
 
     GameObject* gameObject = nullptr;
 
@@ -36,6 +168,7 @@ public:
             isCalledAwake = true;
 
             OnEnable();
+            registerUpdatePhases();
         }
     }
 
@@ -51,9 +184,17 @@ public:
 
     bool isDestroyed() const { return isCalledDestroy; }
 
+    // ObjectPoolに戻されて休眠中か
+    bool isDormant() const { return dormant_; }
+
+    // 種類の判定（GameObjectへの追加後に有効）
+    bool isKindOf(ComponentKind kind) const { return (kind_ & kind) != 0; }
+
     virtual ~Component();
 
 protected:
+    virtual StringId getName() const override;
+
     virtual void Awake() {}
     virtual void Start() {}
     virtual void OnEnable() {}
@@ -64,12 +205,42 @@ protected:
     bool isCalledStart;
     bool isCalledDestroy;
     bool _enabled;
+    bool dormant_ = false;
+    uint8_t kind_ = 0;
+    uint8_t phaseMask_ = 0;     // 実装しているフェーズ（追加時に設定）
+    uint8_t physicsEventMask_ = 0;  // 実装している物理のコールバック（追加時に設定）
+
+    // 追加したときの型で複製して target に追加する関数（コピーできない型は nullptr）
+    typedef Component* (*CloneFunc)(const Component& source, GameObject& target);
+    CloneFunc cloneFunc_ = nullptr;
+
+    std::array<int32_t, UpdatePhase_Count> phaseSlots_;   // 実行リスト内の位置（未登録は -1）
+
+    // 有効・無効の切り替えでPlayerLoopの実行リストに出し入れする
+    void registerUpdatePhases();
+    void unregisterUpdatePhases();
+
+    // 休眠の切り替え（ObjectPoolから呼ぶ）
+    // 休眠中は実行リストから外れるが、有効フラグや物理ワールドなどへの登録はそのまま残す
+    virtual void setDormant(bool value);
+
+    // 所属するシーンが変わったとき（GameObjectから呼ぶ）
+    // シーンごとのものへ登録しているコンポーネントは、ここで新しいシーンへ登録し直す
+    virtual void onSceneChanged() {}
 
     Component();
+
+    // 複製用。設定値と種類は引き継ぎ、GameObjectへの所属や呼び出し済みフラグは引き継がない
+    Component(const Component& other);
+
     void doDestroy();
 
     friend void Destroy(Component*);
     friend class GameObject;
+    friend class UpdateList;
+    friend class PlayerLoop;
+    friend class ObjectPool;
+    friend class Prefab;
 };
 
 
@@ -0,0 +1,120 @@
+﻿#pragma once
+
+#include <vector>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+#include "UniDxDefine.h"
+
+
+namespace UniDx {
+
+class Component;
+
+// コンポーネントの型ID
+// 変数テンプレートのアドレスを使うので、RTTIなしでコンパイル時に決まる
+using ComponentTypeId = const void*;
+
+namespace detail
+{
+template<typename T>
+inline constexpr char componentTypeTag = 0;
+}
+
+template<typename T>
+constexpr ComponentTypeId componentTypeId() { return &detail::componentTypeTag<std::remove_cv_t<T>>; }
+
+
+/**
+ * @brief 追加時に索引へ登録しておく基底クラス
+ * クラス内で using ComponentBases = std::tuple<Base1, Base2>; と書くと、
+ * GetComponent<Base1>() が最初の呼び出しから索引で引けるようになる
+ */
+template<typename T>
+struct ComponentBaseTypes { using type = std::tuple<>; };
+
+template<typename T>
+    requires requires { typename T::ComponentBases; }
+struct ComponentBaseTypes<T> { using type = typename T::ComponentBases; };
+
+
+// --------------------
+// ComponentIndexクラス
+// GameObjectごとの「型ID → コンポーネント」の索引
+// 型IDでソートした配列を二分探索する。同じ型の中では追加順を保つ
+// 索引に載っている型は、コンポーネントの追加時にその型へのキャストを1回だけ試して登録する
+// 引くだけなら書き換えないので、並列Update中に複数のスレッドから引いてよい
+// --------------------
+class ComponentIndex
+{
+public:
+    typedef std::vector<unique_ptr<Component>> ComponentContainer;
+    typedef void* (*CastFunc)(Component*);
+
+    struct Entry
+    {
+        ComponentTypeId type;
+        Component* component;
+        void* ptr;              // T* へキャスト済みのポインタ
+    };
+
+    /** @brief T 型として一致するコンポーネントを追加順で返す。T 型が索引に載っていなければ nullopt */
+    template<typename T>
+    std::optional<std::span<const Entry>> find() const
+    {
+        ComponentTypeId id = componentTypeId<T>();
+        if (!isTracked(id)) return std::nullopt;
+        return equalRange(id);
+    }
+
+    /** @brief T 型を索引に載せる。索引を書き換えるので、並列区間の外でだけ呼ぶ */
+    template<typename T>
+    void track(const ComponentContainer& components)
+    {
+        track(componentTypeId<T>(), &castTo<T>, components);
+    }
+
+    /** @brief コンポーネントが追加されたときに呼ぶ。T は追加したときの静的な型 */
+    template<typename T>
+    void onAdded(Component* component, const ComponentContainer& components)
+    {
+        // 既に索引に載っている型について登録
+        addToTracked(component);
+
+        // 自身の型と宣言された基底を索引に載せる
+        track(componentTypeId<T>(), &castTo<T>, components);
+        trackBases<T>(components, typename ComponentBaseTypes<T>::type{});
+    }
+
+    /** @brief コンポーネントが削除されるときに呼ぶ */
+    void onRemoved(const Component* component);
+
+private:
+    struct TrackedType
+    {
+        ComponentTypeId type;
+        CastFunc cast;
+    };
+
+    std::vector<Entry> entries_;        // 型IDでソート
+    std::vector<TrackedType> tracked_;
+
+    template<typename T>
+    static void* castTo(Component* c) { return dynamic_cast<T*>(c); }
+
+    template<typename T, typename... Bases>
+    void trackBases(const ComponentContainer& components, std::tuple<Bases...>)
+    {
+        (track(componentTypeId<Bases>(), &castTo<Bases>, components), ...);
+    }
+
+    bool isTracked(ComponentTypeId type) const;
+    void track(ComponentTypeId type, CastFunc cast, const ComponentContainer& components);
+    void addToTracked(Component* component);
+    void insert(ComponentTypeId type, Component* component, void* ptr);
+    std::span<const Entry> equalRange(ComponentTypeId type) const;
+};
+
+} // namespace UniDx
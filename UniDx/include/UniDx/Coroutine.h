@@ -0,0 +1,270 @@
+﻿#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "UniDxDefine.h"
+
+
+/**
+ * @file Coroutine.h
+ * @brief C++20コルーチンによるBehaviourのコルーチン
+ *
+ * Coroutine Blink()
+ * {
+ *     while (true)
+ *     {
+ *         co_await WaitForSeconds(0.5f);
+ *         ...
+ *     }
+ * }
+ * StartCoroutine(Blink());
+ *
+ * 待っている間は呼ばれず、PlayerLoopのスケジューラが再開の時刻になったものだけを再開する。
+ * コルーチンはメインスレッドだけで動かす。
+ */
+namespace UniDx
+{
+
+class Behaviour;
+class CoroutineScheduler;
+
+
+// --------------------
+// CoroutineFrameAllocatorクラス
+// コルーチンフレーム用のプール
+// サイズを2のべき乗に切り上げ、同じサイズのブロックを使い回す
+// プールは破棄しない。静的オブジェクトの破棄の順番によらず、最後に残ったフレームも解放できる
+// --------------------
+class CoroutineFrameAllocator
+{
+public:
+    static void* allocate(size_t size);
+    static void deallocate(void* p, size_t size);
+
+private:
+    static constexpr size_t MinBlockShift = 6;     // 64バイト
+    static constexpr size_t MaxBlockShift = 12;    // 4096バイト。これより大きいフレームは通常のnew
+    static constexpr size_t PageSize = 64 * 1024;
+
+    struct FreeBlock { FreeBlock* next; };
+    struct Pool
+    {
+        std::mutex mutex;
+        FreeBlock* freeLists[MaxBlockShift - MinBlockShift + 1] = {};
+        std::vector<unique_ptr<std::byte[]>> pages;
+    };
+
+    static Pool& pool();
+    static size_t sizeClass(size_t size);
+};
+
+
+// --------------------
+// Coroutineクラス
+// コルーチン関数の戻り値。StartCoroutine() に渡すとスケジューラが所有する
+// --------------------
+class Coroutine
+{
+public:
+    struct promise_type
+    {
+        CoroutineScheduler* scheduler = nullptr;
+        uint32_t slot = 0;
+
+        Coroutine get_return_object() { return Coroutine(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+        // StartCoroutine() で最初の待機まで進める
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // 終了したフレームはスケジューラが破棄する
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(size_t size) { return CoroutineFrameAllocator::allocate(size); }
+        static void operator delete(void* p, size_t size) { CoroutineFrameAllocator::deallocate(p, size); }
+    };
+    typedef std::coroutine_handle<promise_type> Handle;
+
+    Coroutine(Coroutine&& other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+    Coroutine& operator=(Coroutine&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_) handle_.destroy();
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+    Coroutine(const Coroutine&) = delete;
+    Coroutine& operator=(const Coroutine&) = delete;
+
+    ~Coroutine() { if (handle_) handle_.destroy(); }
+
+    // 所有権を手放す（スケジューラに渡すとき）
+    Handle release() { Handle h = handle_; handle_ = nullptr; return h; }
+
+private:
+    explicit Coroutine(Handle h) : handle_(h) {}
+    Handle handle_;
+};
+
+
+// 実行中のコルーチンのハンドル
+// 世代番号が一致している間だけ有効で、終了するとスロットの世代が進む
+struct CoroutineHandle
+{
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return slot != UINT32_MAX; }
+};
+
+
+// --------------------
+// 待機オブジェクト
+// co_await で使う
+// --------------------
+
+// 次のフレームの Update() の後まで待つ
+struct WaitForNextFrame
+{
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Coroutine::Handle h) const;
+    void await_resume() const noexcept {}
+};
+
+// Time::time で指定した秒数が経つまで待つ（0秒でも次のフレームまでは待つ）
+struct WaitForSeconds
+{
+    float seconds;
+    explicit WaitForSeconds(float s) : seconds(s) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Coroutine::Handle h) const;
+    void await_resume() const noexcept {}
+};
+
+// 次の固定時間更新（物理計算の後）まで待つ
+struct WaitForFixedUpdate
+{
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Coroutine::Handle h) const;
+    void await_resume() const noexcept {}
+};
+
+// 条件が true になるまで待つ。条件は毎フレーム Update() の後に評価する
+struct WaitUntil
+{
+    std::function<bool()> predicate;
+    explicit WaitUntil(std::function<bool()> p) : predicate(std::move(p)) {}
+
+    bool await_ready() const { return predicate(); }
+    void await_suspend(Coroutine::Handle h);
+    void await_resume() const noexcept {}
+};
+
+// 条件が true の間待つ
+struct WaitWhile
+{
+    std::function<bool()> predicate;
+    explicit WaitWhile(std::function<bool()> p) : predicate(std::move(p)) {}
+
+    bool await_ready() const { return !predicate(); }
+    void await_suspend(Coroutine::Handle h);
+    void await_resume() const noexcept {}
+};
+
+
+// --------------------
+// CoroutineSchedulerクラス
+// 待機の種類ごとにコルーチンを分けて持ち、再開する時になったものだけを再開する
+// 秒数待ちは再開時刻の最小ヒープで持つので、待っている数が多くても先頭を見るだけで済む
+// --------------------
+class CoroutineScheduler
+{
+public:
+    CoroutineScheduler() = default;
+    CoroutineScheduler(const CoroutineScheduler&) = delete;
+    CoroutineScheduler& operator=(const CoroutineScheduler&) = delete;
+    ~CoroutineScheduler();
+
+    /** @brief コルーチンを登録し、最初の待機まで実行する */
+    CoroutineHandle start(Behaviour* owner, Coroutine coroutine);
+
+    /** @brief コルーチンを止める。実行中のコルーチン自身から呼んだときは次の待機で止まる */
+    void stop(CoroutineHandle handle);
+
+    /** @brief owner が開始したコルーチンをすべて止める */
+    void stopAll(Behaviour* owner);
+
+    /** @brief まだ終了していないか */
+    bool isRunning(CoroutineHandle handle) const;
+
+    /** @brief 次フレーム待ち、秒数待ち、条件待ちのうち再開する時になったものを再開 */
+    void resumeFrame();
+
+    /** @brief 固定時間更新待ちのものを再開 */
+    void resumeFixedUpdate();
+
+    // 待機オブジェクトから呼ばれる
+    void waitForNextFrame(uint32_t slot);
+    void waitForSeconds(uint32_t slot, float seconds);
+    void waitForFixedUpdate(uint32_t slot);
+    void waitUntil(uint32_t slot, std::function<bool()> predicate, bool expected);
+
+private:
+    struct Slot
+    {
+        Coroutine::Handle handle;
+        Behaviour* owner = nullptr;
+        uint32_t generation = 0;
+        bool running = false;
+        bool stopRequested = false;
+    };
+
+    // 待機リストの要素。スロットが再利用されていたら無視する
+    // frame は待ち始めたフレーム。同じフレームのうちには再開しない
+    struct Ref
+    {
+        uint32_t slot;
+        uint32_t generation;
+        int frame = 0;
+    };
+
+    struct Timer
+    {
+        float wakeTime;
+        Ref ref;
+    };
+
+    struct Condition
+    {
+        Ref ref;
+        std::function<bool()> predicate;
+        bool expected;
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> freeSlots_;
+
+    std::vector<Ref> nextFrame_;
+    std::vector<Ref> fixedUpdate_;
+    std::vector<Timer> timers_;         // 最小ヒープ
+    std::vector<Condition> conditions_;
+    std::vector<Ref> due_;              // 再開する分の作業用
+
+    Ref refOf(uint32_t slot) const;
+    bool isAlive(Ref ref) const { return ref.slot < slots_.size() && slots_[ref.slot].generation == ref.generation && slots_[ref.slot].handle; }
+    void resume(Ref ref);
+    void resumeAll(std::vector<Ref>& refs);
+    void release(uint32_t slot);
+};
+
+}
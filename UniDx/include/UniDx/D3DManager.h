@@ -1,13 +1,15 @@
 ﻿#pragma once
 
+#include "UniDxDefine.h"
+#include "Singleton.h"
+
+#if UNIDX_D3D11
 // Direct3Dのライブラリを使用できるようにする
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
 
 #include <d3dcompiler.h>
-
-#include "UniDxDefine.h"
-#include "Singleton.h"
+#endif
 
 
 constexpr UINT UNIDX_PS_SLOT_LIGHTS = 0;  // t0
@@ -22,6 +24,7 @@ namespace UniDx{
 /**
  * @file D3DManager.h
  * @brief DirectXの3D描画機能を提供する
+ * Direct3D のない環境（UNIDX_D3D11 が 0）では作らないので、常にヘッドレスになる
  */
 class D3DManager : public Singleton<D3DManager>
 {
@@ -35,6 +38,10 @@ public:
 	//--------------------------------------------
 	bool Initialize(HWND hWnd, int width, int height);
 
+	// ヘッドレス（デバイスを作らずに）動いているか
+	// GPUのリソースを作る処理は、このとき何もしない
+	static bool isHeadless() { return getInstance() == nullptr; }
+
 	const ComPtr<ID3D11Device>&			GetDevice() const { return m_device; }
 	const ComPtr<ID3D11DeviceContext>&	GetContext() const { return m_context; }
 
@@ -45,10 +52,7 @@ public:
 	void Clear(float r, float g, float b, float a);
 
 	// バックバッファの内容を画面に表示
-	void Present()
-	{
-		m_swapChain->Present(1, 0);
-	}
+	void Present();
 
 	const Vector2& getScreenSize() const { return screenSize; }
 
@@ -5,12 +5,17 @@
 
 #ifdef _DEBUG
 
+#ifndef _WIN32
+#include <cstdio>
+#endif
+
 namespace UniDx
 {
 
 // デバッグ用ネームスペース
 namespace Debug
 {
+#ifdef _WIN32
     inline void log_(const wchar_t* value)
     {
         OutputDebugStringW(value);
@@ -27,6 +32,24 @@ namespace Debug
         OutputDebugStringW(ToUtf16(value).c_str());
         OutputDebugStringW(L"\n");
     }
+#else
+    // デバッガの出力窓がないので標準エラーに出す
+    inline void log_(const wchar_t* value)
+    {
+        std::fputs(reinterpret_cast<const char*>(ToUtf8(value).c_str()), stderr);
+        std::fputc('\n', stderr);
+    }
+    inline void log_(const char* value)
+    {
+        std::fputs(value, stderr);
+        std::fputc('\n', stderr);
+    }
+    inline void log_(const char8_t* value)
+    {
+        std::fputs(reinterpret_cast<const char*>(value), stderr);
+        std::fputc('\n', stderr);
+    }
+#endif
 
     template<typename T>
     inline void Log(const T& v) { log_(ToString(v).c_str()); }
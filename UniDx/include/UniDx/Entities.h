@@ -0,0 +1,352 @@
+﻿#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "UniDxDefine.h"
+#include "Singleton.h"
+#include "Jobs.h"
+#include "FrameArena.h"
+
+/**
+ * @file Entities.h
+ * @brief アーキタイプ（コンポーネントの組み合わせ）ごとにチャンクへ詰めて持つECSストレージ
+ *
+ * GameObjectと並べて使う、データだけのコンポーネント向けの層。
+ * 同じ組み合わせを持つエンティティは同じアーキタイプの16KBチャンクに、型ごとの配列として並ぶ。
+ * システムはクエリに一致するチャンクの配列を先頭から順になめる。
+ *
+ * auto* em = EntityManager::getInstance();
+ * Entity e = em->CreateEntity(Position{ ... }, Velocity{ ... });
+ * em->ForEach<Position, const Velocity>([](Position& p, const Velocity& v) { p.value += v.value * Time::deltaTime; });
+ */
+namespace UniDx
+{
+
+class EntityArchetype;
+class EntityManager;
+
+
+// エンティティのハンドル
+// 世代番号が一致している間だけ有効
+struct Entity
+{
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != UINT32_MAX; }
+    bool operator==(const Entity&) const = default;
+};
+
+
+// チャンクに入れられるコンポーネントの条件
+// memcpy で移動し、デストラクタを呼ばずに捨てるのでトリビアルな型に限る
+template<typename T>
+concept EntityComponentData = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T> && !std::is_empty_v<T>;
+
+
+// --------------------
+// EntityComponentTypesクラス
+// コンポーネントの型に 0 から順に番号を振る
+// --------------------
+class EntityComponentTypes
+{
+public:
+    static constexpr uint32_t MaxTypes = 64;    // 組み合わせを64bitのマスクで表すため
+
+    struct Info
+    {
+        size_t size;
+        size_t align;
+    };
+
+    template<EntityComponentData T>
+    static uint32_t id()
+    {
+        static const uint32_t value = registerType(sizeof(T), alignof(T));
+        return value;
+    }
+
+    template<typename T>
+    static uint64_t bit() { return uint64_t(1) << id<std::remove_const_t<T>>(); }
+
+    static const Info& info(uint32_t id);
+
+private:
+    static uint32_t registerType(size_t size, size_t align);
+};
+
+
+// --------------------
+// EntityChunkクラス
+// 1つのアーキタイプのエンティティを固定サイズのメモリに型ごとの配列（SoA）で持つ
+// --------------------
+class EntityChunk
+{
+public:
+    static constexpr size_t Size = 16 * 1024;
+
+    explicit EntityChunk(const EntityArchetype* archetype);
+    ~EntityChunk();
+
+    EntityChunk(const EntityChunk&) = delete;
+    EntityChunk& operator=(const EntityChunk&) = delete;
+
+    /** @brief 入っているエンティティの数 */
+    size_t count() const { return count_; }
+
+    /** @brief エンティティの配列 */
+    const Entity* entities() const { return reinterpret_cast<const Entity*>(data_); }
+
+    /** @brief 型の配列。アーキタイプが持っていなければ nullptr */
+    template<typename T>
+    T* column() const;
+
+private:
+    const EntityArchetype* archetype_;
+    std::byte* data_;
+    uint32_t count_ = 0;
+
+    Entity* mutableEntities() { return reinterpret_cast<Entity*>(data_); }
+    std::byte* columnData(size_t column) const;
+
+    friend class EntityArchetype;
+    friend class EntityManager;
+};
+
+
+// --------------------
+// EntityArchetypeクラス
+// コンポーネントの組み合わせと、チャンク内の配置
+// --------------------
+class EntityArchetype
+{
+public:
+    explicit EntityArchetype(uint64_t mask);
+
+    uint64_t mask() const { return mask_; }
+
+    /** @brief 1チャンクに入るエンティティの数 */
+    size_t chunkCapacity() const { return capacity_; }
+
+    /** @brief エンティティの数 */
+    size_t entityCount() const;
+
+    const std::vector<std::unique_ptr<EntityChunk>>& chunks() const { return chunks_; }
+
+private:
+    uint64_t mask_;
+    size_t capacity_ = 0;
+    std::vector<uint32_t> types_;                   // 型番号（昇順）
+    std::vector<size_t> offsets_;                   // 型ごとの配列のチャンク先頭からの位置
+    std::array<int8_t, EntityComponentTypes::MaxTypes> columnOf_;  // 型番号から列（なければ -1）
+    std::vector<std::unique_ptr<EntityChunk>> chunks_;
+
+    // 末尾に1行確保する（空きがなければチャンクを足す）
+    std::pair<uint32_t, uint32_t> allocateRow(Entity entity);
+
+    // 行を外し、最後の行を穴に移す。移したエンティティを返す（移していなければ無効）
+    Entity removeRow(uint32_t chunk, uint32_t row);
+
+    std::byte* cell(uint32_t chunk, uint32_t row, size_t column) const;
+
+    friend class EntityChunk;
+    friend class EntityManager;
+};
+
+
+// --------------------
+// EntitySystemクラス
+// EntityManager::update() のたびにクエリを回す処理
+// --------------------
+class EntitySystem
+{
+public:
+    virtual ~EntitySystem() = default;
+    virtual void OnUpdate(EntityManager& entities) = 0;
+};
+
+
+// --------------------
+// EntityManagerクラス
+// エンティティの生成・削除、コンポーネントの追加・削除、クエリ
+// 構造を変える操作はメインスレッドから、クエリの最中以外で呼ぶこと
+// --------------------
+class EntityManager : public Singleton<EntityManager>
+{
+public:
+    EntityManager();
+    virtual ~EntityManager();
+
+    /** @brief 指定したコンポーネントを持つエンティティを作る */
+    template<EntityComponentData... Ts>
+    Entity CreateEntity(const Ts&... values)
+    {
+        Entity e = createEntity((EntityComponentTypes::bit<Ts>() | ... | uint64_t(0)));
+        (setComponent(e, values), ...);
+        return e;
+    }
+
+    /** @brief エンティティを削除する */
+    void DestroyEntity(Entity entity);
+
+    /** @brief まだ生きているか */
+    bool Exists(Entity entity) const;
+
+    /** @brief コンポーネントを追加する。すでにあれば値を上書きする */
+    template<EntityComponentData T>
+    void AddComponent(Entity entity, const T& value)
+    {
+        moveToArchetype(entity, maskOf(entity) | EntityComponentTypes::bit<T>());
+        setComponent(entity, value);
+    }
+
+    /** @brief コンポーネントを外す */
+    template<EntityComponentData T>
+    void RemoveComponent(Entity entity)
+    {
+        moveToArchetype(entity, maskOf(entity) & ~EntityComponentTypes::bit<T>());
+    }
+
+    template<EntityComponentData T>
+    bool HasComponent(Entity entity) const
+    {
+        return Exists(entity) && (maskOf(entity) & EntityComponentTypes::bit<T>()) != 0;
+    }
+
+    /** @brief コンポーネントを取得。なければ nullptr。構造を変えると無効になる */
+    template<EntityComponentData T>
+    T* GetComponent(Entity entity) const
+    {
+        if (!Exists(entity)) return nullptr;
+        const Record& r = records_[entity.index];
+        T* column = r.archetype->chunks_[r.chunk]->template column<T>();
+        return column != nullptr ? column + r.row : nullptr;
+    }
+
+    /** @brief 生きているエンティティの数 */
+    size_t entityCount() const { return records_.size() - freeIndices_.size(); }
+
+    /**
+     * @brief Ts をすべて持つエンティティに func(Ts&...) を呼ぶ
+     * func(Entity, Ts&...) の形ならエンティティも渡す。const を付けた型は読むだけ
+     */
+    template<typename... Ts, typename Func>
+    void ForEach(Func&& func)
+    {
+        forEachChunk<Ts...>([&func](EntityChunk& chunk) {
+            invokeRows<Ts...>(chunk, 0, chunk.count(), func);
+        });
+    }
+
+    /** @brief ForEach() をチャンク単位でジョブシステムに分けて実行する */
+    template<typename... Ts, typename Func>
+    void ParallelForEach(Func&& func)
+    {
+        std::pmr::vector<EntityChunk*> chunks(FrameArena::resource());
+        forEachChunk<Ts...>([&chunks](EntityChunk& chunk) { chunks.push_back(&chunk); });
+
+        ++iterating_;
+        Jobs::parallelForAndWait(chunks.size(), 1, [&chunks, &func](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                invokeRows<Ts...>(*chunks[i], 0, chunks[i]->count(), func);
+            }
+        });
+        --iterating_;
+    }
+
+    /** @brief Ts をすべて持つチャンクに func(EntityChunk&) を呼ぶ。配列をまとめて扱うとき用 */
+    template<typename... Ts, typename Func>
+    void forEachChunk(Func&& func)
+    {
+        const uint64_t query = (EntityComponentTypes::bit<Ts>() | ... | uint64_t(0));
+        ++iterating_;
+        for (auto* archetype : archetypeList_)
+        {
+            if ((archetype->mask() & query) != query) continue;
+            for (auto& chunk : archetype->chunks())
+            {
+                if (chunk->count() > 0) func(*chunk);
+            }
+        }
+        --iterating_;
+    }
+
+    /** @brief システムを登録する。update() で登録順に呼ばれる */
+    template<typename T, typename... Args>
+    T* AddSystem(Args&&... args)
+    {
+        auto system = std::make_unique<T>(std::forward<Args>(args)...);
+        T* result = system.get();
+        systems_.push_back(std::move(system));
+        return result;
+    }
+
+    /** @brief 登録したシステムを実行する（PlayerLoopから毎フレーム呼ぶ） */
+    virtual void update();
+
+private:
+    struct Record
+    {
+        EntityArchetype* archetype = nullptr;
+        uint32_t chunk = 0;
+        uint32_t row = 0;
+        uint32_t generation = 0;
+    };
+
+    std::vector<Record> records_;
+    std::vector<uint32_t> freeIndices_;
+    std::unordered_map<uint64_t, std::unique_ptr<EntityArchetype>> archetypes_;
+    std::vector<EntityArchetype*> archetypeList_;   // 作った順（クエリの順番を決まったものにする）
+    std::vector<std::unique_ptr<EntitySystem>> systems_;
+    int iterating_ = 0;
+
+    Entity createEntity(uint64_t mask);
+    EntityArchetype* getArchetype(uint64_t mask);
+    uint64_t maskOf(Entity entity) const { return records_[entity.index].archetype->mask(); }
+    void moveToArchetype(Entity entity, uint64_t mask);
+    void placeRow(Entity entity, EntityArchetype* archetype);
+    void removeRow(const Record& record);
+
+    template<typename T>
+    void setComponent(Entity entity, const T& value)
+    {
+        *GetComponent<T>(entity) = value;
+    }
+
+    template<typename... Ts, typename Func>
+    static void invokeRows(EntityChunk& chunk, size_t begin, size_t end, Func& func)
+    {
+        auto columns = std::make_tuple(chunk.template column<Ts>()...);
+        const Entity* entities = chunk.entities();
+        for (size_t i = begin; i < end; ++i)
+        {
+            if constexpr (std::is_invocable_v<Func&, Entity, Ts&...>)
+            {
+                std::apply([&](auto*... c) { func(entities[i], c[i]...); }, columns);
+            }
+            else
+            {
+                std::apply([&](auto*... c) { func(c[i]...); }, columns);
+            }
+        }
+    }
+};
+
+
+template<typename T>
+T* EntityChunk::column() const
+{
+    const int column = archetype_->columnOf_[EntityComponentTypes::id<std::remove_const_t<T>>()];
+    if (column < 0) return nullptr;
+    return reinterpret_cast<T*>(columnData(size_t(column)));
+}
+
+} // namespace UniDx
@@ -0,0 +1,86 @@
+﻿#pragma once
+
+#include "Component.h"
+#include "Math.h"
+#include "Entities.h"
+
+
+namespace UniDx
+{
+
+class MeshRenderer;
+class Rigidbody;
+
+
+// --------------------
+// ブリッジで使うECSのコンポーネント
+// --------------------
+
+// 元のGameObject
+struct GameObjectLink
+{
+    GameObject* gameObject;
+};
+
+// Transformのローカルの姿勢
+struct LocalTransformData
+{
+    Vector3 position;
+    Quaternion rotation;
+    Vector3 scale;
+};
+
+// Rigidbodyの速度と設定
+// コンポーネントはブリッジより先に破棄されることがあるので、ポインタは持たずに GameObjectLink から引く
+struct RigidbodyData
+{
+    Vector3 linearVelocity;
+    float gravityScale;
+    float mass;
+};
+
+// MeshRendererの表示
+struct MeshRendererData
+{
+    bool enabled;
+};
+
+
+// --------------------
+// EntityBridgeクラス
+// 付けたGameObjectのTransform、Rigidbody、MeshRendererの値をエンティティのチャンクに置く
+// 毎フレーム、システムの前にGameObjectからチャンクへ読み込み、後で変わった値だけを書き戻す
+// システムは多数のGameObjectの値を連続したメモリでまとめて処理できる
+// --------------------
+class EntityBridge : public Component
+{
+public:
+    EntityBridge() = default;
+
+    // 複製用。エンティティは OnEnable() で作り直す
+    EntityBridge(const EntityBridge& other) : Component(other) {}
+
+    /** @brief 対応するエンティティ（無効の間は無効なハンドル） */
+    Entity entity() const { return entity_; }
+
+    /** @brief ブリッジしているGameObjectの値をチャンクに読み込む */
+    static void pullFromGameObjects(EntityManager& entities);
+
+    /** @brief チャンクで変わった値をGameObjectに書き戻す */
+    static void pushToGameObjects(EntityManager& entities);
+
+protected:
+    virtual void OnEnable() override { createEntity(); }
+    virtual void OnDisable() override { destroyEntity(); }
+
+    // 休眠中はシステムの対象から外す
+    virtual void setDormant(bool value) override;
+
+private:
+    Entity entity_;
+
+    void createEntity();
+    void destroyEntity();
+};
+
+} // namespace UniDx
@@ -18,12 +18,16 @@ class Font : public Object
 {
 public:
 	Font();
+	~Font();
 
 	bool Load(u8string filePath) { return Load(ToUtf16(filePath)); }
 	bool Load(std::wstring filePath);
 
 	DirectX::SpriteFont* getSpriteFont() const;
 
+protected:
+	virtual StringId getName() const override { return fileName; }
+
 private:
 	StringId fileName;
 	unique_ptr<DirectX::SpriteFont> spriteFont;
@@ -0,0 +1,80 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "UniDxDefine.h"
+
+
+namespace UniDx
+{
+
+// --------------------
+// FrameArenaクラス
+// 1フレームの間だけ使う作業用のメモリを先頭から順に確保する
+// スレッドごとに1つあり、PlayerLoop がフレームの終わりにフレーム番号を進める
+// 各スレッドのアリーナは、番号が進んだあとの最初の確保のときに自分のスレッドで巻き戻す
+// （他のスレッドのアリーナを直接触らないので、ワーカーが確保している最中でも競合しない）
+// 個別の解放では何もしない。足りなくなったフレームの後は1つの大きなブロックにまとめ直すので、
+// 定常状態ではヒープを使わない
+//
+// std::pmr::vector<Collider*> hits(FrameArena::resource());
+//
+// フレームをまたいで持ち越すデータや、フレームの終わりまでに待たないジョブでは使わないこと
+// --------------------
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+    static constexpr size_t DefaultBlockSize = 256 * 1024;
+
+    /** @brief このスレッドのアリーナ */
+    static FrameArena& current();
+
+    /** @brief このスレッドのアリーナを pmr のコンテナに渡す形で取得 */
+    static std::pmr::memory_resource* resource() { return &current(); }
+
+    /**
+     * @brief フレームを進め、すべてのスレッドのアリーナを巻き戻させる（メインスレッドからフレームの終わりに呼ぶ）
+     * 呼んだスレッドのアリーナはすぐに、他のスレッドはそれぞれの次の確保のときに巻き戻る
+     */
+    static void resetAll();
+
+    /** @brief 今フレームに確保したバイト数 */
+    size_t used() const { return used_; }
+
+    /** @brief これまでの1フレームの最大使用量 */
+    size_t highWater() const { return highWater_; }
+
+    FrameArena();
+    virtual ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+protected:
+    virtual void* do_allocate(size_t bytes, size_t alignment) override;
+    virtual void do_deallocate(void* p, size_t bytes, size_t alignment) override {}
+    virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    struct Block
+    {
+        std::byte* data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;     // 先頭が常用のブロック、以降はあふれた分
+    size_t offset_ = 0;             // 最後のブロックの使用位置
+    size_t used_ = 0;
+    size_t highWater_ = 0;
+    uint64_t frame_ = 0;            // 最後に巻き戻したときのフレーム番号
+
+    static inline std::atomic<uint64_t> s_frame{ 0 };
+
+    void addBlock(size_t size);
+    void reset();
+};
+
+} // namespace UniDx
@@ -0,0 +1,114 @@
+﻿#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "UniDxDefine.h"
+
+
+namespace UniDx
+{
+
+// フレームの間隔の揃い具合（秒）
+// jitter は目標の間隔とのずれの絶対値
+struct FramePacingStats
+{
+    size_t count = 0;
+    double meanInterval = 0.0;
+    double meanJitter = 0.0;
+    double p99Jitter = 0.0;
+    double maxJitter = 0.0;
+    size_t overBudget = 0;      // jitterBudget を超えたフレーム数
+};
+
+
+// --------------------
+// FrameClock基底クラス
+// FrameLimiter が読む時刻と、待つ手段
+// 既定は steady_clock と OS のタイマーで、テストでは眠らずに時刻だけ進めるものに差し替える
+// --------------------
+class FrameClock
+{
+public:
+    typedef std::chrono::steady_clock::duration duration;
+    typedef std::chrono::steady_clock::time_point time_point;
+
+    virtual ~FrameClock() = default;
+
+    virtual time_point now() = 0;
+
+    /** @brief deadline の少し手前まで眠る。過ぎて起きることもある */
+    virtual void sleepUntil(time_point deadline) = 0;
+
+    /** @brief 回って待つ間の1回分 */
+    virtual void spin() = 0;
+};
+
+
+// --------------------
+// FrameLimiterクラス
+// MainLoop() のフレームの終わりで、次のフレームの開始時刻まで待つ
+// 待つ時間の大半は高分解能タイマーで眠り、最後の spinMargin だけ回って待つので、CPUを使わずに間隔を揃えられる
+// ウィンドウが非アクティブか最小化されている間は unfocusedFrameRate まで落とす
+//
+// Unity と同じく vSyncCount が 1 以上なら垂直同期で待ち、targetFrameRate は使わない
+// FrameLimiter::vSyncCount = 0; FrameLimiter::targetFrameRate = 144;
+// --------------------
+class FrameLimiter
+{
+public:
+    /** @brief Present() で待つ垂直同期の回数。0 なら待たない */
+    static inline int vSyncCount = 1;
+
+    /** @brief 目標のフレームレート。0 以下なら上限なし（vSyncCount が 0 のときだけ使う） */
+    static inline int targetFrameRate = 0;
+
+    /** @brief 非アクティブの間のフレームレート。0 以下なら落とさない */
+    static inline int unfocusedFrameRate = 10;
+
+    /** @brief 眠らずに回って待つ、目標時刻の手前の時間（秒） */
+    static inline double spinMargin = 0.001;
+
+    /** @brief 間隔のずれの許容値（秒）。pacingStats() の overBudget の判定に使う */
+    static inline double jitterBudget = 0.001;
+
+    // clock が nullptr なら実時間で待つ
+    explicit FrameLimiter(std::unique_ptr<FrameClock> clock = nullptr);
+    ~FrameLimiter();
+
+    FrameLimiter(const FrameLimiter&) = delete;
+    FrameLimiter& operator=(const FrameLimiter&) = delete;
+
+    /** @brief 計り始めに戻す。MainLoop() の開始時に呼ぶ */
+    void reset();
+
+    /** @brief 次のフレームの開始時刻まで待つ。focused が false なら unfocusedFrameRate で待つ */
+    void waitForNextFrame(bool focused);
+
+    /** @brief 直近のフレームの間隔の統計。上限をかけていたフレームだけを数える */
+    FramePacingStats pacingStats() const;
+
+private:
+    typedef FrameClock::time_point time_point;
+
+    static constexpr size_t HistorySize = 1024;
+
+    std::unique_ptr<FrameClock> clock_;
+    time_point next_;                   // 次のフレームの開始時刻
+    time_point lastWake_;
+    bool hasLastWake_ = false;
+
+    // 直近のフレームの間隔と目標の間隔
+    struct Sample
+    {
+        double interval;
+        double target;
+    };
+    std::vector<Sample> history_;
+    size_t historyCursor_ = 0;
+
+    void addSample(double interval, double target);
+};
+
+} // namespace UniDx
@@ -6,7 +6,10 @@
 #include <DirectXMath.h>
 
 #include "Object.h"
+#include "Component.h"
 #include "Collision.h"
+#include "ComponentIndex.h"
+#include "CommandBuffer.h"
 
 namespace UniDx {
 
@@ -15,6 +18,8 @@ namespace UniDx {
 class Component;
 class Transform;
 class Collider;
+class Scene;
+struct ControllerColliderHit;
 
 /**
   * @brief GameObjectを破棄
@@ -31,11 +36,11 @@ class GameObject : public Object
 public:
     Transform* transform;
 
-    const std::vector<std::unique_ptr<Component>>& GetComponents() const { return components; }
+    const ComponentIndex::ComponentContainer& GetComponents() const { return components; }
 
     GameObject(const char* n = "GameObject") : GameObject(StringId::intern(std::string_view(n))) {}
     GameObject(const char8_t* n) : GameObject(StringId::intern(n)) {}
-    GameObject(StringId n) : Object([this](){return name_;}), name_(n), isCalledDestroy(false)
+    GameObject(StringId n) : name_(n), isCalledDestroy(false)
     {
         // デフォルトでTransformを追加
         transform = AddComponent<Transform>();
@@ -65,20 +70,19 @@ public:
 
     void Add() {} // ヘルパー関数でパック展開
 
-    // GameObjectとそれ以降の追加
+    // GameObjectとそれ以降の追加。Transformの定義が必要なので GameObject_impl.h で定義
     template<typename... Rest>
-    void Add(std::unique_ptr<GameObject>&& first, Rest&&... rest)
-    {
-        Transform::SetParent(std::move(first), transform);
-        Add(std::forward<Rest>(rest)...);
-    }
+    void Add(std::unique_ptr<GameObject>&& first, Rest&&... rest);
 
     // Componentとそれ以降の追加
     template<typename First, typename... Rest>
     void Add(First&& first, Rest&&... rest)
     {
+        using T = typename std::remove_cvref_t<First>::element_type;
         first->gameObject = this;
+        T* ptr = first.get();
         components.push_back(std::move(first));
+        onComponentAdded<T>(ptr);
         Add(std::forward<Rest>(rest)...);
     }
 
@@ -88,15 +92,38 @@ public:
         auto comp = std::make_unique<T>(std::forward<Args>(args)...);
         comp->gameObject = this;
         T* ptr = comp.get();
+        if (CommandBuffer::isRecording()) {
+            // 並列Update中は登録を後回しにする。GetComponentで引けるのは並列区間の後から
+            // 実行されずに捨てられてもコンポーネントが解放されるよう、実行までは共有ポインタで持っておく
+            auto pending = std::make_shared<std::unique_ptr<T>>(std::move(comp));
+            CommandBuffer::push([this, pending]() { Add(std::move(*pending)); });
+            return ptr;
+        }
         components.push_back(std::move(comp));
+        onComponentAdded<T>(ptr);
         return ptr;
     }
 
+    // 型IDの索引から引くので、2回目以降はRTTIを使わない
+    // 初めての型は索引に載せるが、並列Update中は索引を書き換えずにその場でキャストして探す
     template<typename T>
     [[nodiscard]] T* GetComponent(bool includeInactive = false) {
-        for (auto& comp : components) {
-            auto casted = dynamic_cast<T*>(comp.get());
-            if (casted != nullptr && (comp->enabled || includeInactive && !comp->isDestroyed())) {
+        auto entries = componentIndex.find<T>();
+        if (!entries && !CommandBuffer::isRecording()) {
+            componentIndex.track<T>(components);
+            entries = componentIndex.find<T>();
+        }
+        if (entries) {
+            for (auto& e : *entries) {
+                if (e.component->enabled || includeInactive && !e.component->isDestroyed()) {
+                    return static_cast<T*>(e.ptr);
+                }
+            }
+            return nullptr;
+        }
+        for (auto& c : components) {
+            T* casted = dynamic_cast<T*>(c.get());
+            if (casted != nullptr && (c->enabled || includeInactive && !c->isDestroyed())) {
                 return casted;
             }
         }
@@ -106,13 +133,20 @@ public:
     template<typename Predicate>
     GameObject* Find(Predicate pred) const;
 
-    void SetName(StringId n) { name_ = n; }
-    bool checkDestroy();
+    // 名前の変更。シーンの名前の索引も付け替える
+    void SetName(StringId n);
+
+    // 自身と子孫のコンポーネントで Awake() をまだ呼んでいないものを呼ぶ
+    // シーンが動き出した後に追加した階層に使う
+    void checkAwakeInHierarchy();
+
+    // 所属するシーン（シーンに追加されるまでは nullptr）.
+    Scene* scene() const { return scene_; }
 
     // タグ.
     StringId tag() const { return tag_; }
-    void setTag(StringId t) { tag_ = t; }
-    void setTag(const char8_t* t) { tag_ = StringId::intern(t); }
+    void setTag(StringId t);
+    void setTag(const char8_t* t) { setTag(StringId::intern(t)); }
 
     // タグ比較（Unity互換）.
     bool CompareTag(StringId t) const { return tag_ == t; }
@@ -128,15 +162,89 @@ public:
     virtual void onCollisionEnter(const Collision& collision);
     virtual void onCollisionStay(const Collision& collision);
     virtual void onCollisionExit(const Collision& collision);
+    virtual void onControllerColliderHit(const ControllerColliderHit& hit);
+
+    // 物理のコールバックを実装しているBehaviourがあるか（なければ物理側でイベントを積まない）
+    bool hasPhysicsListener(PhysicsEvent event) const { return (physicsEventMask_ & event) != 0; }
 
 protected:
     StringId name_;
     StringId tag_;                // タグ（デフォルトは空）.
     int layer_ = 0;               // レイヤー（デフォルトは0）.
-    std::vector<std::unique_ptr<Component>> components;
+    ComponentIndex::ComponentContainer components; // 実行中にも増えるのでヒープに置く（単調なアリーナだと伸ばすたびに前の領域が残る）
+    ComponentIndex componentIndex;
+    Scene* scene_ = nullptr;
     bool isCalledDestroy = false;
+    uint32_t nameSlot_ = 0;       // シーンの名前の索引での位置
+    uint32_t tagSlot_ = 0;        // シーンのタグの索引での位置
+    std::vector<Component*> physicsListeners_;  // 物理のコールバックを実装しているBehaviour（追加順）
+    uint8_t physicsEventMask_ = 0;              // physicsListeners_ が実装しているコールバックの和
+
+    virtual StringId getName() const override { return name_; }
+
+    // 自身と子孫の所属シーンを設定.
+    void setSceneInHierarchy(Scene* s);
+
+    // コンポーネント追加時の登録.
+    template<typename T>
+    void onComponentAdded(T* component)
+    {
+        setComponentKind(component);
+        component->phaseMask_ = behaviourPhaseMask<T>();
+        component->physicsEventMask_ = component->isKindOf(ComponentKind_Behaviour) ? behaviourPhysicsEventMask<T>() : 0;
+        component->cloneFunc_ = cloneFuncOf<T>();
+        componentIndex.onAdded<T>(component, components);
+        addPhysicsListener(component);
+    }
+
+    // T を複製する関数。コピーできない型は nullptr で、Prefabは取り込むときに警告して外す
+    template<typename T>
+    static constexpr Component::CloneFunc cloneFuncOf()
+    {
+        if constexpr (std::is_copy_constructible_v<T> && !std::is_abstract_v<T>)
+        {
+            return &GameObject::cloneComponent<T>;
+        }
+        else
+        {
+            return nullptr;
+        }
+    }
+
+    // source を T としてコピーして target に追加する（Prefabの複製用）
+    // 種類と実装フェーズはコピー元から引き継ぐので、判定し直さない
+    template<typename T>
+    static Component* cloneComponent(const Component& source, GameObject& target)
+    {
+        auto comp = std::unique_ptr<T>(new T(static_cast<const T&>(source)));
+        comp->gameObject = &target;
+        T* ptr = comp.get();
+        target.components.push_back(std::move(comp));
+        target.componentIndex.onAdded<T>(ptr, target.components);
+        target.addPhysicsListener(ptr);
+        return ptr;
+    }
+    void setComponentKind(Component* component);
+
+    // 物理のコールバックの受け取り先への登録・削除
+    void addPhysicsListener(Component* component);
+    void removePhysicsListener(Component* component);
+
+    // event を実装しているBehaviourにだけ func(Behaviour*) を呼ぶ
+    template<typename Func>
+    void dispatchPhysicsEvent(PhysicsEvent event, Func&& func);
+
+    // 破棄待ちの処理（PlayerLoopがフレームの終わりに呼ぶ）
+    void destroyImmediate();
+    void removeComponent(Component* component);
+    void markDestroyedInHierarchy();
 
     friend void Destroy(GameObject*);
+    friend class Scene;
+    friend class GameObjectIndex;
+    friend class Transform;
+    friend class Prefab;
+    friend class PlayerLoop;
 };
 
 } // namespace UniDx
@@ -7,6 +7,18 @@
 namespace UniDx
 {
 
+// Componentのtransformプロパティ。GameObjectの定義が必要なのでここでインライン定義
+inline Transform* Component::getTransform() const
+{
+    return gameObject->transform;
+}
+
+template<typename... Rest>
+void GameObject::Add(std::unique_ptr<GameObject>&& first, Rest&&... rest)
+{
+    Transform::SetParent(std::move(first), transform);
+    Add(std::forward<Rest>(rest)...);
+}
 template<typename... ComponentPtrs>
 GameObject::GameObject(StringId name, Vector3 position, ComponentPtrs&&... components) : GameObject(name)
 {
@@ -22,11 +34,11 @@ GameObject::GameObject(const char8_t* name, Vector3 position, ComponentPtrs&&...
 template<typename Predicate>
 GameObject* GameObject::Find(Predicate pred) const
 {
-    for (auto& childPtr : transform->getChildGameObjects()) {
-        if (pred(childPtr.get()))
-            return childPtr.get();
+    for (GameObject* childPtr : transform->getChildGameObjects()) {
+        if (pred(childPtr))
+            return childPtr;
     }
-    for (auto& childPtr : transform->getChildGameObjects()) {
+    for (GameObject* childPtr : transform->getChildGameObjects()) {
         GameObject* p = childPtr->Find(pred);
         if (p != nullptr) return p;
     }
@@ -0,0 +1,206 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/**
+ * @file HeadlessPlatform.h
+ * @brief Windows 以外でヘッドレスに動かすときの、Direct3D 11 と Windows の型の代わり
+ * Platform.h からだけ読む。宣言だけを合わせてあり、GPUのリソースは作れない。
+ * 列挙の値は SDK と同じにしてあるので、記録したファイルやメッシュのデータはそのまま使える。
+ */
+
+// Windows の基本の型
+typedef unsigned int UINT;
+typedef uintptr_t WPARAM;
+typedef intptr_t LPARAM;
+struct HWND__;
+typedef HWND__* HWND;
+
+
+// --------------------
+// Direct3D 11 のインターフェイス
+// ヘッドレスでは作られないので、ComPtr が解放できるだけの形にしておく
+// --------------------
+struct IUnknown
+{
+    virtual unsigned long AddRef() = 0;
+    virtual unsigned long Release() = 0;
+
+protected:
+    ~IUnknown() = default;
+};
+
+struct ID3D11Device : IUnknown {};
+struct ID3D11DeviceContext : IUnknown {};
+struct ID3D11Buffer : IUnknown {};
+struct ID3D11Texture2D : IUnknown {};
+struct ID3D11ShaderResourceView : IUnknown {};
+struct ID3D11RenderTargetView : IUnknown {};
+struct ID3D11DepthStencilView : IUnknown {};
+struct ID3D11SamplerState : IUnknown {};
+struct ID3D11DepthStencilState : IUnknown {};
+struct ID3D11BlendState : IUnknown {};
+struct ID3D11RasterizerState : IUnknown {};
+struct ID3D11VertexShader : IUnknown {};
+struct ID3D11PixelShader : IUnknown {};
+struct ID3D11InputLayout : IUnknown {};
+struct ID3DBlob : IUnknown {};
+struct IDXGISwapChain : IUnknown {};
+
+
+// Direct3D 11 の列挙（値は SDK と同じ）
+enum DXGI_FORMAT
+{
+    DXGI_FORMAT_UNKNOWN = 0,
+    DXGI_FORMAT_R32G32B32A32_FLOAT = 2,
+    DXGI_FORMAT_R32G32B32_FLOAT = 6,
+    DXGI_FORMAT_R32G32_FLOAT = 16,
+    DXGI_FORMAT_R8G8B8A8_UNORM = 28,
+    DXGI_FORMAT_R8G8B8A8_UNORM_SRGB = 29,
+    DXGI_FORMAT_R8G8B8A8_UINT = 30,
+    DXGI_FORMAT_R32_UINT = 42,
+};
+
+enum D3D11_PRIMITIVE_TOPOLOGY
+{
+    D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED = 0,
+    D3D11_PRIMITIVE_TOPOLOGY_POINTLIST = 1,
+    D3D11_PRIMITIVE_TOPOLOGY_LINELIST = 2,
+    D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP = 3,
+    D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST = 4,
+    D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP = 5,
+};
+
+enum D3D11_INPUT_CLASSIFICATION
+{
+    D3D11_INPUT_PER_VERTEX_DATA = 0,
+    D3D11_INPUT_PER_INSTANCE_DATA = 1,
+};
+
+struct D3D11_INPUT_ELEMENT_DESC
+{
+    const char* SemanticName;
+    UINT SemanticIndex;
+    DXGI_FORMAT Format;
+    UINT InputSlot;
+    UINT AlignedByteOffset;
+    D3D11_INPUT_CLASSIFICATION InputSlotClass;
+    UINT InstanceDataStepRate;
+};
+
+enum D3D11_CULL_MODE
+{
+    D3D11_CULL_NONE = 1,
+    D3D11_CULL_FRONT = 2,
+    D3D11_CULL_BACK = 3,
+};
+
+enum D3D11_TEXTURE_ADDRESS_MODE
+{
+    D3D11_TEXTURE_ADDRESS_WRAP = 1,
+    D3D11_TEXTURE_ADDRESS_MIRROR = 2,
+    D3D11_TEXTURE_ADDRESS_CLAMP = 3,
+    D3D11_TEXTURE_ADDRESS_BORDER = 4,
+    D3D11_TEXTURE_ADDRESS_MIRROR_ONCE = 5,
+};
+
+enum D3D11_DEPTH_WRITE_MASK
+{
+    D3D11_DEPTH_WRITE_MASK_ZERO = 0,
+    D3D11_DEPTH_WRITE_MASK_ALL = 1,
+};
+
+enum D3D11_COMPARISON_FUNC
+{
+    D3D11_COMPARISON_NEVER = 1,
+    D3D11_COMPARISON_LESS = 2,
+    D3D11_COMPARISON_EQUAL = 3,
+    D3D11_COMPARISON_LESS_EQUAL = 4,
+    D3D11_COMPARISON_GREATER = 5,
+    D3D11_COMPARISON_NOT_EQUAL = 6,
+    D3D11_COMPARISON_GREATER_EQUAL = 7,
+    D3D11_COMPARISON_ALWAYS = 8,
+};
+
+
+namespace UniDx
+{
+
+// --------------------
+// ComPtrクラス
+// Microsoft::WRL::ComPtr のうち UniDx が使う部分だけ
+// --------------------
+template<typename T>
+class ComPtr
+{
+public:
+    ComPtr() noexcept = default;
+    ComPtr(std::nullptr_t) noexcept {}
+    ComPtr(const ComPtr& other) noexcept : ptr_(other.ptr_) { addRef(); }
+    ComPtr(ComPtr&& other) noexcept : ptr_(std::exchange(other.ptr_, nullptr)) {}
+    ~ComPtr() { Reset(); }
+
+    ComPtr& operator=(ComPtr other) noexcept { std::swap(ptr_, other.ptr_); return *this; }
+    ComPtr& operator=(std::nullptr_t) noexcept { Reset(); return *this; }
+
+    T* Get() const noexcept { return ptr_; }
+    T* operator->() const noexcept { return ptr_; }
+    T* const* GetAddressOf() const noexcept { return &ptr_; }
+    T** GetAddressOf() noexcept { return &ptr_; }
+    T** ReleaseAndGetAddressOf() noexcept { Reset(); return &ptr_; }
+
+    void Reset() noexcept
+    {
+        if (ptr_ != nullptr) std::exchange(ptr_, nullptr)->Release();
+    }
+
+    friend bool operator==(const ComPtr& a, std::nullptr_t) noexcept { return a.ptr_ == nullptr; }
+    friend bool operator==(const ComPtr& a, const ComPtr& b) noexcept { return a.ptr_ == b.ptr_; }
+
+private:
+    T* ptr_ = nullptr;
+
+    void addRef() noexcept { if (ptr_ != nullptr) ptr_->AddRef(); }
+};
+
+
+// --------------------
+// Keyboardクラス
+// DirectX::Keyboard と同じ形のキーの状態。ヘッドレスには読むキーボードがないので、
+// 入力は InputReplay で再生したものだけになる
+// --------------------
+class Keyboard
+{
+public:
+    // 値は仮想キーコード
+    enum Keys : unsigned char
+    {
+        None = 0,
+        Back = 0x8, Tab = 0x9, Enter = 0xd, Pause = 0x13, CapsLock = 0x14, Escape = 0x1b, Space = 0x20,
+        PageUp = 0x21, PageDown = 0x22, End = 0x23, Home = 0x24,
+        Left = 0x25, Up = 0x26, Right = 0x27, Down = 0x28,
+        PrintScreen = 0x2c, Insert = 0x2d, Delete = 0x2e,
+        D0 = 0x30, D1, D2, D3, D4, D5, D6, D7, D8, D9,
+        A = 0x41, B, C, D, E, F, G, H, I, J, K, L, M, N, O, P, Q, R, S, T, U, V, W, X, Y, Z,
+        NumPad0 = 0x60, NumPad1, NumPad2, NumPad3, NumPad4, NumPad5, NumPad6, NumPad7, NumPad8, NumPad9,
+        Multiply = 0x6a, Add = 0x6b, Separator = 0x6c, Subtract = 0x6d, Decimal = 0x6e, Divide = 0x6f,
+        F1 = 0x70, F2, F3, F4, F5, F6, F7, F8, F9, F10, F11, F12,
+        NumLock = 0x90, Scroll = 0x91,
+        LeftShift = 0xa0, RightShift = 0xa1, LeftControl = 0xa2, RightControl = 0xa3, LeftAlt = 0xa4, RightAlt = 0xa5,
+    };
+
+    // 256キー分のビット。DirectX::Keyboard::State と同じ並び
+    struct State
+    {
+        uint32_t bits[8];
+
+        bool IsKeyDown(Keys key) const noexcept { return (bits[key >> 5] & (1u << (key & 0x1f))) != 0; }
+        bool IsKeyUp(Keys key) const noexcept { return !IsKeyDown(key); }
+    };
+
+    State GetState() const { return State{}; }
+};
+
+}
@@ -3,7 +3,6 @@
 #include "UIBehaviour.h"
 
 #include <algorithm>
-#include <SpriteFont.h>
 #include <UniDx/Mesh.h>
 
 
@@ -19,14 +18,13 @@ class Image : public UIBehaviour
 public:
 	Image();
 	virtual void OnEnable() override;
-	virtual void render(const Matrix4x4& proj) const override;
+	virtual void buildPackets(RenderPacketBuilder& builder) const override;
 
 	std::shared_ptr<Texture> texture;
 	void SetColor(Color c) { std::fill(colors.begin(), colors.end(), c); }
 
 private:
-	ComPtr<ID3D11Buffer> constantBufferPerObject;
-	std::unique_ptr<SubMesh> mesh;
+	std::shared_ptr<SubMesh> mesh;	// 描画中のフレームも参照するので共有する
 	std::vector<Color> colors;
 };
 
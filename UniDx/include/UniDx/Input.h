@@ -1,14 +1,12 @@
 ﻿#pragma once
 
-#include <Keyboard.h>
 #include "UniDxDefine.h"
+#include "InputReplay.h"
 
 
 namespace UniDx
 {
 
-using DirectX::Keyboard;
-
 
 // Input情報
 class Input
@@ -23,6 +21,7 @@ public:
     {
         prevKeyState = nowKeyState;
         nowKeyState = keyboard->GetState();
+        InputReplay::onInputUpdate(nowKeyState); // 記録・再生
     }
 
     static bool GetKey(Keyboard::Keys key)
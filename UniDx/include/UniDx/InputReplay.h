@@ -0,0 +1,88 @@
+﻿#pragma once
+
+#include <vector>
+
+#include "UniDxDefine.h"
+
+
+namespace UniDx
+{
+
+// 計ったフレーム時間の統計（秒）
+struct FrameTimeStats
+{
+    size_t count = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+
+// --------------------
+// InputReplayクラス
+// フレームごとのキーの状態と経過時間をファイルに記録し、同じ順で Input と Time に流し直す
+// 乱数のシードと fixedDeltaTime もファイルに入れておき、再生の開始時に戻す
+// 記録・再生の開始後に既定のシードで作った Random も、同じシードから作った順に決まった列になる
+// 記録中・再生中はフレームの処理に実際にかかった時間を計っておき、ビルド同士の比較に使う
+//
+// 記録: InputReplay::StartRecording(); ... InputReplay::StopRecording(u8"play.inputrec");
+// 再生: InputReplay::StartReplay(u8"play.inputrec"); ... InputReplay::WriteFrameTimes(u8"frametimes.csv");
+//
+// ファイルの形式（リトルエンディアン）
+//   ヘッダ  : "UDXI", バージョン(u32), キー状態のバイト数(u32), 乱数のシード(u64), fixedDeltaTime(f32), フレーム数(u32)
+//   フレーム: 経過時間(f64), キーが変わったか(u8), 変わっていればキー状態
+// --------------------
+class InputReplay
+{
+public:
+    enum Mode
+    {
+        Mode_None,
+        Mode_Recording,
+        Mode_Replaying,
+    };
+
+    /** @brief 現在の状態 */
+    static Mode mode();
+
+    /** @brief 記録を始める。乱数のシードを決め直して Random::global() に設定する */
+    static void StartRecording();
+
+    /** @brief 記録を止めてファイルに書き出す */
+    static bool StopRecording(const u8string& filePath);
+
+    /** @brief ファイルを読み込んで再生を始める。MainLoop()/StepFrames() の前に呼ぶ */
+    static bool StartReplay(const u8string& filePath);
+
+    /** @brief 再生を途中で止める。以降は実際のキーボードを読む */
+    static void StopReplay();
+
+    /** @brief 再生が最後のフレームまで進んだか */
+    static bool isReplayFinished();
+
+    /** @brief 再生したファイルのフレーム数 */
+    static size_t replayFrameCount();
+
+    /** @brief true なら再生が終わったときに MainLoop() を抜ける */
+    static inline bool quitWhenFinished = true;
+
+    /** @brief 記録中・再生中に計った実際のフレーム時間（秒） */
+    static const std::vector<double>& measuredFrameTimes();
+
+    /** @brief measuredFrameTimes() の統計 */
+    static FrameTimeStats frameTimeStats();
+
+    /** @brief measuredFrameTimes() を1行1フレームのCSVで書き出す */
+    static bool WriteFrameTimes(const u8string& filePath);
+
+    // Input::update() から呼ぶ。記録中なら保存し、再生中なら記録した状態に差し替える
+    static void onInputUpdate(Keyboard::State& state);
+
+    // PlayerLoop のフレームの終わりに呼ぶ。deltaTime はクロックから読んだ経過時間、frameTime は処理にかかった時間
+    // Time に渡す経過時間を返す
+    static double onFrameEnd(double deltaTime, double frameTime);
+};
+
+} // namespace UniDx
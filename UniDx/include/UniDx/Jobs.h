@@ -0,0 +1,154 @@
+﻿#pragma once
+
+#include <atomic>
+#include <array>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "UniDxDefine.h"
+#include "Singleton.h"
+
+/**
+ * @file Jobs.h
+ * @brief ワークスティーリング方式のジョブシステム
+ *
+ * スレッドごとにChase-Levデックを持ち、自分のデックが空になったら他のスレッドから盗む。
+ * メインスレッドも0番のワーカーとして扱い、wait() の間は他のジョブを手伝って実行する。
+ *
+ * auto a = Jobs::getInstance()->schedule([]{ ... });
+ * auto b = Jobs::getInstance()->parallelFor(count, 64, [](size_t begin, size_t end){ ... }, { a });
+ * Jobs::getInstance()->wait(b);
+ */
+namespace UniDx
+{
+
+// ジョブのハンドル
+// 世代番号が一致している間だけ有効で、完了するとスロットの世代が進む
+struct JobHandle
+{
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != UINT32_MAX; }
+};
+
+
+// --------------------
+// Jobsクラス
+// --------------------
+class Jobs : public Singleton<Jobs>
+{
+public:
+    typedef std::function<void()> Func;
+    typedef std::function<void(size_t begin, size_t end)> RangeFunc;
+
+    static constexpr uint32_t MaxJobs = 4096;       // 同時に存在できるジョブ数
+    static constexpr size_t QueueCapacity = 4096;   // スレッドごとのデックの容量（2のべき乗）
+
+    Jobs();
+    virtual ~Jobs();
+
+    /** @brief ワーカースレッドの数（メインスレッドを除く） */
+    size_t workerCount() const { return threads_.size(); }
+
+    /**
+     * @brief ジョブを登録する。dependsOn がすべて完了してから実行される
+     * プールが空かずに確保できないときは、依存先を待ってその場で実行し、完了済みのハンドルを返す
+     */
+    JobHandle schedule(Func func, std::span<const JobHandle> dependsOn = {});
+    JobHandle schedule(Func func, std::initializer_list<JobHandle> dependsOn)
+    {
+        return schedule(std::move(func), std::span<const JobHandle>(dependsOn.begin(), dependsOn.size()));
+    }
+
+    /**
+     * @brief [0, count) を batchSize ずつに分けて並列に実行する
+     * 返すハンドルはすべてのバッチが終わったときに完了する
+     */
+    JobHandle parallelFor(size_t count, size_t batchSize, RangeFunc func, std::span<const JobHandle> dependsOn = {});
+    JobHandle parallelFor(size_t count, size_t batchSize, RangeFunc func, std::initializer_list<JobHandle> dependsOn)
+    {
+        return parallelFor(count, batchSize, std::move(func), std::span<const JobHandle>(dependsOn.begin(), dependsOn.size()));
+    }
+
+    /** @brief 完了したか（無効なハンドルは完了扱い） */
+    bool isCompleted(JobHandle handle) const;
+
+    /** @brief 完了するまで待つ。待っている間は他のジョブを実行する */
+    void wait(JobHandle handle);
+
+    /** @brief 現在のスレッドのワーカー番号。メインスレッドは 0、ワーカー以外は -1 */
+    static int currentWorkerIndex();
+
+    /**
+     * @brief ジョブシステムがあれば並列に、なければその場で [0, count) を実行して待つ
+     * エンジン内部の並列化で使う
+     */
+    static void parallelForAndWait(size_t count, size_t batchSize, const RangeFunc& func);
+
+private:
+    struct Job
+    {
+        Func func;
+        std::atomic<int32_t> unfinished{ 0 };       // 自身 + 未完了の子
+        std::atomic<int32_t> dependencies{ 0 };     // 未完了の依存先 + 登録中のガード
+        std::atomic<uint32_t> generation{ 0 };
+        uint32_t parent = UINT32_MAX;
+
+        // 完了後に実行可能になるジョブ
+        std::atomic_flag lock;
+        bool finished = false;
+        std::vector<uint32_t> continuations;
+    };
+
+    // Chase-Levのワークスティーリングデック
+    // push/pop は所有スレッドだけ、steal はどのスレッドからでも呼べる
+    class WorkQueue
+    {
+    public:
+        bool push(Job* job);
+        Job* pop();
+        Job* steal();
+
+    private:
+        std::atomic<int64_t> top_{ 0 };
+        std::atomic<int64_t> bottom_{ 0 };
+        std::array<std::atomic<Job*>, QueueCapacity> buffer_{};
+    };
+
+    std::vector<std::thread> threads_;
+    std::vector<unique_ptr<WorkQueue>> queues_;     // 0 はメインスレッド
+
+    // ワーカー以外のスレッドから登録されたジョブ
+    std::mutex injectMutex_;
+    std::vector<Job*> injected_;
+    std::atomic<size_t> injectedCount_{ 0 };
+
+    // ジョブのプール
+    unique_ptr<Job[]> jobs_;
+    std::mutex freeMutex_;
+    std::vector<uint32_t> freeList_;
+
+    std::atomic<uint32_t> wakeCounter_{ 0 };
+    std::atomic<bool> quit_{ false };
+
+    Job* allocate(Func& func);
+    void release(Job* job);
+    uint32_t indexOf(const Job* job) const { return uint32_t(job - jobs_.get()); }
+    Job* jobAt(JobHandle handle) const;
+
+    void addDependencies(Job* job, std::span<const JobHandle> dependsOn);
+    bool submit(Job* job);
+    void enqueue(Job* job);
+    void wake(size_t count);
+    Job* findJob();
+    void execute(Job* job);
+    void finish(Job* job);
+    void workerMain(int index);
+};
+
+}
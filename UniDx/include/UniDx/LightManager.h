@@ -44,25 +44,25 @@ public:
     bool registerLight(Light* light);
     void unregisterLight(Light* light);
 
-    // ライト情報を定数バッファに反映
-    virtual void updateLightCBuffer();
-    virtual void updateLightCBufferObject(Vector3 objPos, int lightCountMax = PointLightCountMax + SpotLightCountMax);
+    // フレーム共通のライト情報の定数バッファの中身を作る
+    virtual void makeLightsPerFrame(ConstantBufferLightPerFrame& cb);
+
+    // objPos に影響の大きいライトを選んで、オブジェクトごとのライト情報の定数バッファの中身を作る
+    virtual void makeLightsPerObject(ConstantBufferLightPerObject& cb, Vector3 objPos, int lightCountMax = PointLightCountMax + SpotLightCountMax);
 
 private:
     std::vector<Light*> lights_;
     size_t              capacity_ = 0;
 
     std::vector<GPULight> gpuLights_;
-    Microsoft::WRL::ComPtr<ID3D11Buffer>           lightBuf_;
-    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>lightSRV_;
-//    Microsoft::WRL::ComPtr<ID3D11Buffer>           metaCB_;
+    ComPtr<ID3D11Buffer>           lightBuf_;
+    ComPtr<ID3D11ShaderResourceView>lightSRV_;
+//    ComPtr<ID3D11Buffer>           metaCB_;
 
     std::vector<PointLightBuffer> pointLights;
     std::vector<SpotLightBuffer> spotLights;
     std::vector<float> pointLightIntensity;
     std::vector<float> spotLightIntensity;
-    ComPtr<ID3D11Buffer> constantBufferLightPerFrame;  // フレームごとにGPUで共通利用する定数バッファ
-    ComPtr<ID3D11Buffer> constantBufferLightPerObject; // オブジェクトごとにGPUで共通利用する定数バッファ
 };
 
 }
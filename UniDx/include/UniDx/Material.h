@@ -12,7 +12,6 @@ namespace UniDx {
 
 class Camera;
 class Texture;
-enum RenderingMode;
 
 
 // Unity のシェーダーグラフに合わせたブレンドモード
@@ -30,12 +29,25 @@ enum BlendMode
 // --------------------
 class Material : public Object
 {
+    // プロパティのアクセサ
+    Texture* getMainTexture() const { return textures.size() > 0 ? textures.front().get() : nullptr; }
+
 public:
     typedef std::vector<uint8_t> Value;
 
+    // 描画スレッドに渡すGPUのステート
+    // ゲーム側で作り直しても、渡した参照で描画中のものは生きている
+    struct GpuState
+    {
+        ComPtr<ID3D11Buffer> constantBuffer;
+        ComPtr<ID3D11DepthStencilState> depthStencilState;
+        ComPtr<ID3D11BlendState> blendState;
+        ComPtr<ID3D11RasterizerState> rasterizerState;
+    };
+
     std::shared_ptr<Shader> shader;
     Color color;
-    ReadOnlyProperty<Texture*> mainTexture;
+    ReadOnlyMemberProperty<&Material::getMainTexture> mainTexture{ this };
     D3D11_DEPTH_WRITE_MASK depthWrite;
     D3D11_COMPARISON_FUNC ztest;
     D3D11_CULL_MODE cullMode;
@@ -66,8 +78,14 @@ public:
     void SetVector(StringId name, Vector2 v) { SetVector(name, Vector4(v, 0.0f, 0.0f)); }
     void SetMatrix(StringId name, const Matrix4x4& m) { SetBytes(name, &m, sizeof(Matrix4x4)); }
 
-    // マテリアル情報設定。Render()内で呼び出す
-    virtual bool bind();
+    /**
+     * @brief 描画パケット用に定数を確定させる。ゲームスレッドで呼ぶ
+     * @return 前回から変わっていれば定数バッファの中身、変わっていなければ空
+     */
+    std::span<const uint8_t> prepareConstants();
+
+    // 描画パケット用のGPUのステート
+    GpuState gpuState() const { return GpuState{ constantBufferPerMaterial, depthStencilState, blendState, rasterizerState }; }
 
     // テクスチャの取得
     std::span<std::shared_ptr<Texture>> getTextures() { return textures; }
@@ -94,6 +112,8 @@ protected:
     std::vector<uint8_t> cbStaging; // GPUへ転送するマテリアル変数
     bool dirty = true;
 
+    virtual StringId getName() const override { return shader->name; }
+
     void createConstantBuffer();
 
 };
@@ -4,8 +4,7 @@
 #include <span>
 #include <vector>
 
-#include <d3d11.h>
-
+#include "Platform.h"
 #include "Object.h"
 #include "Property.h"
 #include "Shader.h"
@@ -244,7 +243,7 @@ class Mesh : public Object
 public:
     std::vector< std::shared_ptr<SubMesh> > submesh;
 
-    Mesh() : Object([this]() {return name_;}) {}
+    Mesh() {}
     virtual ~Mesh() {}
 
     void render() const
@@ -255,10 +254,10 @@ public:
         }
     }
 
-    void render(std::span<const std::shared_ptr<Material> > materials) const;
-    
 protected:
     StringId name_;
+
+    virtual StringId getName() const override { return name_; }
 };
 
 
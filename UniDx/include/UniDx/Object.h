@@ -12,12 +12,25 @@ namespace UniDx {
 // --------------------
 class Object
 {
+protected:
+    // nameプロパティのgetter。派生クラスで実装する
+    virtual StringId getName() const = 0;
+
 public:
     virtual ~Object() {}
 
-    ReadOnlyProperty<StringId> name;
+    ReadOnlyMemberProperty<&Object::getName> name{ this };
+
+    Object() {}
+
+    // コピーしてもプロパティはコピー先自身を指したままにする
+    Object(const Object&) {}
+    Object& operator=(const Object&) { return *this; }
 
-    Object(ReadOnlyProperty<StringId>::Getter nameGet) : name(nameGet) {}
+    // シーンの構築中（SceneArena::Scope の間）はシーンのアリーナから確保する
+    // 16バイトを超えるアラインメントの派生クラスは作らないこと
+    static void* operator new(size_t size);
+    static void operator delete(void* p, size_t size);
 };
 
 } // namespace UniDx
@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "Behaviour.h"
+
+
+namespace UniDx
+{
+
+// --------------------
+// ObjectPoolクラス
+// 同じ構成のGameObjectをあらかじめ作っておき、生成・破棄の代わりに使い回す
+// インスタンスはこのコンポーネントを持つGameObjectの子になる
+// 戻されたインスタンスは休眠し、実行リストと物理計算からは外れるが、
+// コンポーネント、メッシュ、物理ワールドへの登録はそのまま残るので取り出しが軽い
+// --------------------
+class ObjectPool : public Behaviour
+{
+public:
+    typedef std::function<unique_ptr<GameObject>()> Factory;
+
+    // インスタンスを作る関数。毎回同じ構成の階層を返すこと
+    Factory factory;
+
+    ObjectPool() = default;
+    explicit ObjectPool(Factory f) : factory(std::move(f)) {}
+    ObjectPool(const ObjectPool&) = delete;    // インスタンスは複製しない
+
+    /** @brief 休眠中のインスタンスが count 個以上になるまで作っておく */
+    void Prewarm(size_t count);
+
+    /** @brief 休眠中のインスタンスを取り出して配置する。足りなければ新しく作る */
+    GameObject* Spawn(Vector3 position, Quaternion rotation = Quaternion::identity);
+
+    /** @brief インスタンスをプールに戻す */
+    void Despawn(GameObject* instance);
+
+    /** @brief instance がプールのインスタンスなら戻し、そうでなければ Destroy() する */
+    static void Release(GameObject* instance);
+
+    size_t countAll() const { return instanceCount_; }
+    size_t countActive() const { return instanceCount_ - free_.size(); }
+    size_t countInactive() const { return free_.size(); }
+
+private:
+    std::vector<GameObject*> free_;     // 休眠中のインスタンス
+    size_t instanceCount_ = 0;
+
+    GameObject* create();
+    static void setDormantInHierarchy(GameObject* object, bool dormant);
+};
+
+}
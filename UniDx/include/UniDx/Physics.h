@@ -3,11 +3,12 @@
 #include <vector>
 #include <array>
 #include <map>
+#include <span>
 
 #include "Property.h"
-#include "Singleton.h"
 #include "Bounds.h"
 #include "Collision.h"
+#include "Component.h"
 
 namespace UniDx
 {
@@ -88,6 +89,16 @@ namespace UniDx
     };
 
 
+    // ステップ中に集めたコールバック1件
+    // トリガーのときは collision.collider だけが相手を指す
+    struct PhysicsEventRecord
+    {
+        PhysicsEvent type;
+        Collider* collider;     // 受け取る側
+        Collision collision;
+    };
+
+
     // --------------------
     // PhysicsShape
     // --------------------
@@ -103,9 +114,10 @@ namespace UniDx
         bool isValid() const { return collider_ != nullptr; }
         void setInvalid() { collider_ = nullptr; }
         void initOtherNew() { triggersNew_.clear(); collisionsNew_.clear(); }
+        void clearContacts() { triggers_.clear(); collisions_.clear(); }
         void addCollide(const Collision& col) { collisionsNew_.push_back(col); }
         void addTrigger(Collider* other) { triggersNew_.push_back(other); }
-        void collideCallback();
+        void collectEvents(std::vector<PhysicsEventRecord>& events);
 
     private:
         Collider* collider_;
@@ -119,24 +131,45 @@ namespace UniDx
 
     // --------------------
     // Physics
+    // シーンごとに１つ持つ物理ワールド。
+    // ワールド同士は状態を共有しないので、別スレッドで同時にステップできる
     // --------------------
-    class Physics : public Singleton<Physics>
+    class Physics
     {
     public:
         typedef std::pair<PhysicsShape*, PhysicsShape*> PotentialPair;
 
-        static inline float gravity = -9.81f;
+        // 新しく作るワールドの重力の初期値
+        static inline float defaultGravity = -9.81f;
+
+        // このワールドの重力
+        float gravity = defaultGravity;
 
         Physics();
+        ~Physics();
 
         void simulate(float setp);
+
+        /** @brief ステップを進め、その間に集めたコールバックをまとめて呼ぶ */
         void simulatePositionCorrection(float step);
 
+        /**
+         * @brief 複数のワールドをジョブシステムで並列にステップする
+         * コールバックはすべてのワールドのステップが終わってから、呼び出したスレッドでワールド順に呼ぶ
+         */
+        static void simulateWorlds(std::span<Physics* const> worlds, float step);
+
+        /** @brief GameObjectが属するシーンの物理ワールドを取得。シーンに属していなければ nullptr */
+        static Physics* of(const GameObject* gameObject);
+
         void registerRigidbody(Rigidbody* rigidbody);
         void unregisterRigidbody(Rigidbody* rigidbody);
         void register3d(Collider* collider);
         void unregister3d(Collider* collider);
 
+        /** @brief 登録しているコライダーの休眠状態が変わったときに呼ぶ。次のステップで並べ直す */
+        void onDormancyChanged() { shapeOrderDirty = true; gridValid = false; }
+
         /**
          * @brief origin, direction, maxDistance, filter (デフォルト nullptr => 全て含める)
          * @return コライダーにヒットしたとき true
@@ -144,19 +177,46 @@ namespace UniDx
         bool Raycast(Vector3 origin, Vector3 direction, float maxDistance,
             RaycastHit* hitInfo = nullptr, std::function<bool(const Collider*)> filter = nullptr);
 
+        /**
+         * @brief 半径 radius の球を origin から direction に maxDistance 動かしたときに最初に当たるコライダー
+         * 候補は前回のステップで作ったブロードフェーズのグリッドで絞り込む（Unity の autoSyncTransforms = false と同じく、
+         * ステップの後に Transform だけを動かしたコライダーは次のステップまで元の位置で探す）
+         * @return コライダーにヒットしたとき true
+         */
+        bool SphereCast(Vector3 origin, float radius, Vector3 direction, float maxDistance,
+            RaycastHit* hitInfo = nullptr, std::function<bool(const Collider*)> filter = nullptr);
+
+        /**
+         * @brief 球と重なっているコライダーを results に追加する
+         * 候補の絞り込みは SphereCast() と同じ
+         * @return 追加した数
+         */
+        size_t OverlapSphere(Vector3 center, float radius, std::vector<Collider*>& results,
+            std::function<bool(const Collider*)> filter = nullptr);
+
         void checkBounds(PhysicsShape* shape1, PhysicsShape* shape2);
 
     private:
         std::vector<PotentialPair> potentialPairs;
         std::vector<PotentialPair> potentialPairsTrigger;
+        std::vector<uint8_t> triggerHits;   // 並列に判定したトリガーペアの結果
 
         std::vector<ContactManifold> manifolds;
+        std::vector<PhysicsEventRecord> events;   // ステップ中に集めたコールバック
 
         std::map<Rigidbody*, PhysicsActor> physicsActors;
-        std::vector<PhysicsShape> physicsShapes;
+        std::vector<PhysicsShape> physicsShapes;     // 休眠中のものは後ろに寄せる
+        size_t activeShapeCount = 0;                // 計算に使う先頭からの数
+        bool shapeOrderDirty = false;
         std::unique_ptr<PhysicsGrid> physicsGrid;
+        bool gridValid = false;     // physicsGrid が physicsShapes の今の並びを指しているか
 
+        std::span<PhysicsShape> activeShapes() { return { physicsShapes.data(), activeShapeCount }; }
         void initializeSimulate(float step);
+        void simulateStep(float step);
+        void dispatchEvents();
+        template<typename Func>
+        void forEachShapeNear(const Bounds& bounds, Func&& func);
         void solveVelocityConstraint(Rigidbody* A, Rigidbody* B, const ContactManifold& m);
         void solvePositionConstraint(Rigidbody* A, Rigidbody* B, const ContactManifold& m);
     };
@@ -0,0 +1,32 @@
+﻿#pragma once
+
+/**
+ * @file Platform.h
+ * @brief Direct3D 11 と Windows の入力を読み込む唯一のヘッダー
+ * Windows では SDK と DirectXTK のヘッダーを読み、UNIDX_D3D11 を 1 にする。
+ * それ以外（Linux のシミュレーションサーバーやテスト）では HeadlessPlatform.h で型だけを用意し、UNIDX_D3D11 を 0 にする。
+ * このときGPUのリソースは作らず、PlayerLoop は InitializeHeadless() でだけ動く。
+ * Direct3D を呼ぶ処理は #if UNIDX_D3D11 の中に書く。
+ */
+
+#if defined(_WIN32)
+
+#define UNIDX_D3D11 1
+
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <Keyboard.h>
+
+namespace UniDx
+{
+using Microsoft::WRL::ComPtr;
+using DirectX::Keyboard;
+}
+
+#else
+
+#define UNIDX_D3D11 0
+
+#include "HeadlessPlatform.h"
+
+#endif
@@ -1,9 +1,15 @@
 ﻿#pragma once
 
-#include <windows.h>
-#include <Keyboard.h>
+#include <array>
+#include <vector>
 
 #include "Singleton.h"
+#include "Component.h"
+#include "Jobs.h"
+#include "Coroutine.h"
+#include "FrameLimiter.h"
+#include "RenderBackend.h"
+#include "RenderThread.h"
 
 namespace UniDx
 {
@@ -12,14 +18,93 @@ class GameObject;
 class Camera;
 class Canvas;
 
+
+// --------------------
+// UpdateListクラス
+// 1つのフェーズを実装しているコンポーネントだけを並べた実行リスト
+// 削除は墓標(nullptr)を置くだけのO(1)で、次に巡回する前に詰め直す
+// 巡回中に無効にして有効に戻したものは末尾に入り直すが、同じ巡回で2回は呼ばない
+// --------------------
+class UpdateList
+{
+public:
+    explicit UpdateList(UpdatePhase phase) : phase_(phase) {}
+
+    void add(Component* component, int order);
+    void remove(Component* component);
+
+    /** @brief 実行順に f(Component*) を呼ぶ。巡回中の追加・削除は可 */
+    template<typename F>
+    void forEach(F&& f)
+    {
+        compact();
+        ++pass_;
+        visitedRemoved_.clear();
+        for (cursor_ = 0; cursor_ < entries_.size(); ++cursor_)
+        {
+            const Entry& e = entries_[cursor_];
+            if (e.component != nullptr && e.skipPass != pass_) f(e.component);
+        }
+        cursor_ = NotIterating;
+    }
+
+    /**
+     * @brief batchSize ずつに分けてワーカースレッドで f(Component*, 実行順の番号) を呼ぶ
+     * 巡回中の追加・削除は不可（CommandBufferで後回しにすること）
+     */
+    template<typename F>
+    void parallelForEach(size_t batchSize, F&& f)
+    {
+        compact();
+        Jobs::parallelForAndWait(entries_.size(), batchSize, [this, &f](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (Component* c = entries_[i].component) f(c, i);
+            }
+        });
+    }
+
+    size_t size() const { return entries_.size() - removedCount_; }
+
+private:
+    struct Entry
+    {
+        Component* component;
+        int order;
+        uint32_t skipPass;      // この番号の巡回では呼ばない（その巡回で呼び済み）
+    };
+
+    static constexpr size_t NotIterating = SIZE_MAX;
+
+    UpdatePhase phase_;
+    std::vector<Entry> entries_;
+    size_t removedCount_ = 0;
+    bool unsorted_ = false;
+
+    uint32_t pass_ = 0;                         // forEach() の巡回の番号
+    size_t cursor_ = NotIterating;              // 巡回中の位置
+    std::vector<Component*> visitedRemoved_;    // この巡回で呼んだあとに外されたもの
+
+    // 墓標を取り除いて実行順に並べ直す
+    void compact();
+};
+
+
 /**
  * @file PlayerLoop.h
  * @brief フレームワーク全体のループ処理を行うクラス。
- * Unityでは実行リストが作られるが、簡略化のため、全てのGameObjectとComponentを巡回して実行する。
+ * Behaviourは有効になったときに、実装しているフェーズの実行リストに登録される。
+ * 各フェーズは階層を巡回せず、登録されたコンポーネントだけを実行順に呼ぶ。
+ * parallelUpdate を宣言したBehaviourの Update() は、通常の Update() の前にワーカースレッドで並列に呼ぶ。
+ * コルーチンは Update() の後と、固定時間更新の物理計算の後に再開する。
+ * 描画はフレームの終わりに描画パケットとして組み立て、描画スレッドに渡す。
+ * 描画スレッドが前のフレームを描いている間に、ゲームスレッドは次のフレームを更新する。
+ * ウィンドウを持つ Initialize() と MainLoop() は Direct3D のある環境（UNIDX_D3D11）だけで使える。
  */
 class PlayerLoop : public Singleton<PlayerLoop>
 {
 public:
+#if UNIDX_D3D11
     /**
      * @brief プレイヤーループの初期化。
      * @param CreateWindowW()で生成するウィンドウハンドル
@@ -29,17 +114,70 @@ public:
     /** @brief ゲーム全体のメインループ */
     virtual int MainLoop();
 
+    /** @brief MainLoop() を回し、抜けたらプレイヤーループを破棄する。アプリのエントリポイントから呼ぶ */
+    static int Run();
+#endif
+
+    /**
+     * @brief ウィンドウとDirect3Dデバイスを作らずに初期化する（シミュレーションサーバーや自動計測用）
+     * MainLoop() の代わりに StepFrames() で必要なだけフレームを進め、最後に Shutdown() を呼ぶ
+     * 描画は行わず、テクスチャ・シェーダー・フォントは読み込まない
+     */
+    virtual void InitializeHeadless();
+
+    /**
+     * @brief ヘッドレスで frames フレーム進める。最初の呼び出しでシーンを作る
+     * 進む時間は Time のクロックに従う。FixedStepClock なら仮想の時計、実時間なら待たずに上限なしで回る
+     */
+    void StepFrames(int frames);
+
+    /** @brief ヘッドレスの終了処理 */
+    void Shutdown();
+
+    /** @brief ヘッドレスで動いているか */
+    bool isHeadless() const { return headless_; }
+
+    /** @brief true なら描画を別スレッドで行う。Initialize() か SetRenderBackend() の前に設定する */
+    bool multithreadedRendering = true;
+
+    /**
+     * @brief 描画パケットを受け取るバックエンドを差し替える
+     * Initialize() では D3DRenderBackend を使う。ヘッドレスでは設定しなければパケットを作らない
+     */
+    void SetRenderBackend(std::unique_ptr<RenderBackend> backend);
+
+    /** @brief MainLoop() のフレームの間隔を揃える。設定は FrameLimiter の静的メンバーで行う */
+    const FrameLimiter& frameLimiter() const { return frameLimiter_; }
+
+#if UNIDX_D3D11
     void ProcessKeyboardMessage(UINT message, WPARAM wParam, LPARAM lParam)
     {
-        DirectX::Keyboard::ProcessMessage(message, wParam, lParam);
+        Keyboard::ProcessMessage(message, wParam, lParam);
     }
+#endif
 
     void registerCanvas(Canvas* c);
     void unregisterCanvas(Canvas* c);
 
+    /** @brief 有効になったコンポーネントを実行リストに登録 */
+    void registerComponent(Component* c);
+
+    /** @brief 無効になったコンポーネントを実行リストから外す */
+    void unregisterComponent(Component* c);
+
+    /** @brief Destroy() されたGameObjectをフレームの終わりの削除待ちに積む */
+    void enqueueDestroy(GameObject* object) { destroyQueue_.push_back(object); }
+
+    /** @brief Destroy() されたコンポーネントをフレームの終わりの削除待ちに積む */
+    void enqueueDestroy(Component* component) { destroyComponentQueue_.push_back(component); }
+
+    /** @brief Behaviourのコルーチンを再開するスケジューラ */
+    CoroutineScheduler& coroutineScheduler() { return coroutines_; }
+
 protected:
     virtual void fixedUpdate();
     virtual void physics();
+    virtual void updateTransforms();
     virtual void input();
     virtual void update();
     virtual void lateUpdate();
@@ -48,16 +186,41 @@ protected:
     virtual void finalize();
 
     void awake(GameObject* object);
-    void fixedUpdate(GameObject* object);
-    void checkStart(GameObject* object);
-    void update(GameObject* object);
-    void lateUpdate(GameObject* object);
-    void render(GameObject* object, const Camera& camera);
+
+    // フェーズの実行リスト
+    UpdateList& updateList(UpdatePhase phase) { return updateLists_[phase]; }
 
 private:
     std::vector<Canvas*> canvas_;
+    CoroutineScheduler coroutines_;
+    std::vector<GameObject*> destroyQueue_;
+    std::vector<Component*> destroyComponentQueue_;
+    double restFixedUpdateTime_ = 0.0;  // まだ固定時間更新に回していない時間
+#if UNIDX_D3D11
+    HWND hWnd_ = nullptr;
+#endif
+    FrameLimiter frameLimiter_;
+    std::unique_ptr<RenderBackend> renderBackend_;
+    RenderThread renderThread_;
+    std::array<RenderFrame, 2> renderFrames_;   // 描画スレッドが読んでいない方に次のフレームを積む
+    size_t renderFrameIndex_ = 0;
+    bool headless_ = false;
+    bool sceneCreated_ = false;
+    std::array<UpdateList, UpdatePhase_Count> updateLists_{
+        UpdateList(UpdatePhase_Start),
+        UpdateList(UpdatePhase_FixedUpdate),
+        UpdateList(UpdatePhase_Update),
+        UpdateList(UpdatePhase_ParallelUpdate),
+        UpdateList(UpdatePhase_LateUpdate),
+        UpdateList(UpdatePhase_Render)
+    };
 
     void createScene();
+    void runFrame();
+    void endFrame(double frameTime);
+#if UNIDX_D3D11
+    bool isFocused() const;
+#endif
 };
 
 }
\ No newline at end of file
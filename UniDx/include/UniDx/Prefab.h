@@ -0,0 +1,64 @@
+﻿#pragma once
+
+#include <span>
+#include <vector>
+
+#include "GameObject.h"
+#include "Transform.h"
+
+
+namespace UniDx
+{
+
+// --------------------
+// Prefabクラス
+// GameObjectの階層をテンプレートとして取り込み、Instantiate() で複製する
+// 階層は親が先に来る順に平らな配列にしておき、複製はそれを先頭から1回なめるだけ
+// メッシュ・マテリアル・シェーダーは shared_ptr のまま共有するので、読み込みやコンパイルは起きない
+// コピーできないコンポーネント（GltfModelのような読み込み用のものや SkinnedMeshRenderer）は複製しない
+// --------------------
+class Prefab
+{
+public:
+    /** @brief シーンに入れる前の階層を所有してテンプレートにする */
+    explicit Prefab(unique_ptr<GameObject> source);
+
+    /** @brief 既存の階層を複製してテンプレートにする */
+    explicit Prefab(const GameObject& source);
+
+    Prefab(const Prefab&) = delete;
+    Prefab& operator=(const Prefab&) = delete;
+
+    /** @brief 複製を作る。ルートの位置と向きだけ置き換え、スケールはテンプレートのまま */
+    unique_ptr<GameObject> Instantiate(Vector3 position, Quaternion rotation = Quaternion::identity) const;
+
+    /** @brief テンプレートの階層 */
+    const GameObject* source() const { return source_.get(); }
+
+    size_t nodeCount() const { return nodes_.size(); }
+
+private:
+    struct Node
+    {
+        const GameObject* source;
+        int parent;                 // nodes_ 内の親の位置（ルートは -1）
+        uint32_t firstComponent;    // components_ 内の範囲
+        uint32_t componentCount;
+    };
+
+    unique_ptr<GameObject> source_;
+    std::vector<Node> nodes_;
+    std::vector<const Component*> components_;  // Transformと複製できないものは除く
+
+    void capture(const GameObject& root);
+    unique_ptr<GameObject> clone(Vector3 position, Quaternion rotation) const;
+};
+
+
+/**
+ * @brief prefab の複製を parent の子として作る
+ * parent がすでにAwakeしていれば（シーンが動いていれば）、複製もその場でAwakeする
+ */
+GameObject* Instantiate(const Prefab& prefab, Vector3 position, Quaternion rotation, Transform* parent);
+
+}
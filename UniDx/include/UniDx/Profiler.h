@@ -0,0 +1,127 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "UniDxDefine.h"
+#include "Object.h"
+
+// 0 にするとマーカーをコードに埋め込まない
+#ifndef UNIDX_PROFILER
+#define UNIDX_PROFILER 1
+#endif
+
+
+namespace UniDx
+{
+
+// --------------------
+// Profilerクラス
+// 区間の開始・終了時刻をスレッドごとのリングバッファに記録し、Chromeの trace_event 形式で書き出す
+// 記録するのは BeginCapture() から EndCapture() の間だけで、それ以外のマーカーはフラグを1つ読むだけ
+// 入れ子になった区間は同じスレッドの時刻の包含関係から階層として表示される
+//
+// void Foo() { UNIDX_PROFILE_SCOPE("Game/Foo"); ... }
+//
+// Profiler::BeginCapture(); ... Profiler::EndCapture(); Profiler::WriteChromeTrace(u8"trace.json");
+// 書き出したファイルは chrome://tracing や Perfetto で開く
+// --------------------
+class Profiler
+{
+public:
+    static constexpr size_t EventsPerThread = 64 * 1024;   // あふれたら古いものから上書きする
+
+    struct Event
+    {
+        const char* name;       // 文字列リテラルか、インターン済みの StringId の文字列（寿命がプログラムと同じもの）
+        const char* category;
+        int64_t begin;          // キャプチャ開始からのナノ秒
+        int64_t end;
+    };
+
+    /** @brief 記録中か */
+    static bool isCapturing() { return capturing_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 記録を始める。前回の記録は捨てる
+     * ジョブが動いていない、フレームの区切りでメインスレッドから呼ぶこと
+     */
+    static void BeginCapture();
+
+    /** @brief 記録を止める */
+    static void EndCapture();
+
+    /** @brief 記録した区間を trace_event 形式のJSONで書き出す。EndCapture() の後に呼ぶ */
+    static bool WriteChromeTrace(const u8string& filePath);
+
+    /** @brief キャプチャ開始からのナノ秒 */
+    static int64_t now();
+
+    /** @brief 区間を1つ、呼び出したスレッドのバッファに記録する */
+    static void record(const char* name, const char* category, int64_t begin, int64_t end);
+
+private:
+    static inline std::atomic<bool> capturing_ = false;
+};
+
+
+// --------------------
+// ProfileScopeクラス
+// 作ってから破棄されるまでを1つの区間として記録する
+// 記録中でなければ時刻も取らない
+// --------------------
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name, const char* category = "UniDx")
+    {
+        if (Profiler::isCapturing())
+        {
+            name_ = name;
+            category_ = category;
+            begin_ = Profiler::now();
+        }
+    }
+
+    // Behaviourのコールバックなど、オブジェクトの名前で記録する区間
+    ProfileScope(const Object* object, const char* category)
+    {
+        if (Profiler::isCapturing())
+        {
+            const char* name = object->name.get().c_str();
+            name_ = name != nullptr ? name : "(no name)";
+            category_ = category;
+            begin_ = Profiler::now();
+        }
+    }
+
+    ~ProfileScope()
+    {
+        if (name_ != nullptr) Profiler::record(name_, category_, begin_, Profiler::now());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name_ = nullptr;
+    const char* category_ = nullptr;
+    int64_t begin_ = 0;
+};
+
+} // namespace UniDx
+
+
+#define UNIDX_PROFILE_CONCAT_(a, b) a##b
+#define UNIDX_PROFILE_CONCAT(a, b) UNIDX_PROFILE_CONCAT_(a, b)
+
+#if UNIDX_PROFILER
+/** @brief スコープの終わりまでを name の区間として記録する */
+#define UNIDX_PROFILE_SCOPE(name) ::UniDx::ProfileScope UNIDX_PROFILE_CONCAT(unidxProfileScope_, __COUNTER__)(name)
+
+/** @brief スコープの終わりまでを object の名前の区間として記録する。category にはコールバック名などを渡す */
+#define UNIDX_PROFILE_OBJECT_SCOPE(object, category) ::UniDx::ProfileScope UNIDX_PROFILE_CONCAT(unidxProfileScope_, __COUNTER__)(object, category)
+#else
+#define UNIDX_PROFILE_SCOPE(name) ((void)0)
+#define UNIDX_PROFILE_OBJECT_SCOPE(object, category) ((void)0)
+#endif
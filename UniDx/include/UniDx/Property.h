@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include <functional>
+#include <type_traits>
 #include "UniDxDefine.h"
 
 /**
@@ -9,6 +10,8 @@
  * @brief C#のプロパティライクな記述を実現するクラス
  * ReadOnlyProperty<>
  * Property<>
+ * ReadOnlyMemberProperty<>
+ * MemberProperty<>
  * メンバアクセス(.演算)が使えないなどの制約がある
  */
 namespace UniDx
@@ -100,4 +103,96 @@ template<typename T>
 inline u8string ToString(const Property<T>& v) { return ToString(v.get()); }
 
 
+namespace detail
+{
+// メンバ関数ポインタからクラスと値の型を取り出す
+template<typename F> struct MemberGetterTraits;
+template<typename C, typename R>
+struct MemberGetterTraits<R (C::*)() const> { using Owner = C; using Value = std::remove_cvref_t<R>; };
+template<typename C, typename R>
+struct MemberGetterTraits<R (C::*)() const noexcept> { using Owner = C; using Value = std::remove_cvref_t<R>; };
+}
+
+
+/**
+ * @brief 読み取り専用プロパティ（メンバ関数版）
+ * getterをテンプレート引数で持つので、保持するのは所有者のポインタだけ
+ * std::function を経由しないので呼び出しがインライン展開される
+ *
+ * class Foo {
+ *     int getValue() const { return value_; }
+ * public:
+ *     ReadOnlyMemberProperty<&Foo::getValue> value{ this };
+ * };
+ */
+template<auto Getter>
+class ReadOnlyMemberProperty
+{
+public:
+    using Owner = typename detail::MemberGetterTraits<decltype(Getter)>::Owner;
+    using value_type = typename detail::MemberGetterTraits<decltype(Getter)>::Value;
+
+    explicit ReadOnlyMemberProperty(Owner* owner) : owner_(owner) {}
+
+    // 所有者を指しているのでコピーはできない
+    ReadOnlyMemberProperty(const ReadOnlyMemberProperty&) = delete;
+    ReadOnlyMemberProperty& operator=(const ReadOnlyMemberProperty&) = delete;
+
+    /** @brief 値の取得*/
+    value_type get() const { return (owner_->*Getter)(); }
+
+    /** @brief 値の変換*/
+    operator value_type() const { return get(); }
+
+    /** @brief メンバアクセス（ポインタ型のみ）*/
+    value_type operator->() const requires std::is_pointer_v<value_type> { return get(); }
+
+    /** @brief 比較演算*/
+    template<typename U>
+    bool operator==(const U& rhs) const { return get() == rhs; }
+
+    /** @brief 三方比較演算*/
+    template<typename U>
+    auto operator<=>(const U& rhs) const { return get() <=> rhs; }
+
+protected:
+    Owner* owner_;
+};
+
+
+/**
+ * @brief 読み書きプロパティ（メンバ関数版）
+ *
+ * class Foo {
+ *     int getValue() const { return value_; }
+ *     void setValue(const int& v) { value_ = v; }
+ * public:
+ *     MemberProperty<&Foo::getValue, &Foo::setValue> value{ this };
+ * };
+ */
+template<auto Getter, auto Setter>
+class MemberProperty : public ReadOnlyMemberProperty<Getter>
+{
+public:
+    using Owner = typename ReadOnlyMemberProperty<Getter>::Owner;
+    using value_type = typename ReadOnlyMemberProperty<Getter>::value_type;
+
+    explicit MemberProperty(Owner* owner) : ReadOnlyMemberProperty<Getter>(owner) {}
+
+    /** @brief 値の設定*/
+    void set(const value_type& value) { (this->owner_->*Setter)(value); }
+
+    /** @brief C#風代入アクセス*/
+    MemberProperty& operator=(const value_type& value) { set(value); return *this; }
+
+    /** @brief 別のプロパティからの代入は値のコピー*/
+    MemberProperty& operator=(const MemberProperty& rhs) { set(rhs.get()); return *this; }
+};
+
+template<auto Getter>
+inline u8string ToString(const ReadOnlyMemberProperty<Getter>& v) { return ToString(v.get()); }
+template<auto Getter, auto Setter>
+inline u8string ToString(const MemberProperty<Getter, Setter>& v) { return ToString(v.get()); }
+
+
 }
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <atomic>
 #include <chrono>
 #include "UniDxDefine.h"
 
@@ -18,11 +19,32 @@ public:
         return inst;
     }
 
-    explicit Random(uint64_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count())
+    explicit Random(uint64_t seed = defaultSeed())
     {
         InitState(seed);
     }
 
+    // 既定のシード。通常は時刻から、決まった列に切り替えていればその次の値
+    static uint64_t defaultSeed()
+    {
+        if (deterministic_.load(std::memory_order_relaxed))
+        {
+            // 連番のままだとXorShiftの初期状態が似るので、SplitMix64でかき混ぜる
+            uint64_t z = nextSeed_.fetch_add(0x9E3779B97F4A7C15ull, std::memory_order_relaxed);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+        return std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    }
+
+    // 既定のシードを seed から決まった列で配るようにする（Determinism から呼ぶ）
+    static void setDefaultSeedSequence(bool enabled, uint64_t seed = 0)
+    {
+        nextSeed_.store(seed, std::memory_order_relaxed);
+        deterministic_.store(enabled, std::memory_order_relaxed);
+    }
+
     // シード設定 (Unity互換: InitState)
     void InitState(uint64_t seed)
     {
@@ -141,6 +163,9 @@ public:
 private:
     uint64_t state = 88172645463325252ull; // デフォルトシード
 
+    static inline std::atomic<bool> deterministic_ = false;
+    static inline std::atomic<uint64_t> nextSeed_ = 0;
+
     // 64bit XorShift
     uint64_t nextUInt64()
     {
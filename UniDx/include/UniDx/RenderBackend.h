@@ -0,0 +1,106 @@
+﻿#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "RenderPacket.h"
+
+/// \cond DOXYGEN_IGNORE
+namespace DirectX
+{
+    inline namespace DX11
+    {
+        class SpriteBatch;
+    }
+}
+/// \endcond
+
+
+namespace UniDx
+{
+
+// --------------------
+// RenderBackend基底クラス
+// RenderFrame の描画パケットを受け取って描画する
+// render() は描画スレッドから呼ばれる。ゲームスレッドのオブジェクトはパケットを通してだけ読むこと
+// --------------------
+class RenderBackend
+{
+public:
+    virtual ~RenderBackend() = default;
+
+    /** @brief 1フレーム分を描画して表示する */
+    virtual void render(const RenderFrame& frame) = 0;
+};
+
+
+#if UNIDX_D3D11
+// --------------------
+// D3DRenderBackendクラス
+// Direct3D 11 のイミディエイトコンテキストで描画する
+// 定数バッファはバックエンドが種類ごとに1つずつ持ち、描画のたびに書き換える
+// テキスト用の SpriteBatch もバックエンドが持ち、描画スレッドで作る
+// --------------------
+class D3DRenderBackend : public RenderBackend
+{
+public:
+    D3DRenderBackend();
+    virtual ~D3DRenderBackend() override;
+
+    virtual void render(const RenderFrame& frame) override;
+
+private:
+    ComPtr<ID3D11Buffer> constantBufferPerCamera;
+    ComPtr<ID3D11Buffer> constantBufferPerObject;
+    ComPtr<ID3D11Buffer> constantBufferSkinPerObject;
+    ComPtr<ID3D11Buffer> constantBufferLightPerFrame;
+    ComPtr<ID3D11Buffer> constantBufferLightPerObject;
+    std::unique_ptr<ConstantBufferSkinPerObject> skinStaging;
+    std::unique_ptr<DirectX::SpriteBatch> spriteBatch;
+
+    void bindMaterial(const RenderFrame& frame, const MaterialPacket& material);
+    void bindObject(const RenderFrame& frame, const ObjectPacket& object);
+    void drawText(const TextPacket& text);
+};
+#endif
+
+
+// --------------------
+// RecordingRenderBackendクラス
+// 描画せずに、受け取ったパケットを記録する
+// ヘッドレスで PlayerLoop::SetRenderBackend() に渡し、パケットの組み立てを確かめるのに使う
+// --------------------
+class RecordingRenderBackend : public RenderBackend
+{
+public:
+    // 記録したフレーム。ポインタはそのフレームの間だけ有効なので、番号と値だけを残す
+    struct Draw
+    {
+        DrawPacket::Kind kind;
+        RenderPass pass;
+        const SubMesh* mesh;    // 比べるためだけに使う
+        const Material* material;
+        Matrix4x4 world;
+        uint32_t boneCount;
+        uint32_t pointLightCount;
+        uint32_t spotLightCount;
+    };
+
+    struct Frame
+    {
+        bool hasCamera;
+        ConstantBufferPerCamera camera;
+        std::vector<Draw> draws;
+        size_t materialCount;
+    };
+
+    virtual void render(const RenderFrame& frame) override;
+
+    const std::vector<Frame>& frames() const { return frames_; }
+    void clear() { frames_.clear(); }
+
+private:
+    std::vector<Frame> frames_;
+};
+
+} // namespace UniDx
@@ -0,0 +1,169 @@
+﻿#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "UniDxDefine.h"
+#include "ConstantBuffer.h"
+#include "Material.h"
+
+namespace UniDx
+{
+
+class Camera;
+class Font;
+class LightManager;
+class Shader;
+struct SubMesh;
+
+
+// 描画パス。不透明と半透明は RenderingMode と同じ値
+enum RenderPass : uint8_t
+{
+    RenderPass_Opaque = RenderingMode_Opaque,
+    RenderPass_Transparent = RenderingMode_Transparent,
+    RenderPass_UI,
+};
+
+
+// フレームで使うマテリアル1つ分
+// 定数はゲームスレッドで値を確定させてコピーしておくので、描画中にゲーム側で書き換えてもよい
+struct MaterialPacket
+{
+    const Material* material;
+    const Shader* shader;
+    Material::GpuState state;
+    uint32_t textures;          // RenderFrame::textures の範囲
+    uint32_t textureCount;
+    uint32_t constants;         // RenderFrame::bytes の範囲
+    uint32_t constantsSize;
+};
+
+
+// 描画するオブジェクト1つ分の姿勢
+struct ObjectPacket
+{
+    Matrix4x4 world;
+    uint32_t bones;             // RenderFrame::bones の範囲（スキンのみ）
+    uint32_t boneCount;
+    bool skinned;               // スキン用の定数バッファのレイアウトで送る
+};
+
+
+// テキスト1つ分。SpriteBatch はバックエンドが描画スレッドで作って持つ
+struct TextPacket
+{
+    const Font* font;
+    std::wstring text;
+    Vector2 position;
+    Vector2 scale;
+    Color color;
+};
+
+
+// 描画1回分。番号はすべて RenderFrame の中の配列の番号
+struct DrawPacket
+{
+    enum Kind : uint8_t
+    {
+        Kind_Mesh,
+        Kind_Text,
+    };
+
+    Kind kind;
+    RenderPass pass;
+    uint32_t material;          // None なら直前のマテリアルのまま
+    uint32_t object;
+    uint32_t lightSet;          // None なら直前のライトのまま
+    uint32_t text;
+    const SubMesh* mesh;
+};
+
+
+// --------------------
+// RenderFrame構造体
+// 1フレーム分の描画パケット。ゲームスレッドが作り、描画スレッドが読む
+// 配列は使い回すので、毎フレーム確保し直すことはない
+// --------------------
+struct RenderFrame
+{
+    static constexpr uint32_t None = UINT32_MAX;
+
+    bool hasCamera = false;
+    ConstantBufferPerCamera camera{};
+    ConstantBufferLightPerFrame lights{};
+
+    std::vector<DrawPacket> draws;
+    std::vector<MaterialPacket> materials;
+    std::vector<ObjectPacket> objects;
+    std::vector<ConstantBufferLightPerObject> lightSets;
+    std::vector<TextPacket> texts;
+    std::vector<const Texture*> textures;
+    std::vector<BoneMat3x4> bones;
+    std::vector<uint8_t> bytes;
+
+    // 描画が終わるまで生かしておくもの（差し替えられたマテリアルやメッシュ）
+    std::vector<std::shared_ptr<const void>> retained;
+
+    // 登録済みのマテリアルの番号（パケットを積む間だけ使う）
+    std::unordered_map<const Material*, uint32_t> materialIndex;
+
+    void clear();
+};
+
+
+// --------------------
+// RenderPacketBuilderクラス
+// シーンを巡回して RenderFrame に描画パケットを積む。D3D の呼び出しはしない
+// 同じマテリアルは1フレームに1回だけ登録し、以降は番号で参照する
+// --------------------
+class RenderPacketBuilder
+{
+public:
+    static constexpr uint32_t None = RenderFrame::None;
+
+    /** @brief frame を空にして積み始める */
+    explicit RenderPacketBuilder(RenderFrame& frame);
+
+    RenderFrame& frame() { return frame_; }
+
+    /** @brief カメラと時間の定数を確定させる */
+    void setCamera(const Camera& camera);
+
+    /** @brief フレーム共通のライトを確定させる */
+    void setLights(LightManager& lights);
+
+    /** @brief 以降に積むパケットの描画パス */
+    void beginPass(RenderPass pass) { pass_ = pass; }
+    RenderPass pass() const { return pass_; }
+
+    /** @brief マテリアルを登録して番号を返す。keep を渡すと描画が終わるまで保持する */
+    uint32_t addMaterial(Material& material, std::shared_ptr<const Material> keep = nullptr);
+
+    /** @brief オブジェクトの姿勢を登録して番号を返す */
+    uint32_t addObject(const Matrix4x4& world);
+
+    /** @brief スキンのオブジェクトを登録して番号を返す。ボーン行列は bones() に書き込む */
+    uint32_t addSkinnedObject(const Matrix4x4& world, uint32_t boneCount);
+    std::span<BoneMat3x4> bones(uint32_t object);
+
+    /** @brief position に近いライトを lightCount 個まで選んで登録し、番号を返す */
+    uint32_t addLightSet(Vector3 position, int lightCount);
+
+    /** @brief メッシュの描画を積む */
+    void addMesh(const SubMesh& mesh, uint32_t object, uint32_t material, uint32_t lightSet);
+    void addMesh(const std::shared_ptr<SubMesh>& mesh, uint32_t object, uint32_t material, uint32_t lightSet);
+
+    /** @brief テキストの描画を積む */
+    void addText(const std::shared_ptr<Font>& font, std::wstring text, Vector2 position, Vector2 scale, Color color);
+
+private:
+    RenderFrame& frame_;
+    RenderPass pass_ = RenderPass_Opaque;
+    LightManager* lights_ = nullptr;
+};
+
+} // namespace UniDx
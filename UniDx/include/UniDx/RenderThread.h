@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "UniDxDefine.h"
+
+
+namespace UniDx
+{
+
+class RenderBackend;
+struct RenderFrame;
+
+
+// --------------------
+// RenderThreadクラス
+// ゲームスレッドが作った RenderFrame を受け取り、別のスレッドでバックエンドに描画させる
+// 描画中のフレームは1つだけ。submit() は前のフレームの描画が終わるのを待ってから渡す
+// そのためゲームスレッドは RenderFrame を2つ交互に使えば、描画中のものに触れずに次を作れる
+//
+// threaded を false にして始めると、submit() の中でそのまま描画する（デバッグや計測用）
+// --------------------
+class RenderThread
+{
+public:
+    RenderThread() = default;
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /** @brief backend で描画を始める */
+    void start(RenderBackend* backend, bool threaded);
+
+    /** @brief 描画中のフレームを待ってからスレッドを止める */
+    void stop();
+
+    /** @brief 前のフレームの描画が終わるのを待ってから frame を渡す。frame は次に submit() するまで触らないこと */
+    void submit(const RenderFrame& frame);
+
+    /** @brief 渡したフレームの描画が終わるまで待つ。描画が参照しているオブジェクトを消す前に呼ぶ */
+    void waitIdle();
+
+    bool isRunning() const { return backend_ != nullptr; }
+    bool isThreaded() const { return thread_.joinable(); }
+
+private:
+    RenderBackend* backend_ = nullptr;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    const RenderFrame* pending_ = nullptr;  // 渡されて、まだ描画が終わっていないフレーム
+    bool quit_ = false;
+
+    void threadMain();
+};
+
+} // namespace UniDx
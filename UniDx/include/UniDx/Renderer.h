@@ -15,6 +15,7 @@ namespace UniDx {
 
 class Camera;
 class Material;
+class RenderPacketBuilder;
 
 
 /**
@@ -27,7 +28,8 @@ public:
     std::vector< std::shared_ptr<Material> > materials;
     int lightCount = 0;
 
-    virtual void render(const Camera& camera) {}
+    /** @brief builder.pass() で描くものを描画パケットとして積む。ゲームスレッドで呼ばれる */
+    virtual void buildPackets(RenderPacketBuilder& builder) {}
 
     /** @brief マテリアルを追加（共有） */
     void AddMaterial(std::shared_ptr<Material> material)
@@ -59,12 +61,7 @@ public:
     }
 
 protected:
-    ComPtr<ID3D11Buffer> constantBufferPerObject;
-
     virtual void OnEnable() override;
-    virtual void createConstantBufferPerObject();
-    virtual void bindPerObject();
-    virtual void bindLightPerObject();
 };
 
 /** @brief メッシュ用のレンダラーコンポーネント */
@@ -75,8 +72,12 @@ public:
 
     MeshRenderer();
 
-    // メッシュを使って描画
-    virtual void render(const Camera& camera) override;
+    // メッシュを使って描画パケットを積む
+    virtual void buildPackets(RenderPacketBuilder& builder) override;
+
+protected:
+    // 現在の姿勢を登録して番号を返す
+    virtual uint32_t addObjectPacket(RenderPacketBuilder& builder);
 };
 
 
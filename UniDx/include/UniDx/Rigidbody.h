@@ -16,12 +16,18 @@ namespace UniDx {
 // --------------------
 class Rigidbody : public Component
 {
+    // プロパティのアクセサ
+    Vector3 getPosition() const { return position_; }
+    void setPosition(const Vector3& v) { position_ = v; move_ = Vector3::zero; hasMovePos_ = true; }
+    Quaternion getRotation() const { return rotation_; }
+    void setRotation(const Quaternion& q) { rotation_ = q; hasMoveRot_ = true; }
+
 public:
     // 位置。値を直接設定するとテレポートする。
-    Property<Vector3> position;
+    MemberProperty<&Rigidbody::getPosition, &Rigidbody::setPosition> position{ this };
 
     // 向き
-    Property<Quaternion> rotation;
+    MemberProperty<&Rigidbody::getRotation, &Rigidbody::setRotation> rotation{ this };
 
     // 速度
     Vector3 linearVelocity{ 0, 0, 0 };
@@ -34,15 +40,17 @@ public:
 
     bool isKinematic = false;
 
-    Rigidbody() :
-        position(
-            [this]() { return position_; },
-            [this](Vector3 v) { position_ = v; move_ = Vector3::zero; hasMovePos_ = true; }
-        ),
-        rotation(
-            [this]() { return rotation_; },
-            [this](Quaternion q) { rotation_ = q; hasMoveRot_ = true; }
-        )
+    Rigidbody() = default;
+
+    // 複製用。物理ワールドへの登録は OnEnable() でやり直す
+    Rigidbody(const Rigidbody& other) :
+        Component(other),
+        linearVelocity(other.linearVelocity),
+        gravityScale(other.gravityScale),
+        mass(other.mass),
+        isKinematic(other.isKinematic),
+        position_(other.position_),
+        rotation_(other.rotation_)
     {
     }
 
@@ -55,12 +63,13 @@ public:
 
     virtual void OnEnable() override
     {
-        Physics::getInstance()->registerRigidbody(this);
+        world_ = Physics::of(gameObject);
+        if (world_ != nullptr) world_->registerRigidbody(this);
     }
 
     virtual void OnDisable() override
     {
-        Physics::getInstance()->unregisterRigidbody(this);
+        if (world_ != nullptr) world_->unregisterRigidbody(this);
     }
 
     // 指定位置に移動。補間が有効な場合は間の衝突判定を行う。
@@ -90,7 +99,7 @@ public:
         // 重力適用
         if (gravityScale != 0.0f)
         {
-            linearVelocity.y += Physics::gravity * gravityScale * Time::fixedDeltaTime;
+            linearVelocity.y += world_->gravity * gravityScale * Time::fixedDeltaTime;
         }
 
         // 位置の直接指定がなければ、移動ベクトルに速度を入れる
@@ -125,7 +134,35 @@ public:
         transform->rotation = rotation_;
     }
 
+protected:
+    // 休眠中は物理ワールドに登録したまま計算から外れる
+    // 起きるときはTransformの位置から動き直す
+    virtual void setDormant(bool value) override
+    {
+        if (value == isDormant()) return;
+        Component::setDormant(value);
+        if (!value)
+        {
+            position_ = transform->position;
+            rotation_ = transform->rotation;
+            linearVelocity = Vector3::zero;
+            move_ = Vector3::zero;
+            hasMovePos_ = false;
+            hasMoveRot_ = false;
+        }
+    }
+
+    // 別のシーンへ移ったら、そのシーンの物理ワールドへ登録し直す
+    virtual void onSceneChanged() override
+    {
+        if (!enabled) return;
+        if (world_ != nullptr) world_->unregisterRigidbody(this);
+        world_ = Physics::of(gameObject);
+        if (world_ != nullptr) world_->registerRigidbody(this);
+    }
+
 private:
+    Physics* world_ = nullptr;
     Vector3 position_;
     Quaternion rotation_;
     Vector3 move_{ 0, 0, 0 };
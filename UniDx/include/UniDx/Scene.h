@@ -1,43 +1,107 @@
 ﻿#pragma once
 
 #include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
 
 #include "UniDxDefine.h"
 #include "Singleton.h"
+#include "StringId.h"
 
 namespace UniDx
 {
 
 class GameObject;
+class Physics;
+class TransformHierarchy;
+
+
+// --------------------
+// GameObjectIndexクラス
+// StringId → GameObject の索引。StringIdは同一性で比較できるので、ハッシュはポインタだけ
+// GameObjectが自分の位置を覚えておき、外すときは末尾と入れ替えて O(1)
+// --------------------
+class GameObjectIndex
+{
+public:
+    enum Key { Key_Name, Key_Tag };
+
+    explicit GameObjectIndex(Key key) : key_(key) {}
+
+    void add(StringId key, GameObject* object);
+    void remove(StringId key, GameObject* object);
+
+    /** @brief key を持つGameObject（追加順、外すと順番は入れ替わる） */
+    std::span<GameObject* const> find(StringId key) const;
+
+private:
+    // GameObjectに覚えさせている位置
+    uint32_t& slotOf(GameObject* object) const;
+
+    Key key_;
+    std::unordered_map<StringId, std::vector<GameObject*>> buckets_;
+};
 
 // シーン
+// シーンごとに物理ワールドを持つ
 class Scene
 {
 public:
     typedef std::vector<unique_ptr<GameObject>> GameObjectContainer;
 
-    Scene() {}
+    Scene();
+    ~Scene();
 
     // 可変長引数でunique_ptr<GameObject>を受け取るコンストラクタ
     template<typename... GameObjectPtrs>
-    Scene(GameObjectPtrs&&... objs) {
+    Scene(GameObjectPtrs&&... objs) : Scene() {
         AddGameObjects(std::forward<GameObjectPtrs>(objs)...);
     }
 
     const GameObjectContainer& GetRootGameObjects() { return routeGameObjects; }
 
+    // このシーンの物理ワールド
+    Physics* GetPhysicsScene() const { return physics.get(); }
+
+    // このシーンのTransformを深さ順に並べた配列
+    TransformHierarchy* GetTransformHierarchy() const { return transformHierarchy.get(); }
+
+    /** @brief 名前が一致するGameObjectを1つ返す（なければ nullptr） */
+    GameObject* FindByName(StringId name) const;
+
+    /** @brief タグが一致するGameObjectを1つ返す（なければ nullptr） */
+    GameObject* FindWithTag(StringId tag) const;
+
+    /** @brief タグが一致するGameObjectをすべて返す。Destroy() されてフレームの終わりを待っているものは除く */
+    std::vector<GameObject*> FindGameObjectsWithTag(StringId tag) const;
+
 protected:
+    // GameObjectより後に破棄されるよう先に宣言する
+    unique_ptr<Physics> physics;
+    unique_ptr<TransformHierarchy> transformHierarchy;
+    GameObjectIndex nameIndex;
+    GameObjectIndex tagIndex;
     GameObjectContainer routeGameObjects;
 
+    // ルートにGameObjectを追加
+    void addRootGameObject(unique_ptr<GameObject> obj);
+
+    // ルートからGameObjectを取り外して所有権を返す
+    unique_ptr<GameObject> removeRootGameObject(GameObject* obj);
+
     // ヘルパー関数でパック展開
     void AddGameObjects() {}
 
     template<typename First, typename... Rest>
     void AddGameObjects(First&& first, Rest&&... rest)
     {
-        routeGameObjects.push_back(std::move(first));
+        addRootGameObject(std::move(first));
         AddGameObjects(std::forward<Rest>(rest)...);
     }
+
+    friend class GameObject;
+    friend class Transform;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+#include "UniDxDefine.h"
+
+
+namespace UniDx
+{
+
+// --------------------
+// SceneArenaクラス
+// シーンの構築中に作るGameObjectやComponentを1つの領域から先頭から順に確保する
+// 実行中に伸び縮みする配列は置かない（単調な領域なので、伸ばすたびに前の領域が無駄になる）
+// 個別の解放では何もせず、シーンを破棄したあとに領域をまとめて返す
+// シーンより長く生き残ったオブジェクトがあれば、最後の1つが解放されるまで領域を残す
+// 確保はメインスレッドからだけ行うこと（Scopeはスレッドごと）
+// --------------------
+class SceneArena : public std::pmr::memory_resource
+{
+public:
+    static constexpr size_t DefaultInitialSize = 1024 * 1024;
+
+    /** @brief アリーナを作る。所有者は使い終わったら delete ではなく release() を呼ぶ */
+    static SceneArena* create(size_t initialSize = DefaultInitialSize);
+
+    /** @brief 所有者が手放す。生き残りがいなければすぐに、いればその解放時に領域を返す */
+    void release();
+
+    /** @brief このスレッドで確保に使っているアリーナ（なければ nullptr） */
+    static SceneArena* current();
+
+    /** @brief current() があればそれを、なければ通常のヒープを返す */
+    static std::pmr::memory_resource* currentResource();
+
+    /** @brief 生きている確保の数 */
+    size_t liveCount() const { return refCount_.load(std::memory_order_relaxed) - (released_ ? 0 : 1); }
+
+    // --------------------
+    // 生存期間の間、このスレッドの確保先をアリーナにする
+    // --------------------
+    class Scope
+    {
+    public:
+        explicit Scope(SceneArena* arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        SceneArena* previous_;
+    };
+
+protected:
+    virtual void* do_allocate(size_t bytes, size_t alignment) override;
+    virtual void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    explicit SceneArena(size_t initialSize);
+    virtual ~SceneArena() = default;
+
+    std::pmr::monotonic_buffer_resource buffer_;
+    std::atomic<size_t> refCount_{ 1 };     // 生きている確保の数 + 所有者の分
+    bool released_ = false;
+
+    void unref();
+};
+
+} // namespace UniDx
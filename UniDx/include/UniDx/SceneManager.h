@@ -5,6 +5,7 @@
 #include "Singleton.h"
 #include "Scene.h"
 #include "Material.h"
+#include "SceneArena.h"
 
 
 std::unique_ptr<UniDx::Scene> CreateDefaultScene();
@@ -26,8 +27,12 @@ public:
 
     Scene* GetActiveScene() { return activeScene.get(); }
 
+    /** @brief アクティブなシーンの構築に使うアリーナ */
+    SceneArena* GetSceneArena() { return sceneArena; }
+
 protected:
     std::unique_ptr<Scene> activeScene;
+    SceneArena* sceneArena = nullptr;
 };
 
 }
\ No newline at end of file
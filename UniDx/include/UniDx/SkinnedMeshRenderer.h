@@ -70,10 +70,7 @@ public:
     SkinnedMeshRenderer();
 
 protected:
-    virtual void createConstantBufferPerObject() override;
-    virtual void bindPerObject() override;
-
-    unique_ptr<ConstantBufferSkinPerObject> constantBuffer;
+    virtual uint32_t addObjectPacket(RenderPacketBuilder& builder) override;
 };
 
 
@@ -2,9 +2,12 @@
 
 #include <string_view>
 #include <string>
-#include <unordered_set>
+#include <array>
+#include <atomic>
+#include <algorithm>
 #include <memory_resource>
 #include <mutex>
+#include <vector>
 #include <functional>
 
 #include "UniDxDefine.h"
@@ -47,9 +50,17 @@ private:
 inline u8string ToString(StringId s) { return u8string(s); }
 
 
+/**
+ * @brief StringIdの実体を持つプール
+ * ハッシュの上位ビットで分けたシャードごとに、オープンアドレスの表を持つ
+ * 検索はロックを取らずに表を読み、見つからなかったときだけシャードのロックを取って追加する
+ * 表を広げるときは新しい表を作って差し替え、古い表は読み途中のスレッドのためにプールが消えるまで残す
+ */
 class InternPool
 {
 public:
+    static constexpr size_t ShardCount = 16;
+
     /** @brief インスタンスの取得*/
     static InternPool& instance()
     {
@@ -57,57 +68,76 @@ public:
         return pool;
     }
 
-    InternPool()
-        : arena_(std::pmr::get_default_resource())
-        , strings_(&arena_)
-    {
-    }
-
-    StringId intern(std::u8string_view sv)
-    {
-        if(sv.empty()) return StringId();
+    InternPool();
+    ~InternPool();
 
-        std::lock_guard lock(mtx_);
+    InternPool(const InternPool&) = delete;
+    InternPool& operator=(const InternPool&) = delete;
 
-        auto it = strings_.find(sv); // 透明検索で string_view のまま探す
-        if(it != strings_.end()) return StringId(reinterpret_cast<const char8_t*>(it->c_str()), it->size());
+    StringId intern(std::u8string_view sv);
 
-        // 新規に arena に確保して登録
-        auto result = strings_.emplace(sv); // pmr::u8string(sv) が作られる
-        return StringId(reinterpret_cast<const char8_t*>(result.first->c_str()), result.first->size());
-    }
+    void Log() const;
 
-    void Log() const
+private:
+    // 文字列の実体（NULL終端まで続けて確保する）
+    struct Entry
     {
-        for(auto& str : strings_)
-        {
-            Debug::Log(str.c_str());
-        }
-    }
+        size_t hash;
+        size_t size;
+        char8_t* data() { return reinterpret_cast<char8_t*>(this + 1); }
+        const char8_t* data() const { return reinterpret_cast<const char8_t*>(this + 1); }
+    };
 
-private:
-    // 透明検索用の Hash/Equal（std::u8string_view で find できるようにする）
-    struct TransparentHash {
-        using is_transparent = void;
-        size_t operator()(std::u8string_view v) const noexcept { return std::hash<std::u8string_view>{}(v); }
-        size_t operator()(const std::pmr::u8string& s) const noexcept { return std::hash<std::u8string_view>{}(std::u8string_view{ s }); }
+    struct Table
+    {
+        size_t capacity;    // 2のべき乗
+        std::atomic<const Entry*>* slots;
     };
-    struct TransparentEq {
-        using is_transparent = void;
-        bool operator()(std::u8string_view a, std::u8string_view b) const noexcept { return a == b; }
-        bool operator()(const std::pmr::u8string& a, std::u8string_view b) const noexcept { return a == b; }
-        bool operator()(std::u8string_view a, const std::pmr::u8string& b) const noexcept { return a == b; }
-        bool operator()(const std::pmr::u8string& a, const std::pmr::u8string& b) const noexcept { return a == b; }
+
+    struct Shard
+    {
+        std::atomic<Table*> table{ nullptr };
+        size_t count = 0;                           // 以下はロック中だけ触る
+        std::mutex mtx;
+        std::pmr::monotonic_buffer_resource arena;
+        std::vector<Table*> tables;                 // 古い表も含めてすべて
     };
 
-private:
-    std::mutex mtx_;
-    std::pmr::monotonic_buffer_resource arena_;
-    std::pmr::unordered_set<std::pmr::u8string, TransparentHash, TransparentEq> strings_;
+    std::array<Shard, ShardCount> shards_;
+
+    static const Entry* find(const Table* table, size_t hash, std::u8string_view sv);
+    static Table* createTable(size_t capacity);
+    static void insert(Table* table, const Entry* entry);
 };
 inline StringId StringId::intern(std::u8string_view sv) { return InternPool::instance().intern(sv); }
 
 
+// "baseColor"_sid 用の文字列リテラルを受け取る型
+template<typename CharT, size_t N>
+struct StringIdLiteral
+{
+    CharT value[N];
+
+    constexpr StringIdLiteral(const CharT(&s)[N]) { std::copy_n(s, N, value); }
+};
+
+inline namespace literals
+{
+
+/**
+ * @brief 文字列リテラルから StringId を作る。"baseColor"_sid
+ * 文字列ごとに関数が1つでき、インターンは最初の1回だけ行う
+ */
+template<StringIdLiteral S>
+StringId operator""_sid()
+{
+    static const StringId id = StringId::intern(std::u8string_view(reinterpret_cast<const char8_t*>(S.value), std::size(S.value) - 1));
+    return id;
+}
+
+}
+
+
 }
 
 namespace std
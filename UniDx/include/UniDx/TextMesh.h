@@ -2,8 +2,6 @@
 
 #include "UIBehaviour.h"
 
-#include <SpriteFont.h>
-
 
 namespace UniDx {
 
@@ -15,15 +13,11 @@ class Font;
 class TextMesh : public UIBehaviour
 {
 public:
-	virtual void Awake() override;
-	virtual void render(const Matrix4x4& proj) const;
+	virtual void buildPackets(RenderPacketBuilder& builder) const override;
 
 	u8string         text;
 	shared_ptr<Font> font;
 	Color            color = Color::white;
-
-private:
-	unique_ptr<DirectX::SpriteBatch> spriteBatch;
 };
 
 }
@@ -1,7 +1,11 @@
 ﻿#pragma once
 
 #include <memory>
+
+#include "Platform.h"
+#if UNIDX_D3D11
 #include <DirectXTex.h>
+#endif
 
 #include "Component.h"
 #include "Shader.h"
@@ -20,10 +24,9 @@ public:
     D3D11_TEXTURE_ADDRESS_MODE wrapModeU;
     D3D11_TEXTURE_ADDRESS_MODE wrapModeV;
 
-    Texture() : Object([this]() {return fileName; }),
+    Texture() :
         wrapModeU(D3D11_TEXTURE_ADDRESS_CLAMP),
-        wrapModeV(D3D11_TEXTURE_ADDRESS_CLAMP),
-        m_info()
+        wrapModeV(D3D11_TEXTURE_ADDRESS_CLAMP)
     {
     }
 
@@ -44,11 +47,15 @@ protected:
     ComPtr<ID3D11SamplerState> samplerState;
     StringId fileName;
 
+    virtual StringId getName() const override { return fileName; }
+
     // シェーダーリソースビュー(画像データ読み取りハンドル)
     ComPtr<ID3D11ShaderResourceView> m_srv = nullptr;
 
+#if UNIDX_D3D11
     // 画像情報
-    DirectX::TexMetadata m_info;
+    DirectX::TexMetadata m_info{};
+#endif
 
     void ensureSampler_();
 };
@@ -1,6 +1,9 @@
 ﻿#pragma once
 
+#include <memory>
+
 #include "Property.h"
+#include "Clock.h"
 
 namespace UniDx
 {
@@ -28,8 +31,18 @@ public:
         frameCount = 0;
         time = 0.0f;
         timeScale = 1.0f;
+        GetClock().reset();
     }
 
+    /** @brief フレームの経過時間を読むクロックを差し替える。nullptr なら実時間に戻す */
+    static void SetClock(std::unique_ptr<Clock> c)
+    {
+        clock_ = c != nullptr ? std::move(c) : std::make_unique<RealTimeClock>();
+        clock_->reset();
+    }
+
+    static Clock& GetClock() { return *clock_; }
+
     static void SetDeltaTimeFixed()
     {
         unscaledDeltaTime = fixedDeltaTime;
@@ -50,6 +63,7 @@ public:
 
 private:
     static inline double realDeltaTime;
+    static inline std::unique_ptr<Clock> clock_ = std::make_unique<RealTimeClock>();
 };
 
 }
@@ -1,10 +1,12 @@
 ﻿#pragma once
 
 #include <memory>
+#include <iterator>
 
 #include "UniDxDefine.h"
 #include "Component.h"
 #include "GameObject.h"
+#include "TransformHierarchy.h"
 
 
 namespace UniDx {
@@ -15,43 +17,98 @@ namespace UniDx {
 // --------------------
 class Transform : public Component
 {
+    // プロパティのアクセサ
+    Vector3 getLocalPosition() const { return _localPosition; }
+    void setLocalPosition(const Vector3& v) { _localPosition = v; markDirty(); }
+    Quaternion getLocalRotation() const { return _localRotation; }
+    void setLocalRotation(const Quaternion& q) { _localRotation = q; markDirty(); }
+    Vector3 getLocalScale() const { return _localScale; }
+    void setLocalScale(const Vector3& v) { _localScale = v; markDirty(); }
+
+    Vector3 getPosition() const { return localToWorldMatrix().translation(); }
+    void setPosition(const Vector3& worldPos);
+    Quaternion getRotation() const;
+    void setRotation(const Quaternion& worldRot);
+    Vector3 getForward() const { return TransformDirection(Vector3::forward); }
+    void setForward(const Vector3& worldForward);
+    Vector3 getUp() const { return TransformDirection(Vector3::up); }
+    void setUp(const Vector3& worldUp);
+    Vector3 getRight() const { return TransformDirection(Vector3::right); }
+    void setRight(const Vector3& worldRight);
+
 public:
-    typedef std::vector<unique_ptr<GameObject>> GameObjectContainer;
+    // 子GameObjectを兄弟リンクでたどるイテレータ（追加した順）
+    class ChildIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = GameObject*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = GameObject* const*;
+        using reference = GameObject*;
+
+        ChildIterator() = default;
+        explicit ChildIterator(const Transform* t) : current_(t) {}
+
+        GameObject* operator*() const { return current_->gameObject; }
+        ChildIterator& operator++() { current_ = current_->nextSibling_; return *this; }
+        ChildIterator operator++(int) { ChildIterator r = *this; ++*this; return r; }
+        bool operator==(const ChildIterator&) const = default;
+
+    private:
+        const Transform* current_ = nullptr;
+    };
+
+    // 子GameObjectの範囲（range-based for 用）
+    class ChildRange
+    {
+    public:
+        explicit ChildRange(const Transform* first) : first_(first) {}
+        ChildIterator begin() const { return ChildIterator(first_); }
+        ChildIterator end() const { return ChildIterator(); }
+
+    private:
+        const Transform* first_;
+    };
 
     // ローカルの姿勢
-    Property<Vector3> localPosition;
-    Property<Quaternion> localRotation;
-    Property<Vector3> localScale;
+    MemberProperty<&Transform::getLocalPosition, &Transform::setLocalPosition> localPosition{ this };
+    MemberProperty<&Transform::getLocalRotation, &Transform::setLocalRotation> localRotation{ this };
+    MemberProperty<&Transform::getLocalScale, &Transform::setLocalScale> localScale{ this };
 
     // ワールド空間のプロパティ
-    Property<Vector3> position;
-    Property<Quaternion> rotation;
-    Property<Vector3> forward;
-    Property<Vector3> up;
-    Property<Vector3> right;
+    MemberProperty<&Transform::getPosition, &Transform::setPosition> position{ this };
+    MemberProperty<&Transform::getRotation, &Transform::setRotation> rotation{ this };
+    MemberProperty<&Transform::getForward, &Transform::setForward> forward{ this };
+    MemberProperty<&Transform::getUp, &Transform::setUp> up{ this };
+    MemberProperty<&Transform::getRight, &Transform::setRight> right{ this };
 
     Transform* parent = nullptr;
 
-    const GameObjectContainer& getChildGameObjects() const { return children; }
+    /** @brief 子GameObjectを追加した順にたどる範囲。たどっている間に親子関係を変えないこと */
+    ChildRange getChildGameObjects() const { return ChildRange(firstChild_); }
 
-    /** @brief 親の変更（すでに親を設定している場合） */
+    /**
+     * @brief 親の変更（すでに親を設定している場合）
+     * newParent が nullptr ならシーンのルートに移す。シーンに属していなければ削除して nullptr を返す
+     */
     GameObject* SetParent(Transform* newParent);
 
     /** @brief 親のいないTransformを持つGameObjectに親を設定 */
     static void SetParent(unique_ptr<GameObject> gameObjectPtr, Transform* newParent);
 
     /** @brief 子の数を取得 */
-    size_t childCount() const { return children.size(); }
+    size_t childCount() const { return childCount_; }
 
-    /** @brief 子を取得 */
+    /** @brief 子を取得（先頭から index 個たどる） */
     Transform* GetChild(size_t index) const;
 
     /** @brief ローカル座標系から親座標系への変換行列 */
     const Matrix4x4& localMatrix() const;
 
-    /** @brief ワールド座標系への変換行列 */
+    /** @brief ワールド座標系への変換行列。更新済みならキャッシュを返すだけ */
     const Matrix4x4& localToWorldMatrix() const {
-        updateMatrices();
+        if (m_worldDirty) updateMatrices();
         return m_worldMatrix;
     }
 
@@ -75,11 +132,15 @@ public:
 
 private:
     // ダーティフラグと行列
-    mutable bool m_dirty = true;
+    // ワールドがダーティなら子孫も必ずダーティ（設定時にサブツリーへ伝播する）
+    mutable bool m_localDirty = true;
+    mutable bool m_worldDirty = true;
+    mutable bool m_worldChanged = true;     // TransformHierarchyの配列へ未反映
     mutable Matrix4x4 m_localMatrix = Matrix4x4::identity;
     mutable Matrix4x4 m_worldMatrix = Matrix4x4::identity;
 
-    bool dirtyInHierarchy() const { return m_dirty || parent && parent->dirtyInHierarchy(); }
+    // 所属しているシーンの階層配列
+    TransformHierarchy* hierarchy_ = nullptr;
 
     Vector3 _localPosition{ 0,0,0 };
     Quaternion _localRotation = Quaternion::identity;
@@ -87,10 +148,32 @@ private:
 
     // 子GameObject
     // トップ以外のGameObjectはTransformによって保持される
-    GameObjectContainer children;
+    // 侵入型の双方向リストで、付け替えと削除は兄弟の数によらず O(1)
+    Transform* firstChild_ = nullptr;
+    Transform* lastChild_ = nullptr;
+    Transform* prevSibling_ = nullptr;
+    Transform* nextSibling_ = nullptr;
+    size_t childCount_ = 0;
+
+    // 子リストの末尾に所有権ごと追加する
+    void linkChild(unique_ptr<GameObject> child);
+
+    // 子リストから外して所有権を返す
+    unique_ptr<GameObject> unlinkChild(Transform* child);
+
+    // ローカルが変わったときに呼ぶ。サブツリーのワールド行列をダーティにする
+    void markDirty();
+    void markWorldDirty();
 
     // 行列の更新
     void updateMatrices() const;
+    void updateWorldMatrix(const Matrix4x4* parentWorld) const;
+
+    // シーンの階層配列から外す
+    void leaveHierarchy();
+
+    friend class TransformHierarchy;
+    friend class GameObject;
 };
 
 } // namespace UniDx
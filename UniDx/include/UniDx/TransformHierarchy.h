@@ -0,0 +1,65 @@
+﻿#pragma once
+
+#include <vector>
+#include <span>
+
+#include "UniDxDefine.h"
+#include "Math.h"
+
+
+namespace UniDx {
+
+class Transform;
+class Scene;
+
+
+// --------------------
+// TransformHierarchyクラス
+// シーン内のTransformを深さ順（親が必ず子より前）に並べた配列
+// 毎フレーム先頭から1回なめるだけで、ダーティなサブツリーのワールド行列を更新する
+// 同じ深さのTransformは互いに依存しないので、深さごとにジョブで並列に更新する
+// --------------------
+class TransformHierarchy
+{
+public:
+    explicit TransformHierarchy(Scene* scene) : scene_(scene) {}
+
+    /** @brief GameObjectの追加・削除・親の変更があったときに呼ぶ。次の update() で並べ直す */
+    void invalidate() { structureDirty_ = true; }
+
+    /** @brief ダーティなTransformのワールド行列を深さ順に更新する */
+    void update();
+
+    /** @brief 登録されているTransformの数 */
+    size_t size() const { return nodes_.size(); }
+
+    /** @brief 深さ順のTransform */
+    std::span<Transform* const> transforms() const { return nodes_; }
+
+    /** @brief 深さ順の親のインデックス（ルートは -1） */
+    std::span<const int> parentIndices() const { return parents_; }
+
+    /** @brief 深さ順のワールド行列。カリングやスキニングでまとめて読むときに使う */
+    std::span<const Matrix4x4> worldMatrices() const { return worldMatrices_; }
+
+private:
+    Scene* scene_;
+    bool structureDirty_ = true;
+
+    // SoA
+    std::vector<Transform*> nodes_;
+    std::vector<int> parents_;
+    std::vector<Matrix4x4> worldMatrices_;
+    std::vector<size_t> levels_;    // 各深さの先頭のインデックス（末尾に総数）
+
+    // 1つのジョブで更新する数
+    static constexpr size_t BatchSize = 256;
+
+    // 並べ直し
+    void rebuild();
+
+    // [begin, end) のワールド行列を更新
+    void updateRange(size_t begin, size_t end);
+};
+
+} // namespace UniDx
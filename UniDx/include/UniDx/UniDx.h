@@ -4,6 +4,7 @@
 #include "StringId.h"
 #include "Math.h"
 #include "Debug.h"
+#include "Profiler.h"
 #include "Func.h"
 
 #include "GameObject.h"
@@ -1,14 +1,15 @@
 ﻿#pragma once
 
+#include <assert.h>
 #include <vector>
 #include <memory>
 #include <string>
 #include <sstream>
 #include <iomanip>
 
-#include <d3d11.h>
 #include <DirectXMath.h>
-#include <wrl/client.h>
+
+#include "Platform.h"
 
 namespace UniDx
 {
@@ -19,7 +20,6 @@ using std::unique_ptr;
 using std::shared_ptr;
 using std::make_unique;
 using std::make_shared;
-using Microsoft::WRL::ComPtr;
 
 class Object;
 class GameObject;
@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <deque>
 #include <span>
@@ -35,6 +37,14 @@ public:
     // 衝突する可能性のあるペアを集める
     void gatherPairs();
 
+    // bounds と移動範囲が重なるShapeに func(PhysicsShape*) を呼ぶ（最後に update() したときの範囲で判定）
+    template<typename Func>
+    void query(const Bounds& bounds, Func&& func)
+    {
+        if (gridNodeSize == 0) return;
+        queryNode(&gridNodes[0], bounds, func);
+    }
+
 private:
     struct GridNode
     {
@@ -86,6 +96,42 @@ private:
     void insertShapeToChild(GridNode* node, PhysicsShape* shape, Vector3 cellMin);
     void traverseNode(GridNode* node, std::vector<std::span<PhysicsShape*>>& ancestorShapes, std::vector<GridNode*>& neighbor);
     void checkBounds(GridNode* node, PhysicsShape* shape);
+
+    template<typename Func>
+    void queryNode(GridNode* node, const Bounds& bounds, Func& func)
+    {
+        for (PhysicsShape* shape : node->shapes)
+        {
+            if (shape->moveBounds.Intersects(bounds)) func(shape);
+        }
+
+        if (node->isLeaf()) return;
+
+        // 子のShapeはセルから最大でセルの大きさまではみ出すので、その分広げた範囲のセルを調べる
+        const Vector3 margin = node->leafCellSize;
+        const Vector3 indexMin = (bounds.min() - margin - node->bounds.min()) / node->stride;
+        const Vector3 indexMax = (bounds.max() + margin - node->bounds.min()) / node->stride;
+        const int sx = std::clamp(int(std::floor(indexMin.x)), 0, node->childX - 1);
+        const int sy = std::clamp(int(std::floor(indexMin.y)), 0, node->childY - 1);
+        const int sz = std::clamp(int(std::floor(indexMin.z)), 0, node->childZ - 1);
+        const int ex = std::clamp(int(std::floor(indexMax.x)), 0, node->childX - 1);
+        const int ey = std::clamp(int(std::floor(indexMax.y)), 0, node->childY - 1);
+        const int ez = std::clamp(int(std::floor(indexMax.z)), 0, node->childZ - 1);
+        for (int z = sz; z <= ez; ++z)
+        {
+            for (int y = sy; y <= ey; ++y)
+            {
+                for (int x = sx; x <= ex; ++x)
+                {
+                    GridNode* child = node->getChild(x, y, z);
+                    if (child != nullptr && child->shapeBounds.Intersects(bounds))
+                    {
+                        queryNode(child, bounds, func);
+                    }
+                }
+            }
+        }
+    }
 };
 
 }
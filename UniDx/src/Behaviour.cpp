@@ -0,0 +1,63 @@
+﻿#include "pch.h"
+#include <UniDx/Behaviour.h>
+
+#include <UniDx/PlayerLoop.h>
+#include <UniDx/CommandBuffer.h>
+
+
+namespace UniDx{
+
+Behaviour::~Behaviour()
+{
+    StopAllCoroutines();
+}
+
+
+void Behaviour::setDormant(bool value)
+{
+    if (value == isDormant()) return;
+
+    Component::setDormant(value);
+    if (value)
+    {
+        StopAllCoroutines();
+    }
+
+    // まだAwakeしていなければ作りたてなので、リセットは不要
+    if (isCalledAwake)
+    {
+        if (value) OnDespawn();
+        else OnSpawn();
+    }
+}
+
+
+CoroutineHandle Behaviour::StartCoroutine(Coroutine coroutine)
+{
+    assert(!CommandBuffer::isRecording()); // コルーチンはメインスレッドだけで動かす
+
+    auto* loop = PlayerLoop::getInstance();
+    if (loop == nullptr) return {};
+    return loop->coroutineScheduler().start(this, std::move(coroutine));
+}
+
+
+void Behaviour::StopCoroutine(CoroutineHandle handle)
+{
+    if (auto* loop = PlayerLoop::getInstance())
+    {
+        loop->coroutineScheduler().stop(handle);
+    }
+}
+
+
+void Behaviour::StopAllCoroutines()
+{
+    if (coroutineCount_ == 0) return;
+    if (auto* loop = PlayerLoop::getInstance())
+    {
+        loop->coroutineScheduler().stopAll(this);
+    }
+}
+
+}
@@ -1,8 +1,6 @@
 ﻿#include "pch.h"
 #include <UniDx/Camera.h>
 #include <UniDx/ConstantBuffer.h>
-#include <UniDx/D3DManager.h>
-#include <SimpleMath.h>
 
 
 namespace UniDx{
@@ -32,13 +30,13 @@ Matrix4x4 Camera::GetProjectionMatrix(float aspect) const
 }
 
 
-void Camera::UpdateConstantBuffer()
+void Camera::makeConstantBuffer(ConstantBufferPerCamera& cb) const
 {
     // 時間に関わる time, unscaledDeltaTime, 1/unscaledDeltaTime, frameCount を送信
     constexpr float minDt = 1.0f / 600.0f;
     float dt = std::max(Time::unscaledDeltaTime, minDt);
 
-    ConstantBufferPerCamera cb{};
+    cb = ConstantBufferPerCamera{};
     cb.view = GetViewMatrix();
     cb.projection = GetProjectionMatrix(16.0f / 9.0f);
     cb.cameraPosW = transform->position;
@@ -49,12 +47,6 @@ void Camera::UpdateConstantBuffer()
     cb.time.y = dt;
     cb.time.z = 1.0f / dt;
     cb.time.w = float(Time::frameCount);
-    D3DManager::getInstance()->GetContext()->UpdateSubresource(constantBufferPerCamera.Get(), 0, nullptr, &cb, 0, 0);
-
-    // 定数バッファ更新
-    ID3D11Buffer* cbs[1] = { constantBufferPerCamera.Get() };
-    D3DManager::getInstance()->GetContext()->VSSetConstantBuffers(CB_PerCamera, 1, cbs);
-    D3DManager::getInstance()->GetContext()->PSSetConstantBuffers(CB_PerCamera, 1, cbs);
 }
 
 
@@ -64,14 +56,6 @@ void Camera::OnEnable()
     {
         main = this;
     }
-
-    // フレームごとにGPUで共通利用する定数バッファ
-    D3D11_BUFFER_DESC desc{};
-    desc.ByteWidth = sizeof(ConstantBufferPerCamera);
-    desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-    desc.CPUAccessFlags = 0;
-    desc.Usage = D3D11_USAGE_DEFAULT;
-    D3DManager::getInstance()->GetDevice()->CreateBuffer(&desc, nullptr, constantBufferPerCamera.GetAddressOf());
 }
 
 
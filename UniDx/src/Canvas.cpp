@@ -17,6 +17,7 @@ using namespace DirectX;
 
 void Canvas::Awake()
 {
+	if (D3DManager::isHeadless()) return;
 	size = D3DManager::getInstance()->getScreenSize();
 }
 
@@ -24,9 +25,9 @@ void Canvas::Awake()
 void Canvas::LoadDefaultMaterial(const char8_t* assetPath)
 {
 	std::filesystem::path assetRoot = assetPath;
-	defaultMaterial = std::make_unique<Material>();
+	defaultMaterial = std::make_shared<Material>();
 	defaultMaterial->shader->compile<VertexPC>( (assetRoot / "Color.hlsl").u8string());
-	defaultTextureMaterial = std::make_unique<Material>();
+	defaultTextureMaterial = std::make_shared<Material>();
 	defaultTextureMaterial->shader->compile<VertexPTC>((assetRoot / "Sprite.hlsl").u8string());
 }
 
@@ -58,25 +59,11 @@ void Canvas::unregisterUI(UIBehaviour* e)
 }
 
 
-Material* Canvas::getDefaultMaterial()
+void Canvas::buildPackets(RenderPacketBuilder& builder) const
 {
-	return defaultMaterial.get();
-}
-
-
-Material* Canvas::getDefaultTextureMaterial()
-{
-	return defaultTextureMaterial.get();
-}
-
-
-void Canvas::render() const
-{
-	Matrix4x4 proj( XMMatrixOrthographicLH(size.x, size.y, -1.0f, 1.0f) );
-
 	for (auto& it : elements_)
 	{
-		it->render(proj);
+		it->buildPackets(builder);
 	}
 }
 
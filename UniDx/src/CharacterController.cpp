@@ -0,0 +1,197 @@
+﻿#include "pch.h"
+#include <UniDx/CharacterController.h>
+
+#include <algorithm>
+
+#include <UniDx/Collider.h>
+#include <UniDx/Physics.h>
+#include <UniDx/Time.h>
+
+
+namespace UniDx{
+
+// 衝突対象にするコライダーか
+bool CharacterController::canCollide(const Collider* other) const
+{
+    if (other->isTrigger || other->gameObject == gameObject) return false;
+
+    // 双方向チェック（Collider::CanCollideWith と同じ規則）
+    return ((layerMask & (1u << other->layer)) != 0) &&
+           ((other->layerMask & (1u << layer)) != 0);
+}
+
+
+// 歩ける斜面か
+bool CharacterController::isWalkable(Vector3 normal) const
+{
+    return normal.y >= std::cos(slopeLimit * Deg2Rad);
+}
+
+
+// 球を掃引して最初に当たるコライダーを調べる
+bool CharacterController::sweep(Physics* world, Vector3 pos, Vector3 direction, float distance, RaycastHit* hit) const
+{
+    return world->SphereCast(pos, radius, direction, distance, hit,
+        [this](const Collider* c) { return canCollide(c); });
+}
+
+
+// 重なっているコライダーから押し出す
+Vector3 CharacterController::depenetrate(Physics* world, Vector3 pos)
+{
+    overlaps_.clear();
+    world->OverlapSphere(pos, radius, overlaps_, [this](const Collider* c) { return canCollide(c); });
+
+    for (Collider* col : overlaps_)
+    {
+        Vector3 d = pos - col->ClosestPoint(pos);
+        float len = d.magnitude();
+        if (len >= radius) continue;
+
+        if (len > 1e-6f)
+        {
+            pos += d * ((radius - len + skinWidth * 0.5f) / len);
+        }
+        else
+        {
+            // 中心がめり込んでいるときは上に逃がす
+            pos += Vector3::up * (radius + skinWidth * 0.5f);
+        }
+    }
+    return pos;
+}
+
+
+// 掃引しながら移動し、当たった面に沿って残りを滑らせる
+Vector3 CharacterController::moveAndSlide(Physics* world, Vector3 pos, Vector3 motion, bool vertical, CollisionFlags& flags)
+{
+    for (int i = 0; i < MaxSlideIterations; ++i)
+    {
+        float dist = motion.magnitude();
+        if (dist < 1e-6f) break;
+        Vector3 dir = motion / dist;
+
+        RaycastHit hit;
+        if (!sweep(world, pos, dir, dist + skinWidth, &hit))
+        {
+            pos += motion;
+            break;
+        }
+
+        // 隙間を残して当たる手前まで進む
+        float travel = std::max(hit.distance - skinWidth, 0.0f);
+        pos += dir * travel;
+        reportHit(hit, dir, dist);
+
+        Vector3 n = hit.normal;
+        bool walkable = isWalkable(n);
+        if (walkable)
+        {
+            flags = CollisionFlags(flags | CollisionFlags_Below);
+        }
+        else if (n.y < -0.5f)
+        {
+            flags = CollisionFlags(flags | CollisionFlags_Above);
+        }
+        else
+        {
+            flags = CollisionFlags(flags | CollisionFlags_Sides);
+        }
+
+        // 縦移動で接地したら残りは捨てる
+        if (vertical && walkable) break;
+
+        // 横移動で急斜面に当たったときは登らないよう壁として扱う
+        if (!vertical && !walkable)
+        {
+            n.y = 0.0f;
+            if (n.sqrMagnitude() < 1e-6f) break;
+            n = n.normalized();
+        }
+
+        // 残りの移動量を面に沿わせる
+        Vector3 rest = dir * (dist - travel);
+        motion = rest - n * Dot(rest, n);
+    }
+    return pos;
+}
+
+
+// 接触をBehaviourに通知する（1回の Move() でコライダーごとに1度）
+void CharacterController::reportHit(const RaycastHit& hit, Vector3 direction, float length)
+{
+    if (std::ranges::find(reportedHits_, hit.collider) != reportedHits_.end()) return;
+    reportedHits_.push_back(hit.collider);
+
+    ControllerColliderHit h;
+    h.controller = this;
+    h.collider = hit.collider;
+    h.point = hit.point;
+    h.normal = hit.normal;
+    h.moveDirection = direction;
+    h.moveLength = length;
+    gameObject->onControllerColliderHit(h);
+}
+
+
+// motion だけ移動する
+CollisionFlags CharacterController::Move(Vector3 motion)
+{
+    const bool wasGrounded = isGrounded();
+    Vector3 start = transform->position;
+    CollisionFlags flags = CollisionFlags_None;
+    reportedHits_.clear();
+
+    Physics* world = Physics::of(gameObject);
+    if (world == nullptr)
+    {
+        // シーンに属していなければそのまま動かす
+        transform->position = start + motion;
+        collisionFlags_ = flags;
+        return flags;
+    }
+
+    // center はローカル座標なので、Transformの回転に合わせて向きを変える
+    const Vector3 worldCenter = transform->TransformDirection(center);
+    Vector3 pos = depenetrate(world, start + worldCenter);
+
+    Vector3 upMotion = Vector3::up * motion.y;
+    Vector3 sideMotion = motion - upMotion;
+
+    // 段差を登れるよう、横移動の前に stepOffset だけ持ち上げる
+    float raised = 0.0f;
+    if (wasGrounded && stepOffset > 0.0f && motion.y <= 0.0f && sideMotion.sqrMagnitude() > 1e-8f)
+    {
+        float before = pos.y;
+        CollisionFlags upFlags = CollisionFlags_None;
+        pos = moveAndSlide(world, pos, Vector3::up * stepOffset, true, upFlags);
+        raised = pos.y - before;
+    }
+
+    // 横移動
+    pos = moveAndSlide(world, pos, sideMotion, false, flags);
+
+    // 縦移動（持ち上げた分も戻す）
+    pos = moveAndSlide(world, pos, upMotion - Vector3::up * raised, true, flags);
+
+    // 接地していたら段差を降りるときも地面に吸い付ける
+    if (wasGrounded && motion.y <= 0.0f && (flags & CollisionFlags_Below) == 0)
+    {
+        RaycastHit hit;
+        if (sweep(world, pos, Vector3::down, stepOffset + skinWidth, &hit) && isWalkable(hit.normal))
+        {
+            pos += Vector3::down * std::max(hit.distance - skinWidth, 0.0f);
+            flags = CollisionFlags(flags | CollisionFlags_Below);
+        }
+    }
+
+    Vector3 end = pos - worldCenter;
+    transform->position = end;
+
+    float dt = Time::deltaTime;
+    velocity_ = dt > 0.0f ? (end - start) / dt : Vector3::zero;
+    collisionFlags_ = flags;
+    return flags;
+}
+
+}
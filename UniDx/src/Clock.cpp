@@ -0,0 +1,40 @@
+﻿#include "pch.h"
+#include <UniDx/Clock.h>
+
+#include <UniDx/Time.h>
+#include <UniDx/Random.h>
+
+
+namespace UniDx{
+
+namespace
+{
+    bool s_deterministic = false;
+}
+
+
+void Determinism::Enable(uint64_t seed, double step)
+{
+    s_deterministic = true;
+    // 1フレームに FixedUpdate がちょうど1回ずつ回るよう、既定では fixedDeltaTime と同じ幅で進める
+    if (step <= 0.0) step = Time::fixedDeltaTime;
+    Time::SetClock(std::make_unique<FixedStepClock>(step));
+    Random::setDefaultSeedSequence(true, seed);
+    Random::global().InitState(Random::defaultSeed());
+}
+
+
+void Determinism::Disable()
+{
+    s_deterministic = false;
+    Time::SetClock(nullptr);
+    Random::setDefaultSeedSequence(false);
+}
+
+
+bool Determinism::isEnabled()
+{
+    return s_deterministic;
+}
+
+}
@@ -107,6 +107,51 @@ namespace
         return true;
     }
 
+    // 正規化済みの方向に進むレイとBoundsの交差
+    // 始点が内部のときは false を返す
+    bool raycastBounds_(const Bounds& b, Vector3 origin, Vector3 direction, float maxDistance, float* outDistance, Vector3* outNormal)
+    {
+        const float eps = 1e-6f;
+        const float o[3] = { origin.x, origin.y, origin.z };
+        const float d[3] = { direction.x, direction.y, direction.z };
+        const Vector3 bmin = b.min();
+        const Vector3 bmax = b.max();
+        const float mn[3] = { bmin.x, bmin.y, bmin.z };
+        const float mx[3] = { bmax.x, bmax.y, bmax.z };
+
+        float tmin = -infinity;
+        float tmax = infinity;
+        int enterAxis = -1;
+        for (int i = 0; i < 3; ++i)
+        {
+            if (fabs(d[i]) < eps)
+            {
+                if (o[i] < mn[i] || o[i] > mx[i]) return false;
+                continue;
+            }
+            float inv = 1.0f / d[i];
+            float t1 = (mn[i] - o[i]) * inv;
+            float t2 = (mx[i] - o[i]) * inv;
+            if (t1 > t2) std::swap(t1, t2);
+            if (t1 > tmin)
+            {
+                tmin = t1;
+                enterAxis = i;
+            }
+            tmax = std::min(tmax, t2);
+            if (tmin > tmax) return false;
+        }
+
+        // 始点が内部、または範囲外
+        if (tmin < 0.0f || tmin > maxDistance || enterAxis < 0) return false;
+
+        float n[3] = { 0, 0, 0 };
+        n[enterAxis] = d[enterAxis] > 0.0f ? -1.0f : 1.0f;
+        *outDistance = tmin;
+        *outNormal = Vector3(n[0], n[1], n[2]);
+        return true;
+    }
+
 }
 
 
@@ -287,6 +332,37 @@ namespace UniDx
     }
 
 
+    // 球を動かしたときの衝突チェック（AABB）
+    // 半径分広げたAABBに対するレイとして扱う。角の丸みは無視するので、角では少し手前で止まる
+    bool AABBCollider::SphereCast(Vector3 origin, float radius, Vector3 direction, float maxDistance, RaycastHit* hitInfo)
+    {
+        Bounds b = getBounds();
+        b.extents = Vector3(std::abs(b.extents.x), std::abs(b.extents.y), std::abs(b.extents.z)) + Vector3(radius, radius, radius);
+
+        float t;
+        Vector3 normal;
+        if (!raycastBounds_(b, origin, direction, maxDistance, &t, &normal)) return false;
+
+        if (hitInfo)
+        {
+            hitInfo->collider = this;
+            hitInfo->point = origin + direction * t - normal * radius;
+            hitInfo->normal = normal;
+            hitInfo->distance = t;
+        }
+        return true;
+    }
+
+
+    // 指定点に最も近い点（AABB）
+    Vector3 AABBCollider::ClosestPoint(Vector3 position) const
+    {
+        Bounds b = getBounds();
+        b.extents = Vector3(std::abs(b.extents.x), std::abs(b.extents.y), std::abs(b.extents.z));
+        return b.ClosestPoint(position);
+    }
+
+
     // トリガーチェック
     bool SphereCollider::intersects(AABBCollider* other)
     {
@@ -421,5 +497,51 @@ namespace UniDx
     }
 
 
+    // 球を動かしたときの衝突チェック（Sphere）
+    // 半径の和を半径とする球に対するレイとして扱う
+    bool SphereCollider::SphereCast(Vector3 origin, float castRadius, Vector3 direction, float maxDistance, RaycastHit* hitInfo)
+    {
+        Vector3 centerWorld = transform->TransformPoint(center);
+        float r = radius + castRadius;
+
+        // 始点で既に接触している
+        Vector3 oc = origin - centerWorld;
+        float c = Dot(oc, oc) - r * r;
+        if (c <= 0.0f) return false;
+
+        // direction は正規化済みなので a = 1
+        float b = Dot(direction, oc);
+        if (b > 0.0f) return false; // 離れる方向
+        float disc = b * b - c;
+        if (disc < 0.0f) return false;
+
+        float t = -b - std::sqrt(disc);
+        if (t < 0.0f || t > maxDistance) return false;
+
+        if (hitInfo)
+        {
+            Vector3 hitCenter = origin + direction * t;
+            Vector3 normal = (hitCenter - centerWorld).normalized();
+
+            hitInfo->collider = this;
+            hitInfo->point = centerWorld + normal * radius;
+            hitInfo->normal = normal;
+            hitInfo->distance = t;
+        }
+        return true;
+    }
+
+
+    // 指定点に最も近い点（Sphere）
+    Vector3 SphereCollider::ClosestPoint(Vector3 position) const
+    {
+        Vector3 centerWorld = transform->TransformPoint(center);
+        Vector3 d = position - centerWorld;
+        float len = d.magnitude();
+        if (len <= radius) return position;
+        return centerWorld + d * (radius / len);
+    }
+
+
 
 }
@@ -0,0 +1,86 @@
+﻿#include "pch.h"
+#include <UniDx/CommandBuffer.h>
+
+#include <algorithm>
+
+#include <UniDx/Jobs.h>
+
+
+namespace UniDx{
+
+bool CommandBuffer::recording = false;
+std::vector<std::vector<CommandBuffer::Entry>> CommandBuffer::buffers;
+std::vector<CommandBuffer::Entry> CommandBuffer::otherThreads;
+std::mutex CommandBuffer::otherThreadsMutex;
+
+namespace
+{
+thread_local size_t t_order = 0;
+}
+
+
+void CommandBuffer::setOrder(size_t order)
+{
+    t_order = order;
+}
+
+
+// 並列区間ならスレッドごとのバッファへ、そうでなければその場で実行
+void CommandBuffer::push(Command command)
+{
+    if (!recording)
+    {
+        command();
+        return;
+    }
+
+    int worker = Jobs::currentWorkerIndex();
+    if (worker >= 0 && worker < int(buffers.size()))
+    {
+        buffers[worker].push_back({ t_order, std::move(command) });
+    }
+    else
+    {
+        std::lock_guard lock(otherThreadsMutex);
+        otherThreads.push_back({ t_order, std::move(command) });
+    }
+}
+
+
+void CommandBuffer::begin(size_t workerCount)
+{
+    assert(!recording);
+    if (buffers.size() < workerCount + 1)
+    {
+        buffers.resize(workerCount + 1);
+    }
+    t_order = 0;
+    recording = true;
+}
+
+
+// 記録したコマンドを順番キーで並べて実行
+// 同じキーのコマンドは1つのBehaviourから同じスレッドで積まれるので、安定ソートで記録順が保たれる
+void CommandBuffer::end()
+{
+    recording = false;
+
+    std::vector<Entry> entries = std::move(otherThreads);
+    otherThreads.clear();
+    for (auto& buffer : buffers)
+    {
+        std::move(buffer.begin(), buffer.end(), std::back_inserter(entries));
+        buffer.clear();
+    }
+    if (entries.empty()) return;
+
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b) { return a.order < b.order; });
+
+    for (auto& e : entries)
+    {
+        e.command();
+    }
+}
+
+}
@@ -1,37 +1,101 @@
 ﻿#include "pch.h"
 #include <UniDx/Component.h>
 
+#include <UniDx/PlayerLoop.h>
+#include <UniDx/CommandBuffer.h>
+
 namespace UniDx{
 
 // コンストラクタ
 Component::Component() :
-    Object([this]() { return gameObject != nullptr ? gameObject->name : StringId(); }),
-    enabled(
-        // get
-        [this]() { return _enabled && isCalledAwake; },
-
-        // set
-        [this](bool value) {
-            if (!_enabled && value && !isCalledDestroy) {
-                _enabled = true;
-                if (!isCalledAwake) { Awake(); isCalledAwake = true; }
-                OnEnable();
-            }
-            else if (_enabled && !value) {
-                _enabled = false;
-                if (isCalledAwake) { OnDisable(); }
-            }
-        }
-    ),
-    transform(
-        [this]() { return gameObject->transform; }
-    ),
-    _enabled(true),
     isCalledAwake(false),
     isCalledStart(false),
-    isCalledDestroy(false)
+    isCalledDestroy(false),
+    _enabled(true)
 {
+    phaseSlots_.fill(-1);
+}
 
+// 複製用のコンストラクタ
+// プロパティはメンバ初期化子で新しいインスタンスを指す
+Component::Component(const Component& other) :
+    Object(other),
+    isCalledAwake(false),
+    isCalledStart(false),
+    isCalledDestroy(false),
+    _enabled(other._enabled),
+    kind_(other.kind_),
+    phaseMask_(other.phaseMask_),
+    physicsEventMask_(other.physicsEventMask_),
+    cloneFunc_(other.cloneFunc_)
+{
+    phaseSlots_.fill(-1);
+}
+
+// 名前はGameObjectのもの
+StringId Component::getName() const
+{
+    return gameObject != nullptr ? gameObject->name : StringId();
+}
+
+// 有効フラグの設定
+void Component::setEnabled(const bool& value)
+{
+    if (CommandBuffer::isRecording()) {
+        // 並列Update中は実行リストを書き換えられないので、並列区間の後で切り替える
+        CommandBuffer::push([this, value]() { setEnabled(value); });
+        return;
+    }
+
+    if (!_enabled && value && !isCalledDestroy) {
+        _enabled = true;
+        if (!isCalledAwake) { Awake(); isCalledAwake = true; }
+        OnEnable();
+        registerUpdatePhases();
+    }
+    else if (_enabled && !value) {
+        _enabled = false;
+        unregisterUpdatePhases();
+        if (isCalledAwake) { OnDisable(); }
+    }
+}
+
+
+// PlayerLoopの実行リストに登録
+void Component::registerUpdatePhases()
+{
+    if (dormant_) return; // 休眠中は起きたときに登録する
+
+    if (auto* loop = PlayerLoop::getInstance())
+    {
+        loop->registerComponent(this);
+    }
+}
+
+
+// PlayerLoopの実行リストから外す
+void Component::unregisterUpdatePhases()
+{
+    if (auto* loop = PlayerLoop::getInstance())
+    {
+        loop->unregisterComponent(this);
+    }
+}
+
+// 休眠の切り替え
+void Component::setDormant(bool value)
+{
+    if (dormant_ == value) return;
+
+    dormant_ = value;
+    if (dormant_)
+    {
+        unregisterUpdatePhases();
+    }
+    else if (_enabled && isCalledAwake)
+    {
+        registerUpdatePhases();
+    }
 }
 
 void Component::doDestroy()
@@ -50,13 +114,26 @@ void Component::doDestroy()
 // デストラクタ（仮想 OnDestroy をここで呼ばない）
 Component::~Component()
 {
+    unregisterUpdatePhases();
 }
 
 void Destroy(Component* component)
 {
     assert(component != nullptr);
+    if (CommandBuffer::isRecording())
+    {
+        // 並列Update中は実行リストを触れないので後回し
+        CommandBuffer::push([component]() { Destroy(component); });
+        return;
+    }
+    if (component->isCalledDestroy) return; // 破棄待ち
+
     component->enabled = false; // 無効化（ここはUniyと挙動が異なる）
     component->isCalledDestroy = true; // フレームの終わりに削除される
+    if (auto* loop = PlayerLoop::getInstance())
+    {
+        loop->enqueueDestroy(component);
+    }
 }
 
 }
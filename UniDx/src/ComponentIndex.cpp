@@ -0,0 +1,75 @@
+﻿#include "pch.h"
+#include <UniDx/ComponentIndex.h>
+
+#include <algorithm>
+
+
+namespace UniDx{
+
+namespace
+{
+    struct EntryTypeLess
+    {
+        bool operator()(const ComponentIndex::Entry& e, ComponentTypeId t) const { return std::less<>()(e.type, t); }
+        bool operator()(ComponentTypeId t, const ComponentIndex::Entry& e) const { return std::less<>()(t, e.type); }
+    };
+}
+
+
+// 索引に載っている型か
+bool ComponentIndex::isTracked(ComponentTypeId type) const
+{
+    return std::ranges::any_of(tracked_, [type](const TrackedType& t) { return t.type == type; });
+}
+
+
+// 型を索引に載せる。既存のコンポーネントはここで1回だけキャストを試す
+void ComponentIndex::track(ComponentTypeId type, CastFunc cast, const ComponentContainer& components)
+{
+    if (isTracked(type)) return;
+    tracked_.push_back({ type, cast });
+
+    for (auto& c : components)
+    {
+        if (void* p = cast(c.get()))
+        {
+            insert(type, c.get(), p);
+        }
+    }
+}
+
+
+// 追加されたコンポーネントを、索引に載っている型それぞれに登録
+void ComponentIndex::addToTracked(Component* component)
+{
+    for (auto& t : tracked_)
+    {
+        if (void* p = t.cast(component))
+        {
+            insert(t.type, component, p);
+        }
+    }
+}
+
+
+// 同じ型の中では末尾に入れて追加順を保つ
+void ComponentIndex::insert(ComponentTypeId type, Component* component, void* ptr)
+{
+    auto it = std::upper_bound(entries_.begin(), entries_.end(), type, EntryTypeLess());
+    entries_.insert(it, Entry{ type, component, ptr });
+}
+
+
+void ComponentIndex::onRemoved(const Component* component)
+{
+    std::erase_if(entries_, [component](const Entry& e) { return e.component == component; });
+}
+
+
+std::span<const ComponentIndex::Entry> ComponentIndex::equalRange(ComponentTypeId type) const
+{
+    auto [first, last] = std::equal_range(entries_.begin(), entries_.end(), type, EntryTypeLess());
+    return std::span<const Entry>(first, last);
+}
+
+}
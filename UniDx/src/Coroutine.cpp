@@ -0,0 +1,333 @@
+﻿#include "pch.h"
+#include <UniDx/Coroutine.h>
+
+#include <algorithm>
+
+#include <UniDx/Behaviour.h>
+#include <UniDx/Time.h>
+
+
+namespace UniDx{
+
+// -----------------------------------------------------------------------------
+// CoroutineFrameAllocator
+// -----------------------------------------------------------------------------
+
+// 最初に使うときに作り、プロセスの終了まで破棄しない
+// PlayerLoop が静的な破棄の途中でスケジューラを片付けても、ここはまだ有効
+CoroutineFrameAllocator::Pool& CoroutineFrameAllocator::pool()
+{
+    static Pool* instance = new Pool();
+    return *instance;
+}
+
+
+// サイズクラスの番号。プールしない大きさなら SIZE_MAX
+size_t CoroutineFrameAllocator::sizeClass(size_t size)
+{
+    size_t shift = MinBlockShift;
+    while ((size_t(1) << shift) < size)
+    {
+        if (++shift > MaxBlockShift) return SIZE_MAX;
+    }
+    return shift - MinBlockShift;
+}
+
+
+void* CoroutineFrameAllocator::allocate(size_t size)
+{
+    size_t c = sizeClass(size);
+    if (c == SIZE_MAX) return ::operator new(size);
+
+    Pool& state = pool();
+    std::lock_guard lock(state.mutex);
+    if (state.freeLists[c] == nullptr)
+    {
+        // 1ページを同じサイズのブロックに切り分けてフリーリストに積む
+        size_t blockSize = size_t(1) << (c + MinBlockShift);
+        auto& page = state.pages.emplace_back(std::make_unique<std::byte[]>(PageSize));
+        for (size_t offset = 0; offset + blockSize <= PageSize; offset += blockSize)
+        {
+            auto* block = reinterpret_cast<FreeBlock*>(page.get() + offset);
+            block->next = state.freeLists[c];
+            state.freeLists[c] = block;
+        }
+    }
+
+    FreeBlock* block = state.freeLists[c];
+    state.freeLists[c] = block->next;
+    return block;
+}
+
+
+void CoroutineFrameAllocator::deallocate(void* p, size_t size)
+{
+    size_t c = sizeClass(size);
+    if (c == SIZE_MAX)
+    {
+        ::operator delete(p);
+        return;
+    }
+
+    Pool& state = pool();
+    std::lock_guard lock(state.mutex);
+    auto* block = static_cast<FreeBlock*>(p);
+    block->next = state.freeLists[c];
+    state.freeLists[c] = block;
+}
+
+
+// -----------------------------------------------------------------------------
+// 待機オブジェクト
+// -----------------------------------------------------------------------------
+void WaitForNextFrame::await_suspend(Coroutine::Handle h) const
+{
+    h.promise().scheduler->waitForNextFrame(h.promise().slot);
+}
+
+void WaitForSeconds::await_suspend(Coroutine::Handle h) const
+{
+    h.promise().scheduler->waitForSeconds(h.promise().slot, seconds);
+}
+
+void WaitForFixedUpdate::await_suspend(Coroutine::Handle h) const
+{
+    h.promise().scheduler->waitForFixedUpdate(h.promise().slot);
+}
+
+void WaitUntil::await_suspend(Coroutine::Handle h)
+{
+    h.promise().scheduler->waitUntil(h.promise().slot, std::move(predicate), true);
+}
+
+void WaitWhile::await_suspend(Coroutine::Handle h)
+{
+    h.promise().scheduler->waitUntil(h.promise().slot, std::move(predicate), false);
+}
+
+
+// -----------------------------------------------------------------------------
+// CoroutineScheduler
+// -----------------------------------------------------------------------------
+namespace
+{
+// 再開時刻が早いものを先頭にする
+bool laterWake(float a, float b) { return a > b; }
+}
+
+
+CoroutineScheduler::~CoroutineScheduler()
+{
+    for (auto& s : slots_)
+    {
+        if (s.handle) s.handle.destroy();
+    }
+}
+
+
+CoroutineHandle CoroutineScheduler::start(Behaviour* owner, Coroutine coroutine)
+{
+    Coroutine::Handle h = coroutine.release();
+    if (!h) return {};
+
+    uint32_t slot;
+    if (!freeSlots_.empty())
+    {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    }
+    else
+    {
+        slot = uint32_t(slots_.size());
+        slots_.emplace_back();
+    }
+
+    Slot& s = slots_[slot];
+    s.handle = h;
+    s.owner = owner;
+    s.running = false;
+    s.stopRequested = false;
+    h.promise().scheduler = this;
+    h.promise().slot = slot;
+    if (owner) ++owner->coroutineCount_;
+
+    CoroutineHandle handle{ slot, s.generation };
+
+    // Unity同様、最初の待機まではその場で進める
+    resume(refOf(slot));
+    return handle;
+}
+
+
+void CoroutineScheduler::stop(CoroutineHandle handle)
+{
+    Ref ref{ handle.slot, handle.generation };
+    if (!isAlive(ref)) return;
+
+    Slot& s = slots_[ref.slot];
+    if (s.running)
+    {
+        // 実行中のフレームは破棄できないので、戻ってきたところで止める
+        s.stopRequested = true;
+        return;
+    }
+    release(ref.slot);
+}
+
+
+void CoroutineScheduler::stopAll(Behaviour* owner)
+{
+    if (owner == nullptr || owner->coroutineCount_ == 0) return;
+
+    for (uint32_t i = 0; i < slots_.size() && owner->coroutineCount_ > 0; ++i)
+    {
+        if (slots_[i].handle && slots_[i].owner == owner)
+        {
+            stop({ i, slots_[i].generation });
+        }
+    }
+}
+
+
+bool CoroutineScheduler::isRunning(CoroutineHandle handle) const
+{
+    return isAlive({ handle.slot, handle.generation });
+}
+
+
+void CoroutineScheduler::resumeFrame()
+{
+    // このフレームの Start() や Update() で待ち始めた分は次のフレームに回す
+    // 再開中に積まれた分も同じフレームの番号なので、ここでは取り出されない
+    const int frame = Time::frameCount;
+    auto waitedFromEarlierFrame = [frame](const Ref& ref) { return ref.frame < frame; };
+
+    std::erase_if(nextFrame_, [this, &waitedFromEarlierFrame](const Ref& ref) {
+        if (!waitedFromEarlierFrame(ref)) return false;
+        due_.push_back(ref);
+        return true;
+    });
+
+    // 再開時刻になったタイマーを取り出す
+    const auto heapOrder = [](const Timer& a, const Timer& b) { return laterWake(a.wakeTime, b.wakeTime); };
+    std::vector<Timer> sameFrame;   // WaitForSeconds(0) などで待ち始めたフレームのうちに時刻が来ているもの
+    while (!timers_.empty() && timers_.front().wakeTime <= Time::time)
+    {
+        std::pop_heap(timers_.begin(), timers_.end(), heapOrder);
+        const Timer timer = timers_.back();
+        timers_.pop_back();
+        if (waitedFromEarlierFrame(timer.ref)) due_.push_back(timer.ref);
+        else sameFrame.push_back(timer);
+    }
+    for (const Timer& timer : sameFrame)
+    {
+        timers_.push_back(timer);
+        std::push_heap(timers_.begin(), timers_.end(), heapOrder);
+    }
+
+    // 条件が満たされたものを取り出す
+    std::erase_if(conditions_, [this, &waitedFromEarlierFrame](Condition& c) {
+        if (!isAlive(c.ref)) return true;
+        if (!waitedFromEarlierFrame(c.ref)) return false;
+        if (c.predicate() != c.expected) return false;
+        due_.push_back(c.ref);
+        return true;
+    });
+
+    resumeAll(due_);
+}
+
+
+void CoroutineScheduler::resumeFixedUpdate()
+{
+    due_.swap(fixedUpdate_);
+    fixedUpdate_.clear();
+    resumeAll(due_);
+}
+
+
+void CoroutineScheduler::waitForNextFrame(uint32_t slot)
+{
+    nextFrame_.push_back(refOf(slot));
+}
+
+
+void CoroutineScheduler::waitForSeconds(uint32_t slot, float seconds)
+{
+    // 時刻が来ていてもこのフレームでは再開しない（resumeFrame で取り出し終わっているため）
+    timers_.push_back({ Time::time + seconds, refOf(slot) });
+    std::push_heap(timers_.begin(), timers_.end(),
+        [](const Timer& a, const Timer& b) { return laterWake(a.wakeTime, b.wakeTime); });
+}
+
+
+void CoroutineScheduler::waitForFixedUpdate(uint32_t slot)
+{
+    fixedUpdate_.push_back(refOf(slot));
+}
+
+
+void CoroutineScheduler::waitUntil(uint32_t slot, std::function<bool()> predicate, bool expected)
+{
+    conditions_.push_back({ refOf(slot), std::move(predicate), expected });
+}
+
+
+CoroutineScheduler::Ref CoroutineScheduler::refOf(uint32_t slot) const
+{
+    return { slot, slots_[slot].generation, Time::frameCount };
+}
+
+
+// 再開用の配列は再開中に積み直されることがあるので、取り出してから回す
+void CoroutineScheduler::resumeAll(std::vector<Ref>& refs)
+{
+    std::vector<Ref> list;
+    list.swap(refs);
+    for (Ref ref : list)
+    {
+        resume(ref);
+    }
+    list.clear();
+    if (refs.empty()) refs.swap(list); // 確保済みの領域を使い回す
+}
+
+
+void CoroutineScheduler::resume(Ref ref)
+{
+    if (!isAlive(ref)) return;
+
+    // 破棄されたBehaviourのコルーチンは再開せずに止める
+    Behaviour* owner = slots_[ref.slot].owner;
+    if (owner != nullptr && owner->isDestroyed())
+    {
+        release(ref.slot);
+        return;
+    }
+
+    slots_[ref.slot].running = true;
+    Coroutine::Handle h = slots_[ref.slot].handle;
+    h.resume();
+
+    // resume() の中で slots_ が伸びて再配置されることがあるので、参照し直す
+    Slot& s = slots_[ref.slot];
+    s.running = false;
+    if (h.done() || s.stopRequested)
+    {
+        release(ref.slot);
+    }
+}
+
+
+void CoroutineScheduler::release(uint32_t slot)
+{
+    Slot& s = slots_[slot];
+    if (s.owner) --s.owner->coroutineCount_;
+    s.handle.destroy();
+    s.handle = nullptr;
+    s.owner = nullptr;
+    ++s.generation;
+    freeSlots_.push_back(slot);
+}
+
+}
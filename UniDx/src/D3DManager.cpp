@@ -1,11 +1,14 @@
 ﻿#include "pch.h"
 #include <UniDx/D3DManager.h>
 
-#include <windows.h>
+#include <algorithm>
 #include <UniDx/ConstantBuffer.h>
+#include <UniDx/FrameLimiter.h>
 
 namespace UniDx{
 
+#if UNIDX_D3D11
+
 // Direct3Dを初期化し、使用できるようにする
 bool D3DManager::Initialize(HWND hWnd, int width, int height)
 {
@@ -177,6 +180,12 @@ void D3DManager::Clear(float r, float g, float b, float a)
 	m_context->OMSetRenderTargets(1, m_renderTarget.GetAddressOf(), m_depthStencilView.Get());
 }
 
+// バックバッファの内容を画面に表示
+void D3DManager::Present()
+{
+	m_swapChain->Present(UINT(std::clamp(FrameLimiter::vSyncCount, 0, 4)), 0);
+}
+
 D3DManager::~D3DManager()
 {
 	m_context->ClearState();
@@ -185,5 +194,11 @@ D3DManager::~D3DManager()
 	m_renderTarget.Reset();
 }
 
+#else
+
+// Direct3D のない環境ではデバイスを作らない
+D3DManager::~D3DManager() = default;
+
+#endif
 
 } // UniDx
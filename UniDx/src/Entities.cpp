@@ -0,0 +1,291 @@
+﻿#include "pch.h"
+#include <UniDx/Entities.h>
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+
+
+namespace UniDx{
+
+namespace
+{
+    // チャンクの先頭と各配列の境界をキャッシュラインにそろえる
+    constexpr size_t ChunkAlignment = 64;
+
+    size_t alignUp(size_t value, size_t align)
+    {
+        return (value + align - 1) & ~(align - 1);
+    }
+
+    std::mutex s_typeMutex;
+    std::array<EntityComponentTypes::Info, EntityComponentTypes::MaxTypes> s_typeInfos;
+    uint32_t s_typeCount = 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// EntityComponentTypes
+// -----------------------------------------------------------------------------
+uint32_t EntityComponentTypes::registerType(size_t size, size_t align)
+{
+    std::lock_guard lock(s_typeMutex);
+    assert(s_typeCount < MaxTypes && "ECSのコンポーネントの型が多すぎます");
+    s_typeInfos[s_typeCount] = Info{ size, align };
+    return s_typeCount++;
+}
+
+
+const EntityComponentTypes::Info& EntityComponentTypes::info(uint32_t id)
+{
+    assert(id < s_typeCount);
+    return s_typeInfos[id];
+}
+
+
+// -----------------------------------------------------------------------------
+// EntityChunk
+// -----------------------------------------------------------------------------
+EntityChunk::EntityChunk(const EntityArchetype* archetype) :
+    archetype_(archetype),
+    data_(static_cast<std::byte*>(::operator new(Size, std::align_val_t(ChunkAlignment))))
+{
+}
+
+
+EntityChunk::~EntityChunk()
+{
+    ::operator delete(data_, std::align_val_t(ChunkAlignment));
+}
+
+
+std::byte* EntityChunk::columnData(size_t column) const
+{
+    return data_ + archetype_->offsets_[column];
+}
+
+
+// -----------------------------------------------------------------------------
+// EntityArchetype
+// -----------------------------------------------------------------------------
+EntityArchetype::EntityArchetype(uint64_t mask) :
+    mask_(mask)
+{
+    columnOf_.fill(-1);
+    for (uint64_t m = mask; m != 0; m &= m - 1)
+    {
+        const uint32_t id = uint32_t(std::countr_zero(m));
+        columnOf_[id] = int8_t(types_.size());
+        types_.push_back(id);
+    }
+
+    // 1エンティティあたりのバイト数から容量を見積もり、配置が収まるまで減らす
+    size_t rowSize = sizeof(Entity);
+    for (uint32_t id : types_) rowSize += EntityComponentTypes::info(id).size;
+    capacity_ = EntityChunk::Size / rowSize;
+
+    offsets_.resize(types_.size());
+    for (; capacity_ > 0; --capacity_)
+    {
+        size_t offset = alignUp(sizeof(Entity) * capacity_, ChunkAlignment);
+        for (size_t i = 0; i < types_.size(); ++i)
+        {
+            const auto& info = EntityComponentTypes::info(types_[i]);
+            offset = alignUp(offset, std::max(info.align, ChunkAlignment));
+            offsets_[i] = offset;
+            offset += info.size * capacity_;
+        }
+        if (offset <= EntityChunk::Size) break;
+    }
+    assert(capacity_ > 0 && "ECSのコンポーネントが大きすぎてチャンクに入りません");
+}
+
+
+size_t EntityArchetype::entityCount() const
+{
+    size_t count = 0;
+    for (auto& chunk : chunks_) count += chunk->count();
+    return count;
+}
+
+
+std::byte* EntityArchetype::cell(uint32_t chunk, uint32_t row, size_t column) const
+{
+    const size_t size = EntityComponentTypes::info(types_[column]).size;
+    return chunks_[chunk]->columnData(column) + size * row;
+}
+
+
+// 末尾に1行確保
+// チャンクは常に前から詰まっているので、空きがあるのは最後のチャンクだけ
+std::pair<uint32_t, uint32_t> EntityArchetype::allocateRow(Entity entity)
+{
+    if (chunks_.empty() || chunks_.back()->count_ == capacity_)
+    {
+        chunks_.push_back(std::make_unique<EntityChunk>(this));
+    }
+    EntityChunk& chunk = *chunks_.back();
+    const uint32_t row = chunk.count_++;
+    chunk.mutableEntities()[row] = entity;
+
+    // POD なので0で初期化しておく
+    for (size_t i = 0; i < types_.size(); ++i)
+    {
+        std::memset(cell(uint32_t(chunks_.size() - 1), row, i), 0, EntityComponentTypes::info(types_[i]).size);
+    }
+    return { uint32_t(chunks_.size() - 1), row };
+}
+
+
+// 行を外す。最後のチャンクの最後の行を穴に移して詰める
+Entity EntityArchetype::removeRow(uint32_t chunkIndex, uint32_t row)
+{
+    const uint32_t lastChunkIndex = uint32_t(chunks_.size() - 1);
+    EntityChunk& last = *chunks_[lastChunkIndex];
+    const uint32_t lastRow = last.count_ - 1;
+
+    Entity moved;
+    if (chunkIndex != lastChunkIndex || row != lastRow)
+    {
+        for (size_t i = 0; i < types_.size(); ++i)
+        {
+            std::memcpy(cell(chunkIndex, row, i), cell(lastChunkIndex, lastRow, i), EntityComponentTypes::info(types_[i]).size);
+        }
+        moved = last.mutableEntities()[lastRow];
+        chunks_[chunkIndex]->mutableEntities()[row] = moved;
+    }
+
+    // 空になったチャンクは返す
+    if (--last.count_ == 0)
+    {
+        chunks_.pop_back();
+    }
+    return moved;
+}
+
+
+// -----------------------------------------------------------------------------
+// EntityManager
+// -----------------------------------------------------------------------------
+EntityManager::EntityManager()
+{
+}
+
+
+EntityManager::~EntityManager()
+{
+}
+
+
+bool EntityManager::Exists(Entity entity) const
+{
+    return entity.index < records_.size()
+        && records_[entity.index].archetype != nullptr
+        && records_[entity.index].generation == entity.generation;
+}
+
+
+Entity EntityManager::createEntity(uint64_t mask)
+{
+    assert(iterating_ == 0 && "クエリの最中にエンティティを作れません");
+
+    uint32_t index;
+    if (!freeIndices_.empty())
+    {
+        index = freeIndices_.back();
+        freeIndices_.pop_back();
+    }
+    else
+    {
+        index = uint32_t(records_.size());
+        records_.emplace_back();
+    }
+
+    Entity entity{ index, records_[index].generation };
+    placeRow(entity, getArchetype(mask));
+    return entity;
+}
+
+
+void EntityManager::DestroyEntity(Entity entity)
+{
+    assert(iterating_ == 0 && "クエリの最中にエンティティを削除できません");
+    if (!Exists(entity)) return;
+
+    Record& record = records_[entity.index];
+    removeRow(record);
+    record.archetype = nullptr;
+    ++record.generation; // 古いハンドルを無効にする
+    freeIndices_.push_back(entity.index);
+}
+
+
+EntityArchetype* EntityManager::getArchetype(uint64_t mask)
+{
+    auto it = archetypes_.find(mask);
+    if (it != archetypes_.end()) return it->second.get();
+
+    auto archetype = std::make_unique<EntityArchetype>(mask);
+    EntityArchetype* result = archetype.get();
+    archetypes_.emplace(mask, std::move(archetype));
+    archetypeList_.push_back(result);
+    return result;
+}
+
+
+// 別のアーキタイプに移す。共通のコンポーネントはコピーする
+void EntityManager::moveToArchetype(Entity entity, uint64_t mask)
+{
+    assert(iterating_ == 0 && "クエリの最中にコンポーネントを追加・削除できません");
+    assert(Exists(entity));
+
+    const Record from = records_[entity.index];
+    if (from.archetype->mask() == mask) return;
+
+    EntityArchetype* to = getArchetype(mask);
+    placeRow(entity, to);
+
+    const Record& dest = records_[entity.index];
+    for (size_t i = 0; i < to->types_.size(); ++i)
+    {
+        const int src = from.archetype->columnOf_[to->types_[i]];
+        if (src < 0) continue;
+        std::memcpy(to->cell(dest.chunk, dest.row, i),
+            from.archetype->cell(from.chunk, from.row, size_t(src)),
+            EntityComponentTypes::info(to->types_[i]).size);
+    }
+    removeRow(from);
+}
+
+
+void EntityManager::placeRow(Entity entity, EntityArchetype* archetype)
+{
+    auto [chunk, row] = archetype->allocateRow(entity);
+    Record& record = records_[entity.index];
+    record.archetype = archetype;
+    record.chunk = chunk;
+    record.row = row;
+}
+
+
+void EntityManager::removeRow(const Record& record)
+{
+    Entity moved = record.archetype->removeRow(record.chunk, record.row);
+    if (moved.isValid())
+    {
+        records_[moved.index].chunk = record.chunk;
+        records_[moved.index].row = record.row;
+    }
+}
+
+
+// 登録順にシステムを実行
+void EntityManager::update()
+{
+    for (auto& system : systems_)
+    {
+        system->OnUpdate(*this);
+    }
+}
+
+}
@@ -0,0 +1,119 @@
+﻿#include "pch.h"
+#include <UniDx/EntityBridge.h>
+
+#include <UniDx/Renderer.h>
+#include <UniDx/Rigidbody.h>
+
+
+namespace UniDx{
+
+namespace
+{
+    LocalTransformData readTransform(Transform* t)
+    {
+        return LocalTransformData{ t->localPosition, t->localRotation, t->localScale };
+    }
+
+    RigidbodyData readRigidbody(Rigidbody* rb)
+    {
+        return RigidbodyData{ rb->linearVelocity, rb->gravityScale, rb->mass };
+    }
+
+    // 破棄待ちのコンポーネントは読み書きしない
+    template<typename T>
+    T* findLive(GameObject* gameObject)
+    {
+        T* component = gameObject->GetComponent<T>(true);
+        return component != nullptr && !component->isDestroyed() ? component : nullptr;
+    }
+
+    // POD同士のビット比較（書き戻しを変わったものだけにする）
+    template<typename T>
+    bool sameBits(const T& a, const T& b)
+    {
+        return std::memcmp(&a, &b, sizeof(T)) == 0;
+    }
+}
+
+
+void EntityBridge::createEntity()
+{
+    auto* entities = EntityManager::getInstance();
+    if (entities == nullptr || entity_.isValid() || isDormant()) return;
+
+    entity_ = entities->CreateEntity(GameObjectLink{ gameObject }, readTransform(transform));
+    if (auto* rb = gameObject->GetComponent<Rigidbody>(true))
+    {
+        entities->AddComponent(entity_, readRigidbody(rb));
+    }
+    if (auto* mr = gameObject->GetComponent<MeshRenderer>(true))
+    {
+        entities->AddComponent(entity_, MeshRendererData{ bool(mr->enabled) });
+    }
+}
+
+
+void EntityBridge::destroyEntity()
+{
+    if (auto* entities = EntityManager::getInstance())
+    {
+        entities->DestroyEntity(entity_);
+    }
+    entity_ = Entity();
+}
+
+
+void EntityBridge::setDormant(bool value)
+{
+    Component::setDormant(value);
+    if (value)
+    {
+        destroyEntity();
+    }
+    else if (enabled)
+    {
+        createEntity();
+    }
+}
+
+
+// GameObject -> チャンク
+void EntityBridge::pullFromGameObjects(EntityManager& entities)
+{
+    entities.ForEach<const GameObjectLink, LocalTransformData>([](const GameObjectLink& link, LocalTransformData& t) {
+        t = readTransform(link.gameObject->transform);
+    });
+    entities.ForEach<const GameObjectLink, RigidbodyData>([](const GameObjectLink& link, RigidbodyData& data) {
+        if (Rigidbody* rb = findLive<Rigidbody>(link.gameObject)) data = readRigidbody(rb);
+    });
+    entities.ForEach<const GameObjectLink, MeshRendererData>([](const GameObjectLink& link, MeshRendererData& data) {
+        if (MeshRenderer* mr = findLive<MeshRenderer>(link.gameObject)) data.enabled = mr->enabled;
+    });
+}
+
+
+// チャンク -> GameObject
+void EntityBridge::pushToGameObjects(EntityManager& entities)
+{
+    entities.ForEach<const GameObjectLink, const LocalTransformData>([](const GameObjectLink& link, const LocalTransformData& t) {
+        Transform* transform = link.gameObject->transform;
+        const LocalTransformData current = readTransform(transform);
+        if (!sameBits(current.position, t.position)) transform->localPosition = t.position;
+        if (!sameBits(current.rotation, t.rotation)) transform->localRotation = t.rotation;
+        if (!sameBits(current.scale, t.scale)) transform->localScale = t.scale;
+    });
+    entities.ForEach<const GameObjectLink, const RigidbodyData>([](const GameObjectLink& link, const RigidbodyData& data) {
+        Rigidbody* rb = findLive<Rigidbody>(link.gameObject);
+        if (rb == nullptr) return;
+        const RigidbodyData current = readRigidbody(rb);
+        if (!sameBits(current.linearVelocity, data.linearVelocity)) rb->linearVelocity = data.linearVelocity;
+        if (!sameBits(current.gravityScale, data.gravityScale)) rb->gravityScale = data.gravityScale;
+        if (!sameBits(current.mass, data.mass)) rb->mass = data.mass;
+    });
+    entities.ForEach<const GameObjectLink, const MeshRendererData>([](const GameObjectLink& link, const MeshRendererData& data) {
+        MeshRenderer* mr = findLive<MeshRenderer>(link.gameObject);
+        if (mr != nullptr && bool(mr->enabled) != data.enabled) mr->enabled = data.enabled;
+    });
+}
+
+}
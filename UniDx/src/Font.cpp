@@ -3,9 +3,15 @@
 #include <UniDx/Font.h>
 
 #include <filesystem>
-#include <SpriteFont.h>
 #include <UniDx/D3DManager.h>
 
+#if UNIDX_D3D11
+#include <SpriteFont.h>
+#else
+// 読み込まないので中身は要らない。unique_ptr を破棄できるように定義だけ置く
+namespace DirectX { inline namespace DX11 { class SpriteFont {}; } }
+#endif
+
 
 namespace UniDx
 {
@@ -13,12 +19,19 @@ namespace UniDx
 using namespace DirectX;
 
 
-Font::Font() : Object([this]() { return fileName; })
+Font::Font()
 {
 }
 
+Font::~Font() = default;
+
+#if UNIDX_D3D11
+
 bool Font::Load(std::wstring filePath)
 {
+	UNIDX_PROFILE_SCOPE("Asset/Font");
+	if (D3DManager::isHeadless()) return false;
+
 	spriteFont = std::make_unique<DirectX::SpriteFont>(D3DManager::getInstance()->GetDevice().Get(), filePath.c_str());
 	std::filesystem::path path(filePath);
 	fileName = StringId::intern(path.filename().u8string());
@@ -30,4 +43,12 @@ SpriteFont* Font::getSpriteFont() const
 	return spriteFont.get();
 }
 
+#else
+
+// Direct3D のない環境ではフォントを読まない
+bool Font::Load(std::wstring) { return false; }
+SpriteFont* Font::getSpriteFont() const { return nullptr; }
+
+#endif
+
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+﻿#include "pch.h"
+#include <UniDx/FrameArena.h>
+
+#include <algorithm>
+
+
+namespace UniDx{
+
+namespace
+{
+    constexpr size_t BlockAlignment = 64;
+
+    size_t alignUp(size_t value, size_t align)
+    {
+        return (value + align - 1) & ~(align - 1);
+    }
+}
+
+
+FrameArena& FrameArena::current()
+{
+    thread_local FrameArena arena;
+    return arena;
+}
+
+
+FrameArena::FrameArena() :
+    frame_(s_frame.load(std::memory_order_acquire))
+{
+    addBlock(DefaultBlockSize);
+}
+
+
+FrameArena::~FrameArena()
+{
+    for (auto& b : blocks_)
+    {
+        ::operator delete(b.data, std::align_val_t(BlockAlignment));
+    }
+}
+
+
+void FrameArena::addBlock(size_t size)
+{
+    blocks_.push_back(Block{ static_cast<std::byte*>(::operator new(size, std::align_val_t(BlockAlignment))), size });
+    offset_ = 0;
+}
+
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+    // フレームが進んでいれば、前のフレームの分を巻き戻してから確保する
+    const uint64_t frame = s_frame.load(std::memory_order_acquire);
+    if (frame != frame_)
+    {
+        reset();
+        frame_ = frame;
+    }
+
+    Block* block = &blocks_.back();
+    size_t begin = alignUp(offset_, alignment);
+    if (begin + bytes > block->size)
+    {
+        // あふれた分は別のブロックに。次の reset() で1つにまとめる
+        addBlock(std::max(DefaultBlockSize, alignUp(bytes, BlockAlignment) + alignment));
+        block = &blocks_.back();
+        begin = alignUp(offset_, alignment);
+    }
+    offset_ = begin + bytes;
+    used_ += bytes;
+    return block->data + begin;
+}
+
+
+// 巻き戻す。足りなかったフレームの後は、使った分が収まるブロック1つに作り直す
+void FrameArena::reset()
+{
+    if (used_ > highWater_)
+    {
+        highWater_ = used_;
+#ifdef _DEBUG
+        if (blocks_.size() > 1)
+        {
+            Debug::Log(std::string("FrameArena: high-water mark ") + std::to_string(highWater_) + " bytes");
+        }
+#endif
+    }
+
+    if (blocks_.size() > 1)
+    {
+        size_t total = 0;
+        for (auto& b : blocks_)
+        {
+            total += b.size;
+            ::operator delete(b.data, std::align_val_t(BlockAlignment));
+        }
+        blocks_.clear();
+        addBlock(alignUp(total, BlockAlignment));
+    }
+    offset_ = 0;
+    used_ = 0;
+}
+
+
+void FrameArena::resetAll()
+{
+    FrameArena& arena = current();
+    arena.frame_ = s_frame.fetch_add(1, std::memory_order_acq_rel) + 1;
+    arena.reset();
+}
+
+}
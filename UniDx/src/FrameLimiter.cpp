@@ -0,0 +1,188 @@
+﻿#include "pch.h"
+#include <UniDx/FrameLimiter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+
+namespace UniDx{
+
+namespace
+{
+
+// steady_clock と OS のタイマーで実際に待つ
+class SystemFrameClock : public FrameClock
+{
+public:
+    SystemFrameClock()
+    {
+#ifdef _WIN32
+        // Windows 10 1803 以降は 1ms より細かく眠れるタイマーが作れる。作れなければ Sleep で眠る
+        timer_ = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+    }
+
+    virtual ~SystemFrameClock()
+    {
+#ifdef _WIN32
+        if (timer_ != nullptr) CloseHandle(timer_);
+#endif
+    }
+
+    virtual time_point now() override { return std::chrono::steady_clock::now(); }
+
+    virtual void sleepUntil(time_point deadline) override;
+
+    virtual void spin() override
+    {
+#ifdef _WIN32
+        YieldProcessor();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+private:
+    void* timer_ = nullptr;     // 高分解能の待機可能タイマー（作れなければ nullptr）
+};
+
+
+void SystemFrameClock::sleepUntil(time_point deadline)
+{
+    const auto remaining = deadline - now();
+    if (remaining <= duration::zero()) return;
+
+#ifdef _WIN32
+    if (timer_ != nullptr)
+    {
+        // 負の値は今からの相対時間（100ns単位）
+        LARGE_INTEGER dueTime;
+        dueTime.QuadPart = -std::max<LONGLONG>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count() / 100);
+        if (SetWaitableTimerEx(timer_, &dueTime, 0, nullptr, nullptr, nullptr, 0))
+        {
+            WaitForSingleObject(timer_, INFINITE);
+            return;
+        }
+    }
+#endif
+
+    // Sleep は 1ms 単位で、それより長く眠ることがあるので、1ms 手前で起きる
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count() - 1;
+    if (ms > 0) std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+} // namespace
+
+
+FrameLimiter::FrameLimiter(std::unique_ptr<FrameClock> clock) :
+    clock_(clock != nullptr ? std::move(clock) : std::make_unique<SystemFrameClock>())
+{
+    history_.reserve(HistorySize);
+    reset();
+}
+
+
+FrameLimiter::~FrameLimiter() = default;
+
+
+void FrameLimiter::reset()
+{
+    next_ = clock_->now();
+    hasLastWake_ = false;
+    history_.clear();
+    historyCursor_ = 0;
+}
+
+
+void FrameLimiter::waitForNextFrame(bool focused)
+{
+    int rate = vSyncCount > 0 ? 0 : targetFrameRate;
+    if (!focused && unfocusedFrameRate > 0)
+    {
+        rate = rate > 0 ? std::min(rate, unfocusedFrameRate) : unfocusedFrameRate;
+    }
+
+    if (rate <= 0)
+    {
+        // 上限なし。次に上限をかけたときに遅れを取り戻そうとしないように、基準だけ進めておく
+        next_ = clock_->now();
+        hasLastWake_ = false;
+        return;
+    }
+
+    const auto period = std::chrono::duration_cast<FrameClock::duration>(std::chrono::duration<double>(1.0 / rate));
+    next_ += period;
+
+    auto now = clock_->now();
+    if (now >= next_)
+    {
+        // 1フレーム以上遅れたら、まとめて取り戻さずにここから数え直す
+        if (now - next_ > period) next_ = now;
+    }
+    else
+    {
+        UNIDX_PROFILE_SCOPE("PlayerLoop/FrameLimiter");
+
+        const auto margin = std::chrono::duration_cast<FrameClock::duration>(std::chrono::duration<double>(spinMargin));
+        if (next_ - now > margin) clock_->sleepUntil(next_ - margin);
+
+        // 残りは回って待つ
+        while (clock_->now() < next_)
+        {
+            clock_->spin();
+        }
+    }
+
+    const auto wake = clock_->now();
+    if (hasLastWake_)
+    {
+        addSample(std::chrono::duration<double>(wake - lastWake_).count(), 1.0 / rate);
+    }
+    lastWake_ = wake;
+    hasLastWake_ = true;
+}
+
+
+void FrameLimiter::addSample(double interval, double target)
+{
+    if (history_.size() < HistorySize)
+    {
+        history_.push_back({ interval, target });
+    }
+    else
+    {
+        history_[historyCursor_] = { interval, target };
+    }
+    historyCursor_ = (historyCursor_ + 1) % HistorySize;
+}
+
+
+FramePacingStats FrameLimiter::pacingStats() const
+{
+    FramePacingStats stats;
+    if (history_.empty()) return stats;
+
+    std::vector<double> jitter;
+    jitter.reserve(history_.size());
+    double totalInterval = 0.0;
+    double totalJitter = 0.0;
+    for (const Sample& s : history_)
+    {
+        const double j = std::abs(s.interval - s.target);
+        jitter.push_back(j);
+        totalInterval += s.interval;
+        totalJitter += j;
+        if (j > jitterBudget) ++stats.overBudget;
+    }
+    std::sort(jitter.begin(), jitter.end());
+
+    stats.count = history_.size();
+    stats.meanInterval = totalInterval / double(stats.count);
+    stats.meanJitter = totalJitter / double(stats.count);
+    stats.p99Jitter = jitter[std::min(jitter.size() - 1, size_t(0.99 * double(jitter.size() - 1) + 0.5))];
+    stats.maxJitter = jitter.back();
+    return stats;
+}
+
+}
@@ -1,6 +1,11 @@
 ﻿#include "pch.h"
 
 #include <UniDx/Behaviour.h>
+#include <UniDx/Renderer.h>
+#include <UniDx/Collider.h>
+#include <UniDx/Scene.h>
+#include <UniDx/CommandBuffer.h>
+#include <UniDx/PlayerLoop.h>
 
 
 namespace UniDx{
@@ -13,110 +18,238 @@ GameObject::~GameObject()
 	{
 		i->doDestroy(); // 破棄処理
 	}
+
+	// シーンの索引から外す（子は Transform のデストラクタで削除されるときに各自で外れる）
+	if (scene_ != nullptr)
+	{
+		scene_->nameIndex.remove(name_, this);
+		scene_->tagIndex.remove(tag_, this);
+	}
+}
+
+
+// 名前の変更
+void GameObject::SetName(StringId n)
+{
+	if (scene_ != nullptr) scene_->nameIndex.remove(name_, this);
+	name_ = n;
+	if (scene_ != nullptr) scene_->nameIndex.add(name_, this);
+}
+
+
+// タグの変更
+void GameObject::setTag(StringId t)
+{
+	if (scene_ != nullptr) scene_->tagIndex.remove(tag_, this);
+	tag_ = t;
+	if (scene_ != nullptr) scene_->tagIndex.add(tag_, this);
+}
+
+
+// 親（ルートならシーン）から外して削除する
+// 子孫とコンポーネントは先に破棄済みにしておき、OnDestroy() の中から Destroy() されても積み直さない
+void GameObject::destroyImmediate()
+{
+	markDestroyedInHierarchy();
+
+	unique_ptr<GameObject> self;
+	if (transform->parent != nullptr)
+	{
+		self = transform->parent->unlinkChild(transform);
+	}
+	else if (scene_ != nullptr)
+	{
+		self = scene_->removeRootGameObject(this);
+	}
+	// どこにも所有されていなければ、所有者が破棄するまで残す
+
+	self.reset(); // デストラクタでコンポーネントの破棄処理と子の削除
 }
 
 
 // Destroy()が呼ばれたコンポーネントを削除
-// 自身を削除する場合 true
-bool GameObject::checkDestroy()
+void GameObject::removeComponent(Component* component)
+{
+	auto it = std::find_if(components.begin(), components.end(),
+		[component](const unique_ptr<Component>& ptr) { return ptr.get() == component; });
+	if (it == components.end()) return;
+
+	component->doDestroy(); // 破棄処理
+	componentIndex.onRemoved(component); // 索引から外す
+	removePhysicsListener(component);
+	components.erase(it);
+}
+
+
+// 自身と子孫、それらのコンポーネントを破棄済みにする
+void GameObject::markDestroyedInHierarchy()
 {
-	// 自身の削除チェック
-	if (isCalledDestroy && transform->parent != nullptr)
+	isCalledDestroy = true;
+	for (auto& c : components)
 	{
-		transform->SetParent(nullptr);
-		return true;
+		c->isCalledDestroy = true;
 	}
+	for (GameObject* child : transform->getChildGameObjects())
+	{
+		child->markDestroyedInHierarchy();
+	}
+}
 
-	// 子供のオブジェクトについて再帰
-	for(int i = 0; i < transform->getChildGameObjects().size();)
+
+// 自身と子孫の所属シーンを設定
+void GameObject::setSceneInHierarchy(Scene* s)
+{
+	// 構造が変わるので、前後のシーンの階層配列を作り直させる
+	transform->leaveHierarchy();
+	if (s != nullptr) s->GetTransformHierarchy()->invalidate();
+
+	// 名前とタグの索引を移す
+	if (scene_ != s)
 	{
-		auto& o = transform->getChildGameObjects()[i];
-		if (!o->checkDestroy())
+		if (scene_ != nullptr)
+		{
+			scene_->nameIndex.remove(name_, this);
+			scene_->tagIndex.remove(tag_, this);
+		}
+		if (s != nullptr)
 		{
-			++i; // 削除しないとき次
+			s->nameIndex.add(name_, this);
+			s->tagIndex.add(tag_, this);
 		}
 	}
 
-	// Destroyが呼ばれたコンポーネントを削除
-	for (auto it = components.begin(); it != components.end();)
+	const bool sceneChanged = scene_ != s;
+	scene_ = s;
+
+	// 物理ワールドなど、シーンごとのものへの登録を移す
+	if (sceneChanged)
 	{
-		if ((*it) != nullptr && (*it)->isDestroyed())
-		{
-			(*it)->doDestroy(); // 破棄処理
-			it = components.erase(it); // コンポーネントを削除
-		}
-		else
+		for (auto& c : components)
 		{
-			++it;
+			c->onSceneChanged();
 		}
 	}
-	return false;
+
+	for (GameObject* child : transform->getChildGameObjects())
+	{
+		child->setSceneInHierarchy(s);
+	}
 }
 
 
-void GameObject::onTriggerEnter(Collider* other)
+void GameObject::checkAwakeInHierarchy()
 {
-	for (auto& i : components)
+	for (auto& c : components)
 	{
-		Behaviour* b = dynamic_cast<Behaviour*>(i.get());
-		if(b != nullptr) b->OnTriggerEnter(other);
+		c->checkAwake();
+	}
+	for (GameObject* child : transform->getChildGameObjects())
+	{
+		child->checkAwakeInHierarchy();
 	}
 }
 
 
-void GameObject::onTriggerStay(Collider* other)
+// コンポーネントの種類を判定（追加時に1回だけ）
+void GameObject::setComponentKind(Component* component)
 {
-	for (auto& i : components)
+	component->kind_ = 0;
+	if (dynamic_cast<Behaviour*>(component) != nullptr) component->kind_ |= ComponentKind_Behaviour;
+	if (dynamic_cast<Renderer*>(component) != nullptr) component->kind_ |= ComponentKind_Renderer;
+	if (dynamic_cast<Collider*>(component) != nullptr) component->kind_ |= ComponentKind_Collider;
+}
+
+
+// 物理のコールバックを実装していれば受け取り先に登録
+void GameObject::addPhysicsListener(Component* component)
+{
+	if (component->physicsEventMask_ == 0) return;
+	physicsListeners_.push_back(component);
+	physicsEventMask_ |= component->physicsEventMask_;
+}
+
+
+void GameObject::removePhysicsListener(Component* component)
+{
+	if (component->physicsEventMask_ == 0) return;
+	std::erase(physicsListeners_, component);
+	physicsEventMask_ = 0;
+	for (Component* c : physicsListeners_)
 	{
-		Behaviour* b = dynamic_cast<Behaviour*>(i.get());
-		if(b != nullptr) b->OnTriggerStay(other);
+		physicsEventMask_ |= c->physicsEventMask_;
 	}
 }
 
 
-void GameObject::onTriggerExit(Collider* other)
+// コールバックの中でコンポーネントが追加されても続けられるように添字で回す
+template<typename Func>
+void GameObject::dispatchPhysicsEvent(PhysicsEvent event, Func&& func)
 {
-	for (auto& i : components)
+	if ((physicsEventMask_ & event) == 0) return;
+	UNIDX_PROFILE_OBJECT_SCOPE(this, "PhysicsCallback");
+	for (size_t i = 0; i < physicsListeners_.size(); ++i)
 	{
-		Behaviour* b = dynamic_cast<Behaviour*>(i.get());
-		if(b != nullptr) b->OnTriggerExit(other);
+		if (physicsListeners_[i]->physicsEventMask_ & event) func(static_cast<Behaviour*>(physicsListeners_[i]));
 	}
 }
 
 
+void GameObject::onTriggerEnter(Collider* other)
+{
+	dispatchPhysicsEvent(PhysicsEvent_TriggerEnter, [other](Behaviour* b) { b->OnTriggerEnter(other); });
+}
+
+
+void GameObject::onTriggerStay(Collider* other)
+{
+	dispatchPhysicsEvent(PhysicsEvent_TriggerStay, [other](Behaviour* b) { b->OnTriggerStay(other); });
+}
+
+
+void GameObject::onTriggerExit(Collider* other)
+{
+	dispatchPhysicsEvent(PhysicsEvent_TriggerExit, [other](Behaviour* b) { b->OnTriggerExit(other); });
+}
+
+
 void GameObject::onCollisionEnter(const Collision& collision)
 {
-	for (auto& i : components)
-	{
-		Behaviour* b = dynamic_cast<Behaviour*>(i.get());
-		if(b != nullptr) b->OnCollisionEnter(collision);
-	}
+	dispatchPhysicsEvent(PhysicsEvent_CollisionEnter, [&collision](Behaviour* b) { b->OnCollisionEnter(collision); });
 }
 
 
 void GameObject::onCollisionStay(const Collision& collision)
 {
-	for (auto& i : components)
-	{
-		Behaviour* b = dynamic_cast<Behaviour*>(i.get());
-		if(b != nullptr) b->OnCollisionStay(collision);
-	}
+	dispatchPhysicsEvent(PhysicsEvent_CollisionStay, [&collision](Behaviour* b) { b->OnCollisionStay(collision); });
 }
 
 
 void GameObject::onCollisionExit(const Collision& collision)
 {
-	for (auto& i : components)
-	{
-		Behaviour* b = dynamic_cast<Behaviour*>(i.get());
-		if(b != nullptr) b->OnCollisionExit(collision);
-	}
+	dispatchPhysicsEvent(PhysicsEvent_CollisionExit, [&collision](Behaviour* b) { b->OnCollisionExit(collision); });
+}
+
+void GameObject::onControllerColliderHit(const ControllerColliderHit& hit)
+{
+	dispatchPhysicsEvent(PhysicsEvent_ControllerColliderHit, [&hit](Behaviour* b) { b->OnControllerColliderHit(hit); });
 }
 
 void Destroy(GameObject* gameObject)
 {
 	assert(gameObject != nullptr);
+	if (CommandBuffer::isRecording())
+	{
+		// 並列Update中は後回し
+		CommandBuffer::push([gameObject]() { Destroy(gameObject); });
+		return;
+	}
+	if (gameObject->isCalledDestroy) return; // 破棄待ち
+
 	gameObject->isCalledDestroy = true; // フレームの終わりに削除される
+	if (auto* loop = PlayerLoop::getInstance())
+	{
+		loop->enqueueDestroy(gameObject);
+	}
 }
 
 }
@@ -170,6 +170,7 @@ void ReadAccessorU8x4(
 // -----------------------------------------------------------------------------
 bool GltfModel::load_(const char* filePath, bool makeTextureMaterial, std::shared_ptr<Shader> shader)
 {
+    UNIDX_PROFILE_SCOPE("Asset/GltfModel");
     Debug::Log(filePath);
 
     model = make_unique<tinygltf::Model>();
@@ -5,7 +5,7 @@
 #include <UniDx/Canvas.h>
 #include <UniDx/Material.h>
 #include <UniDx/Shader.h>
-#include <UniDx/ConstantBuffer.h>
+#include <UniDx/RenderPacket.h>
 
 using namespace DirectX;
 
@@ -27,7 +27,7 @@ namespace UniDx {
 // コンストラクタ
 Image::Image()
 {
-	mesh = make_unique<SubMesh>();
+	mesh = make_shared<SubMesh>();
 	mesh->topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
 	colors.resize(4, Color(1, 1, 1, 1));
 }
@@ -37,31 +37,25 @@ void Image::OnEnable()
 {
 	UIBehaviour::OnEnable();
 
-	// 行列用の定数バッファ生成
-	D3D11_BUFFER_DESC desc{};
-	desc.ByteWidth = sizeof(ConstantBufferPerObject);
-	desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	desc.CPUAccessFlags = 0;
-	desc.Usage = D3D11_USAGE_DEFAULT;
-	D3DManager::getInstance()->GetDevice()->CreateBuffer(&desc, nullptr, constantBufferPerObject.GetAddressOf());
-
-	mesh->positions = std::span<const Vector3>( static_cast<const Vector3*>(image_positions), std::size(image_positions));
-	mesh->uv = std::span<const Vector2>(static_cast<const Vector2*>(image_uvs), std::size(image_uvs));
+	mesh->positions = std::span<const Vector3>( static_cast<const Vector3*>(&image_positions[0]), std::size(image_positions));
+	mesh->uv = std::span<const Vector2>(static_cast<const Vector2*>(&image_uvs[0]), std::size(image_uvs));
 	mesh->colors = colors;
 }
 
 
-void Image::render(const Matrix4x4& proj) const
+void Image::buildPackets(RenderPacketBuilder& builder) const
 {
-	UIBehaviour::render(proj);
+	UIBehaviour::buildPackets(builder);
 
+	// 頂点バッファはデバイスだけで作れるので、ここ（ゲームスレッド）で作っておく
+	std::shared_ptr<Material> material;
 	if (texture == nullptr)
 	{
 		if (mesh->vertexBuffer == nullptr)
 		{
 			mesh->createBuffer<VertexPC>();
 		}
-		owner->getDefaultMaterial()->bind();
+		material = owner->getDefaultMaterial();
 	}
 	else
 	{
@@ -69,21 +63,16 @@ void Image::render(const Matrix4x4& proj) const
 		{
 			mesh->createBuffer<VertexPTC>();
 		}
-		owner->getDefaultTextureMaterial()->bind();
+		material = owner->getDefaultTextureMaterial();
 	}
 
-	// 定数バッファ
-	ID3D11Buffer* cbs[1] = { constantBufferPerObject.Get() };
-	D3DManager::getInstance()->GetContext()->VSSetConstantBuffers(CB_PerObject, 1, cbs);
+	if (material == nullptr) return; // Canvas::LoadDefaultMaterial() がまだ
 
 	// ─ ワールド行列を位置に合わせて作成
-	ConstantBufferPerObject cb{};
-	cb.world = transform->localToWorldMatrix();
-
-	// 定数バッファ更新
-	D3DManager::getInstance()->GetContext()->UpdateSubresource(constantBufferPerObject.Get(), 0, nullptr, &cb, 0, 0);
+	const uint32_t object = builder.addObject(transform->localToWorldMatrix());
 
-	mesh->render();
+	// 描画スレッドが読み終えるまで、メッシュとマテリアルはフレームに持たせておく
+	builder.addMesh(mesh, object, builder.addMaterial(*material, material), RenderPacketBuilder::None);
 }
 
 }
@@ -3,8 +3,8 @@
 
 namespace UniDx{
 
-std::unique_ptr<DirectX::Keyboard> Input::keyboard;
-DirectX::Keyboard::State Input::nowKeyState;
-DirectX::Keyboard::State Input::prevKeyState;
+std::unique_ptr<Keyboard> Input::keyboard;
+Keyboard::State Input::nowKeyState;
+Keyboard::State Input::prevKeyState;
 
 }
@@ -0,0 +1,253 @@
+﻿#include "pch.h"
+#include <UniDx/InputReplay.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <UniDx/Time.h>
+#include <UniDx/Random.h>
+
+
+namespace UniDx{
+
+namespace
+{
+    constexpr char Magic[4] = { 'U', 'D', 'X', 'I' };
+    constexpr uint32_t Version = 1;
+    constexpr uint32_t KeyStateSize = sizeof(Keyboard::State);
+
+    typedef std::array<uint8_t, KeyStateSize> KeyState;
+
+    struct Frame
+    {
+        KeyState keys{};
+        double deltaTime = 0.0;
+    };
+
+    InputReplay::Mode s_mode = InputReplay::Mode_None;
+    std::vector<Frame> s_frames;
+    size_t s_cursor = 0;            // 再生中のフレーム
+    bool s_finished = false;
+    uint64_t s_seed = 0;
+    std::vector<double> s_measured;
+
+    template<typename T>
+    void writeValue(std::ofstream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    bool readValue(std::ifstream& in, T& value)
+    {
+        return bool(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    double percentile(const std::vector<double>& sorted, double p)
+    {
+        const size_t i = std::min(sorted.size() - 1, size_t(p * double(sorted.size() - 1) + 0.5));
+        return sorted[i];
+    }
+}
+
+
+InputReplay::Mode InputReplay::mode()
+{
+    return s_mode;
+}
+
+
+void InputReplay::StartRecording()
+{
+    s_frames.clear();
+    s_measured.clear();
+    s_seed = Random::defaultSeed();
+    // global() は初回に既定のシードを使うので、列を切り替える前に初期化しておく
+    Random::global().InitState(s_seed);
+    Random::setDefaultSeedSequence(true, s_seed);
+    s_mode = Mode_Recording;
+}
+
+
+bool InputReplay::StopRecording(const u8string& filePath)
+{
+    if (s_mode != Mode_Recording) return false;
+    s_mode = Mode_None;
+
+    std::ofstream out(std::filesystem::path(filePath), std::ios::binary);
+    if (!out)
+    {
+        Debug::Log(u8"InputReplay: " + filePath + u8" を開けません");
+        return false;
+    }
+
+    out.write(Magic, sizeof(Magic));
+    writeValue(out, Version);
+    writeValue(out, KeyStateSize);
+    writeValue(out, s_seed);
+    writeValue(out, Time::fixedDeltaTime);
+    writeValue(out, uint32_t(s_frames.size()));
+
+    // キーは前のフレームから変わったときだけ書く
+    KeyState prev{};
+    for (const Frame& f : s_frames)
+    {
+        writeValue(out, f.deltaTime);
+        const uint8_t changed = f.keys != prev ? 1 : 0;
+        writeValue(out, changed);
+        if (changed) out.write(reinterpret_cast<const char*>(f.keys.data()), KeyStateSize);
+        prev = f.keys;
+    }
+    return bool(out);
+}
+
+
+bool InputReplay::StartReplay(const u8string& filePath)
+{
+    std::ifstream in(std::filesystem::path(filePath), std::ios::binary);
+    char magic[4];
+    uint32_t version = 0, keyStateSize = 0, frameCount = 0;
+    uint64_t seed = 0;
+    float fixedDeltaTime = 0.0f;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, Magic, sizeof(Magic)) != 0
+        || !readValue(in, version) || version != Version
+        || !readValue(in, keyStateSize) || keyStateSize != KeyStateSize
+        || !readValue(in, seed) || !readValue(in, fixedDeltaTime) || !readValue(in, frameCount))
+    {
+        Debug::Log(u8"InputReplay: " + filePath + u8" は入力の記録ではありません");
+        return false;
+    }
+
+    std::vector<Frame> frames(frameCount);
+    KeyState prev{};
+    for (Frame& f : frames)
+    {
+        uint8_t changed = 0;
+        if (!readValue(in, f.deltaTime) || !readValue(in, changed)) return false;
+        if (changed && !in.read(reinterpret_cast<char*>(f.keys.data()), KeyStateSize)) return false;
+        if (!changed) f.keys = prev;
+        prev = f.keys;
+    }
+
+    s_frames = std::move(frames);
+    s_cursor = 0;
+    s_finished = s_frames.empty();
+    s_seed = seed;
+    s_measured.clear();
+    s_measured.reserve(s_frames.size());
+
+    // 記録したときと同じ条件に戻す
+    Random::global().InitState(seed);
+    Random::setDefaultSeedSequence(true, seed);
+    Time::fixedDeltaTime = fixedDeltaTime;
+    s_mode = s_finished ? Mode_None : Mode_Replaying;
+    return true;
+}
+
+
+void InputReplay::StopReplay()
+{
+    if (s_mode == Mode_Replaying) s_mode = Mode_None;
+}
+
+
+bool InputReplay::isReplayFinished()
+{
+    return s_finished;
+}
+
+
+size_t InputReplay::replayFrameCount()
+{
+    return s_frames.size();
+}
+
+
+const std::vector<double>& InputReplay::measuredFrameTimes()
+{
+    return s_measured;
+}
+
+
+FrameTimeStats InputReplay::frameTimeStats()
+{
+    FrameTimeStats stats;
+    if (s_measured.empty()) return stats;
+
+    std::vector<double> sorted = s_measured;
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0.0;
+    for (double t : sorted) total += t;
+
+    stats.count = sorted.size();
+    stats.mean = total / double(sorted.size());
+    stats.p50 = percentile(sorted, 0.50);
+    stats.p95 = percentile(sorted, 0.95);
+    stats.p99 = percentile(sorted, 0.99);
+    stats.max = sorted.back();
+    return stats;
+}
+
+
+bool InputReplay::WriteFrameTimes(const u8string& filePath)
+{
+    std::ofstream out{ std::filesystem::path(filePath) };
+    if (!out) return false;
+
+    out << "frame,seconds\n";
+    char line[64];
+    for (size_t i = 0; i < s_measured.size(); ++i)
+    {
+        std::snprintf(line, sizeof(line), "%zu,%.9f\n", i, s_measured[i]);
+        out << line;
+    }
+    return bool(out);
+}
+
+
+void InputReplay::onInputUpdate(Keyboard::State& state)
+{
+    if (s_mode == Mode_Recording)
+    {
+        Frame& f = s_frames.emplace_back();
+        std::memcpy(f.keys.data(), &state, KeyStateSize);
+    }
+    else if (s_mode == Mode_Replaying)
+    {
+        std::memcpy(&state, s_frames[s_cursor].keys.data(), KeyStateSize);
+    }
+}
+
+
+double InputReplay::onFrameEnd(double deltaTime, double frameTime)
+{
+    if (s_mode == Mode_Recording)
+    {
+        // 記録を始めたのが入力更新の後なら、このフレームは数えない
+        if (s_frames.size() > s_measured.size())
+        {
+            s_frames.back().deltaTime = deltaTime;
+            s_measured.push_back(frameTime);
+        }
+        return deltaTime;
+    }
+    if (s_mode == Mode_Replaying)
+    {
+        s_measured.push_back(frameTime);
+        deltaTime = s_frames[s_cursor].deltaTime;
+        if (++s_cursor == s_frames.size())
+        {
+            // 最後まで再生した。以降は実際のキーボードを読む
+            s_finished = true;
+            s_mode = Mode_None;
+        }
+    }
+    return deltaTime;
+}
+
+}
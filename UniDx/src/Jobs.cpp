@@ -0,0 +1,443 @@
+﻿#include "pch.h"
+#include <UniDx/Jobs.h>
+
+#include <algorithm>
+
+
+namespace UniDx{
+
+namespace
+{
+    // 現在のスレッドのワーカー番号（メインスレッドは 0、ワーカー以外は -1）
+    thread_local int t_workerIndex = -1;
+
+    void lockFlag(std::atomic_flag& flag)
+    {
+        while (flag.test_and_set(std::memory_order_acquire))
+        {
+            while (flag.test(std::memory_order_relaxed)) std::this_thread::yield();
+        }
+    }
+
+    void unlockFlag(std::atomic_flag& flag)
+    {
+        flag.clear(std::memory_order_release);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// WorkQueue (Chase-Lev)
+// -----------------------------------------------------------------------------
+bool Jobs::WorkQueue::push(Job* job)
+{
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    if (b - t >= int64_t(QueueCapacity)) return false; // 満杯
+
+    buffer_[size_t(b) & (QueueCapacity - 1)].store(job, std::memory_order_relaxed);
+    bottom_.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+
+Jobs::Job* Jobs::WorkQueue::pop()
+{
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b)
+    {
+        // 空
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = buffer_[size_t(b) & (QueueCapacity - 1)].load(std::memory_order_relaxed);
+    if (t == b)
+    {
+        // 最後の1つは steal と取り合いになる
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            job = nullptr;
+        }
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+
+Jobs::Job* Jobs::WorkQueue::steal()
+{
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) return nullptr;
+
+    Job* job = buffer_[size_t(t) & (QueueCapacity - 1)].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return nullptr; // 他のスレッドに取られた
+    }
+    return job;
+}
+
+
+// -----------------------------------------------------------------------------
+// Jobs
+// -----------------------------------------------------------------------------
+
+// コンストラクタ。メインスレッドで作成すること
+Jobs::Jobs() :
+    jobs_(std::make_unique<Job[]>(MaxJobs))
+{
+    freeList_.reserve(MaxJobs);
+    for (uint32_t i = MaxJobs; i > 0; --i)
+    {
+        freeList_.push_back(i - 1);
+    }
+
+    unsigned int cores = std::thread::hardware_concurrency();
+    size_t workers = cores > 1 ? cores - 1 : 1;
+
+    // 0 番はメインスレッド
+    t_workerIndex = 0;
+    for (size_t i = 0; i <= workers; ++i)
+    {
+        queues_.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 1; i <= workers; ++i)
+    {
+        threads_.emplace_back(&Jobs::workerMain, this, int(i));
+    }
+}
+
+
+// デストラクタ。ワーカーを止めて合流する
+Jobs::~Jobs()
+{
+    quit_.store(true);
+    wakeCounter_.fetch_add(1);
+    wakeCounter_.notify_all();
+    for (auto& t : threads_)
+    {
+        t.join();
+    }
+    t_workerIndex = -1;
+}
+
+
+int Jobs::currentWorkerIndex()
+{
+    return t_workerIndex;
+}
+
+
+JobHandle Jobs::schedule(Func func, std::span<const JobHandle> dependsOn)
+{
+    Job* job = allocate(func);
+    if (job == nullptr)
+    {
+        // プールが埋まっている。依存先を待ってその場で実行する
+        for (const JobHandle& h : dependsOn) wait(h);
+        if (func) func();
+        return JobHandle{};
+    }
+
+    JobHandle handle{ indexOf(job), job->generation.load(std::memory_order_relaxed) };
+    addDependencies(job, dependsOn);
+    if (submit(job)) wake(1);
+    return handle;
+}
+
+
+JobHandle Jobs::parallelFor(size_t count, size_t batchSize, RangeFunc func, std::span<const JobHandle> dependsOn)
+{
+    if (batchSize == 0) batchSize = 1;
+
+    // 依存先が終わってから実行される親ジョブがバッチを子ジョブとして登録する
+    // 親は子がすべて終わったときに完了する
+    auto body = std::make_shared<RangeFunc>(std::move(func));
+    Func none;
+    Job* root = allocate(none);
+    if (root == nullptr)
+    {
+        // プールが埋まっている。依存先を待ってその場で全範囲を実行する
+        for (const JobHandle& h : dependsOn) wait(h);
+        if (count > 0) (*body)(0, count);
+        return JobHandle{};
+    }
+
+    uint32_t rootIndex = indexOf(root);
+    root->func = [this, body, count, batchSize, rootIndex]() {
+        size_t batches = (count + batchSize - 1) / batchSize;
+        jobs_[rootIndex].unfinished.fetch_add(int32_t(batches), std::memory_order_relaxed);
+        size_t queued = 0;
+        for (size_t i = 0; i < batches; ++i)
+        {
+            size_t begin = i * batchSize;
+            size_t end = std::min(count, begin + batchSize);
+            Func batch = [body, begin, end]() { (*body)(begin, end); };
+            Job* child = allocate(batch);
+            if (child == nullptr)
+            {
+                // 確保できなかったバッチはその場で実行する。親は実行中なのでここで完了はしない
+                batch();
+                jobs_[rootIndex].unfinished.fetch_sub(1, std::memory_order_acq_rel);
+                continue;
+            }
+            child->parent = rootIndex;
+            if (submit(child)) ++queued;
+        }
+        // 積み終えてからまとめて起こす
+        wake(queued);
+    };
+
+    JobHandle handle{ rootIndex, root->generation.load(std::memory_order_relaxed) };
+    addDependencies(root, dependsOn);
+    if (submit(root)) wake(1);
+    return handle;
+}
+
+
+bool Jobs::isCompleted(JobHandle handle) const
+{
+    return jobAt(handle) == nullptr;
+}
+
+
+// 完了するまで他のジョブを実行しながら待つ
+void Jobs::wait(JobHandle handle)
+{
+    while (!isCompleted(handle))
+    {
+        if (Job* job = findJob())
+        {
+            execute(job);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+
+void Jobs::parallelForAndWait(size_t count, size_t batchSize, const RangeFunc& func)
+{
+    Jobs* jobs = getInstance();
+    if (jobs == nullptr || count <= batchSize)
+    {
+        // 分割するほどの量がなければその場で実行
+        if (count > 0) func(0, count);
+        return;
+    }
+    jobs->wait(jobs->parallelFor(count, batchSize, func));
+}
+
+
+// プールからジョブを確保。空きがなければ実行できるジョブを手伝いながら空くのを待つ
+// 実行できるジョブもなければ nullptr を返す。呼び出し側はその場で実行する
+// （待っているジョブがすべて実行中のジョブの後続だと、空くのを待つと抜けられなくなる）
+Jobs::Job* Jobs::allocate(Func& func)
+{
+    uint32_t index = UINT32_MAX;
+    while (true)
+    {
+        {
+            std::lock_guard lock(freeMutex_);
+            if (!freeList_.empty())
+            {
+                index = freeList_.back();
+                freeList_.pop_back();
+            }
+        }
+        if (index != UINT32_MAX) break;
+
+        Job* job = findJob();
+        if (job == nullptr) return nullptr;
+        execute(job);
+    }
+
+    Job* job = &jobs_[index];
+    job->func = std::move(func);
+    job->unfinished.store(1, std::memory_order_relaxed);
+    job->dependencies.store(1, std::memory_order_relaxed); // 依存先を登録し終わるまでのガード
+    job->parent = UINT32_MAX;
+    job->finished = false;
+    job->continuations.clear();
+    return job;
+}
+
+
+void Jobs::release(Job* job)
+{
+    std::lock_guard lock(freeMutex_);
+    freeList_.push_back(indexOf(job));
+}
+
+
+// ハンドルが指すジョブ。完了していれば nullptr
+Jobs::Job* Jobs::jobAt(JobHandle handle) const
+{
+    if (!handle.isValid() || handle.index >= MaxJobs) return nullptr;
+
+    Job* job = &jobs_[handle.index];
+    return job->generation.load(std::memory_order_acquire) == handle.generation ? job : nullptr;
+}
+
+
+// 未完了の依存先の後続として登録
+void Jobs::addDependencies(Job* job, std::span<const JobHandle> dependsOn)
+{
+    for (const JobHandle& h : dependsOn)
+    {
+        if (!h.isValid() || h.index >= MaxJobs) continue;
+
+        Job* dep = &jobs_[h.index];
+        lockFlag(dep->lock);
+        if (dep->generation.load(std::memory_order_acquire) == h.generation && !dep->finished)
+        {
+            dep->continuations.push_back(indexOf(job));
+            job->dependencies.fetch_add(1, std::memory_order_relaxed);
+        }
+        unlockFlag(dep->lock);
+    }
+}
+
+
+// ガードを外し、依存先がなければキューに積む。積んだら true
+// ワーカーを起こすのは呼び出し側がまとめて wake() で行う
+bool Jobs::submit(Job* job)
+{
+    if (job->dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        enqueue(job);
+        return true;
+    }
+    return false;
+}
+
+
+void Jobs::enqueue(Job* job)
+{
+    int index = t_workerIndex;
+    if (index < 0 || size_t(index) >= queues_.size() || !queues_[index]->push(job))
+    {
+        // ワーカー以外のスレッドか、デックが満杯
+        std::lock_guard lock(injectMutex_);
+        injected_.push_back(job);
+        injectedCount_.fetch_add(1, std::memory_order_release);
+    }
+}
+
+
+// 寝ているワーカーを起こす。積んだ数が1つなら1人、複数ならまとめて全員
+void Jobs::wake(size_t count)
+{
+    if (count == 0) return;
+
+    wakeCounter_.fetch_add(1);
+    if (count > 1) wakeCounter_.notify_all();
+    else wakeCounter_.notify_one();
+}
+
+
+// 自分のデック → 外部から登録されたジョブ → 他のスレッドのデックの順に探す
+Jobs::Job* Jobs::findJob()
+{
+    int index = t_workerIndex;
+    if (index >= 0 && size_t(index) < queues_.size())
+    {
+        if (Job* job = queues_[index]->pop()) return job;
+    }
+
+    if (injectedCount_.load(std::memory_order_acquire) > 0)
+    {
+        std::lock_guard lock(injectMutex_);
+        if (!injected_.empty())
+        {
+            Job* job = injected_.back();
+            injected_.pop_back();
+            injectedCount_.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    size_t n = queues_.size();
+    size_t start = index >= 0 ? size_t(index) + 1 : 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t victim = (start + i) % n;
+        if (int(victim) == index) continue;
+        if (Job* job = queues_[victim]->steal()) return job;
+    }
+    return nullptr;
+}
+
+
+void Jobs::execute(Job* job)
+{
+    if (job->func) job->func();
+    finish(job);
+}
+
+
+// 自身と子がすべて終わったら完了させ、後続と親に伝える
+void Jobs::finish(Job* job)
+{
+    if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+    job->func = nullptr; // キャプチャを先に解放する
+
+    std::vector<uint32_t> continuations;
+    lockFlag(job->lock);
+    job->finished = true;
+    continuations.swap(job->continuations);
+    unlockFlag(job->lock);
+
+    uint32_t parent = job->parent;
+
+    // 世代を進めるとハンドルが完了扱いになる
+    job->generation.fetch_add(1, std::memory_order_release);
+    release(job);
+
+    size_t queued = 0;
+    for (uint32_t c : continuations)
+    {
+        if (submit(&jobs_[c])) ++queued;
+    }
+    wake(queued);
+    if (parent != UINT32_MAX)
+    {
+        finish(&jobs_[parent]);
+    }
+}
+
+
+void Jobs::workerMain(int index)
+{
+    t_workerIndex = index;
+    while (!quit_.load())
+    {
+        if (Job* job = findJob())
+        {
+            execute(job);
+            continue;
+        }
+
+        // 眠る前にもう一度探す。その間に積まれていればカウンタが変わっているので wait は即座に戻る
+        uint32_t observed = wakeCounter_.load();
+        if (Job* job = findJob())
+        {
+            execute(job);
+            continue;
+        }
+        if (quit_.load()) break;
+        wakeCounter_.wait(observed);
+    }
+}
+
+}
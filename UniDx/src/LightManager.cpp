@@ -3,7 +3,6 @@
 
 #include <algorithm>
 #include <UniDx/Light.h>
-#include <UniDx/D3DManager.h>
 
 
 namespace UniDx
@@ -52,18 +51,6 @@ LightManager::LightManager()
     // ライトのリザーブ
     pointLights.reserve(PointLightCountMax);
     spotLights.reserve(SpotLightCountMax);
-
-    // 定数バッファ作成
-    D3D11_BUFFER_DESC desc{};
-    desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-    desc.CPUAccessFlags = 0;
-    desc.Usage = D3D11_USAGE_DEFAULT;
-
-    desc.ByteWidth = sizeof(ConstantBufferLightPerFrame);
-    D3DManager::getInstance()->GetDevice()->CreateBuffer(&desc, nullptr, constantBufferLightPerFrame.GetAddressOf());
-
-    desc.ByteWidth = sizeof(ConstantBufferLightPerObject);
-    D3DManager::getInstance()->GetDevice()->CreateBuffer(&desc, nullptr, constantBufferLightPerObject.GetAddressOf());
 }
 
 
@@ -107,8 +94,8 @@ void LightManager::unregisterLight(Light* light)
 }
 
 
-// ライト情報を定数バッファに反映
-void LightManager::updateLightCBuffer()
+// フレーム共通のライト情報の定数バッファの中身を作る
+void LightManager::makeLightsPerFrame(ConstantBufferLightPerFrame& cb)
 {
     // 無効になっているものをvectorから削除
     for (vector<Light*>::iterator it = lights_.begin(); it != lights_.end();)
@@ -123,8 +110,7 @@ void LightManager::updateLightCBuffer()
         }
     }
 
-    // 定数バッファ更新
-    ConstantBufferLightPerFrame cb{};
+    cb = ConstantBufferLightPerFrame{};
     cb.ambientColor = ambientColor;
     cb.directionalColor = Color(0.0f, 0.0f, 0.0f, 0.0f);
     cb.directionW = Vector3::forward;
@@ -140,13 +126,10 @@ void LightManager::updateLightCBuffer()
             cb.directionW = (*it)->transform->forward;
         }
     }
-    D3DManager::getInstance()->GetContext()->UpdateSubresource(constantBufferLightPerFrame.Get(), 0, nullptr, &cb, 0, 0);
-
-    ID3D11Buffer* cbs[1] = { constantBufferLightPerFrame.Get() };
-    D3DManager::getInstance()->GetContext()->PSSetConstantBuffers(CB_LightPerFrame, 1, cbs);
 }
 
-void LightManager::updateLightCBufferObject(Vector3 objPos, int lightCountMax)
+// objPos に影響の大きいライトを選んで、オブジェクトごとのライト情報の定数バッファの中身を作る
+void LightManager::makeLightsPerObject(ConstantBufferLightPerObject& cb, Vector3 objPos, int lightCountMax)
 {
     int pointLightMax = std::clamp(lightCountMax, 0, PointLightCountMax);
     int spotLightMax = std::clamp(lightCountMax, 0, SpotLightCountMax);
@@ -229,16 +212,11 @@ void LightManager::updateLightCBufferObject(Vector3 objPos, int lightCountMax)
         }
     }
 
-    // 定数バッファ更新
-    ConstantBufferLightPerObject cb{};
+    cb = ConstantBufferLightPerObject{};
     cb.pointLightCount = uint32_t(pointLights.size());
     std::copy(pointLights.begin(), pointLights.end(), cb.pointLights);
     cb.spotLightCount = uint32_t(spotLights.size());
     std::copy(spotLights.begin(), spotLights.end(), cb.spotLights);
-    D3DManager::getInstance()->GetContext()->UpdateSubresource(constantBufferLightPerObject.Get(), 0, nullptr, &cb, 0, 0);
-
-    ID3D11Buffer* cbs[1] = { constantBufferLightPerObject.Get() };
-    D3DManager::getInstance()->GetContext()->PSSetConstantBuffers(CB_LightPerObject, 1, cbs);
 }
 
 
@@ -1,6 +1,8 @@
 ﻿#include "pch.h"
 #include <UniDx/Material.h>
 
+#include <cstring>
+
 #include <UniDx/D3DManager.h>
 #include <UniDx/Texture.h>
 #include <UniDx/ConstantBuffer.h>
@@ -8,6 +10,7 @@
 
 namespace UniDx{
 
+#if UNIDX_D3D11
 // BlendMode に対応する D3D11_RENDER_TARGET_BLEND_DESC の定数配列
 namespace
 {
@@ -54,18 +57,15 @@ namespace
     };
     static_assert(std::size(blendModeRTDesc) == 4, "Blend mode mapping size must match BlendMode enum count");
 } // namespace
+#endif
 
 
 // -----------------------------------------------------------------------------
 // コンストラクタ
 // -----------------------------------------------------------------------------
 Material::Material() :
-    Object([this]() { return shader->name; }),
     shader(make_shared<Shader>()),
     color(1, 1, 1, 1),
-    mainTexture(
-        [this]() { return textures.size() > 0 ? textures.front().get() : nullptr; }
-    ),
     depthWrite(D3D11_DEPTH_WRITE_MASK_ALL), // デフォルトは書き込み有効
     ztest(D3D11_COMPARISON_LESS), // デフォルトは小さい値が手前
     cullMode(D3D11_CULL_BACK), // デフォルトは裏面非表示
@@ -125,35 +125,11 @@ bool Material::SetBytes(StringId name, const void* data, uint32_t size)
 
 
 // -----------------------------------------------------------------------------
-// レンダリング用にデバイスへ設定
+// 描画パケット用に定数を確定させる
+// GPUへの転送は描画スレッドがパケットのコピーから行う
 // -----------------------------------------------------------------------------
-bool Material::bind()
+std::span<const uint8_t> Material::prepareConstants()
 {
-    // レンダリングモードが合わない場合は何もしない
-    // レンダーキューを実装していない代わりの実装
-    if (renderingMode != D3DManager::getInstance()->getCurrentRenderingMode())
-    {
-        return false;
-    }
-
-    shader->setToContext();
-    for (auto& tex : textures)
-    {
-        if (tex != nullptr)
-        {
-            tex->bind();
-        }
-    }
-
-    // デプス
-    D3DManager::getInstance()->GetContext()->OMSetDepthStencilState(depthStencilState.Get(), 1);
-
-    // ブレンド
-    D3DManager::getInstance()->GetContext()->OMSetBlendState(blendState.Get(), NULL, 0xffffffff);
-
-    // ラスタライザステート
-    D3DManager::getInstance()->GetContext()->RSSetState(rasterizerState.Get());
-
     // 定数バッファ更新
     if(cbStaging.size() != shader->getCBPerMaterialSize())
     {
@@ -161,22 +137,11 @@ bool Material::bind()
     }
 
     // カラーを設定
-    SetColor(StringId::intern("baseColor"), color);
-
-    if(dirty)
-    {
-        if(cbStaging.size() > 0)
-        {
-            D3DManager::getInstance()->GetContext()->UpdateSubresource(constantBufferPerMaterial.Get(), 0, nullptr, cbStaging.data(), 0, 0);
-        }
-        dirty = false;
-    }
-
-    ID3D11Buffer* cbs[1] = { constantBufferPerMaterial.Get() };
-    D3DManager::getInstance()->GetContext()->VSSetConstantBuffers(CB_PerMaterial, 1, cbs);
-    D3DManager::getInstance()->GetContext()->PSSetConstantBuffers(CB_PerMaterial, 1, cbs);
+    SetColor("baseColor"_sid, color);
 
-    return true;
+    if(!dirty) return {};
+    dirty = false;
+    return cbStaging;
 }
 
 
@@ -194,6 +159,16 @@ void Material::AddTexture(std::shared_ptr<Texture> tex)
 // -----------------------------------------------------------------------------
 void Material::OnEnable()
 {
+    // マテリアル用の定数バッファ生成
+    if(cbStaging.size() != shader->getCBPerMaterialSize())
+    {
+        createConstantBuffer();
+    }
+
+    // ヘッドレスではステートを作らない
+    if (D3DManager::isHeadless()) return;
+
+#if UNIDX_D3D11
     // デプスステート作成
     D3D11_DEPTH_STENCIL_DESC dsDesc = {};
     dsDesc.DepthEnable = TRUE; // 深度テスト有効
@@ -207,17 +182,12 @@ void Material::OnEnable()
     // ブレンドステート作成
     setBlendMode(blendMode);
 
-    // マテリアル用の定数バッファ生成
-    if(cbStaging.size() != shader->getCBPerMaterialSize())
-    {
-        createConstantBuffer();
-    }
-
     // ラスタライザステート
     D3D11_RASTERIZER_DESC desc = {};
     desc.FillMode = D3D11_FILL_SOLID;
     desc.CullMode = cullMode;
     D3DManager::getInstance()->GetDevice()->CreateRasterizerState(&desc, &rasterizerState);
+#endif
 }
 
 
@@ -227,12 +197,14 @@ void Material::createConstantBuffer()
 
     cbStaging.assign(shader->getCBPerMaterialSize(), 0);
 
+#if UNIDX_D3D11
     D3D11_BUFFER_DESC desc{};
     desc.ByteWidth = shader->getCBPerMaterialSize();
     desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
     desc.CPUAccessFlags = 0;
     desc.Usage = D3D11_USAGE_DEFAULT;
-    D3DManager::getInstance()->GetDevice()->CreateBuffer(&desc, nullptr, constantBufferPerMaterial.GetAddressOf());
+    if (!D3DManager::isHeadless()) D3DManager::getInstance()->GetDevice()->CreateBuffer(&desc, nullptr, constantBufferPerMaterial.GetAddressOf());
+#endif
 
     dirty = true;
 }
@@ -243,11 +215,15 @@ void Material::createConstantBuffer()
 // -----------------------------------------------------------------------------
 void Material::setBlendMode(BlendMode e)
 {
+    if (D3DManager::isHeadless()) return;
+
+#if UNIDX_D3D11
     D3D11_BLEND_DESC blendDesc = {};
     blendDesc.AlphaToCoverageEnable = FALSE;
     blendDesc.IndependentBlendEnable = FALSE;
     blendDesc.RenderTarget[0] = blendModeRTDesc[e];
     D3DManager::getInstance()->GetDevice()->CreateBlendState(&blendDesc, &blendState);
+#endif
 }
 
 
@@ -2,11 +2,11 @@
 #include <UniDx/Mesh.h>
 
 #include <UniDx/D3DManager.h>
-#include <UniDx/Material.h>
 #include <UniDx/SkinnedMeshRenderer.h>
 
 namespace UniDx{
 
+#if UNIDX_D3D11
 
 void SubMesh::createVertexBuffer(void* data)
 {
@@ -26,6 +26,7 @@ void SubMesh::createVertexBuffer(void* data)
     D3D11_SUBRESOURCE_DATA initData = { data, byteSize, 0 };	// 書き込むデータ
 
     // 頂点バッファの作成
+    if (D3DManager::isHeadless()) return;
     std::span<VertexSkin> a(static_cast<VertexSkin*>(data), positions.size());
     D3DManager::getInstance()->GetDevice()->CreateBuffer(&vbDesc, &initData, &vertexBuffer);
 }
@@ -49,6 +50,7 @@ void SubMesh::createIndexBuffer()
     D3D11_SUBRESOURCE_DATA initData = { &indices.front(), byteSize, 0};	// 書き込むデータ
 
     // 頂点バッファの作成
+    if (D3DManager::isHeadless()) return;
     D3DManager::getInstance()->GetDevice()->CreateBuffer(&vbDesc, &initData, &indexBuffer);
 }
 
@@ -76,21 +78,13 @@ void SubMesh::render() const
     }
 }
 
+#else
 
-void Mesh::render(std::span<const std::shared_ptr<Material>> materials) const
-{
-    for (int i = 0; i < submesh.size(); ++i)
-    {
-        auto& sub = submesh[i];
-        if (i < materials.size() && materials[i] != nullptr)
-        {
-            if(!materials[i]->bind())
-            {
-                return; // 描画するマテリアルでなければ render を呼ばない
-            }
-        }
-        sub->render();
-    }
-}
+// Direct3D のない環境ではバッファを作らない。頂点は createBuffer() の戻り値で読める
+void SubMesh::createVertexBuffer(void*) {}
+void SubMesh::createIndexBuffer() {}
+void SubMesh::render() const {}
+
+#endif
 
 }
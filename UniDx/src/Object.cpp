@@ -0,0 +1,45 @@
+﻿#include "pch.h"
+#include <UniDx/Object.h>
+
+#include <UniDx/SceneArena.h>
+
+
+namespace UniDx{
+
+namespace
+{
+    // 確保したブロックの先頭に確保元を覚えておく（派生クラスのアラインメントを保つため16バイト）
+    constexpr size_t HeaderSize = 16;
+    constexpr size_t BlockAlignment = 16;
+}
+
+
+// シーンの構築中ならシーンのアリーナから、そうでなければヒープから確保
+void* Object::operator new(size_t size)
+{
+    SceneArena* arena = SceneArena::current();
+    void* block = arena != nullptr
+        ? arena->allocate(size + HeaderSize, BlockAlignment)
+        : ::operator new(size + HeaderSize);
+    *static_cast<SceneArena**>(block) = arena;
+    return static_cast<std::byte*>(block) + HeaderSize;
+}
+
+
+void Object::operator delete(void* p, size_t size)
+{
+    if (p == nullptr) return;
+
+    void* block = static_cast<std::byte*>(p) - HeaderSize;
+    SceneArena* arena = *static_cast<SceneArena**>(block);
+    if (arena != nullptr)
+    {
+        arena->deallocate(block, size + HeaderSize, BlockAlignment);
+    }
+    else
+    {
+        ::operator delete(block, size + HeaderSize);
+    }
+}
+
+}
@@ -0,0 +1,107 @@
+﻿#include "pch.h"
+#include <UniDx/ObjectPool.h>
+
+#include <UniDx/CommandBuffer.h>
+
+
+namespace UniDx{
+
+void ObjectPool::Prewarm(size_t count)
+{
+    while (free_.size() < count)
+    {
+        free_.push_back(create());
+    }
+}
+
+
+GameObject* ObjectPool::Spawn(Vector3 position, Quaternion rotation)
+{
+    assert(!CommandBuffer::isRecording()); // 並列Update中は取り出せない
+
+    GameObject* instance;
+    if (free_.empty())
+    {
+        instance = create();
+    }
+    else
+    {
+        instance = free_.back();
+        free_.pop_back();
+    }
+
+    // 配置してから起こす（Rigidbodyは起きたときの位置から動き出す）
+    instance->transform->position = position;
+    instance->transform->rotation = rotation;
+    setDormantInHierarchy(instance, false);
+    return instance;
+}
+
+
+void ObjectPool::Despawn(GameObject* instance)
+{
+    assert(instance != nullptr && instance->transform->parent == transform);
+    if (CommandBuffer::isRecording())
+    {
+        // 並列Update中は後回し
+        CommandBuffer::push([this, instance]() { Despawn(instance); });
+        return;
+    }
+    if (instance->transform->isDormant()) return; // 戻し済み
+
+    setDormantInHierarchy(instance, true);
+    free_.push_back(instance);
+}
+
+
+void ObjectPool::Release(GameObject* instance)
+{
+    assert(instance != nullptr);
+    Transform* parent = instance->transform->parent;
+    ObjectPool* pool = parent != nullptr ? parent->gameObject->GetComponent<ObjectPool>(true) : nullptr;
+    if (pool != nullptr)
+    {
+        pool->Despawn(instance);
+    }
+    else
+    {
+        Destroy(instance);
+    }
+}
+
+
+// 新しいインスタンスを休眠させた状態で子に加える
+GameObject* ObjectPool::create()
+{
+    assert(factory);
+    assert(gameObject != nullptr); // インスタンスの親になるので、GameObjectに付けてから使う
+    auto object = factory();
+    GameObject* instance = object.get();
+
+    setDormantInHierarchy(instance, true);
+    Transform::SetParent(std::move(object), transform);
+    ++instanceCount_;
+
+    // シーンが動いている間に増やしたときは、ここでAwakeしておく
+    // シーン作成前に作ったものは、シーン作成時のAwakeでまとめて初期化される
+    if (isCalledAwake)
+    {
+        instance->checkAwakeInHierarchy();
+    }
+    return instance;
+}
+
+
+void ObjectPool::setDormantInHierarchy(GameObject* object, bool dormant)
+{
+    for (auto& c : object->GetComponents())
+    {
+        c->setDormant(dormant);
+    }
+    for (GameObject* child : object->transform->getChildGameObjects())
+    {
+        setDormantInHierarchy(child, dormant);
+    }
+}
+
+}
@@ -6,6 +6,9 @@
 
 #include <UniDx/Collider.h>
 #include <UniDx/Rigidbody.h>
+#include <UniDx/Scene.h>
+#include <UniDx/Jobs.h>
+#include <UniDx/Profiler.h>
 #include <PhysicsGrid.h>
 
 #define UNIDX_PHYSICS_USE_GRID true
@@ -19,12 +22,23 @@ namespace UniDx
     void PhysicsShape::initialize(Collider* collider)
     {
         collider_ = collider;
+        actor = nullptr;    // 空いた要素を使い回すときに前のコライダーのものを残さない
         // moveBounds
     }
 
-    // 衝突対象の新旧を調べて OnTrigger～, OnCollidion～ を呼ぶ
-    void PhysicsShape::collideCallback()
+    // 衝突対象の新旧を調べて OnTrigger～, OnCollidion～ のイベントを events に積む
+    // ここではコールバックを呼ばないので、途中でコライダーが無効になることはない
+    void PhysicsShape::collectEvents(std::vector<PhysicsEventRecord>& events)
     {
+        Collider* self = getCollider();
+        const GameObject* gameObject = self->gameObject;
+
+        // 受け取るBehaviourがいないイベントは積まない
+        auto add = [&events, self, gameObject](PhysicsEvent type, const Collision& collision)
+        {
+            if(gameObject->hasPhysicsListener(type)) events.push_back({ type, self, collision });
+        };
+
         // トリガーコールバック
         for(auto other : triggersNew_)
         {
@@ -32,8 +46,7 @@ namespace UniDx
             if(inOld == triggers_.end())
             {
                 // 以前のリストに含まれていない＝新規
-                getCollider()->gameObject->onTriggerEnter(other);
-                if(!isValid()) return;
+                add(PhysicsEvent_TriggerEnter, Collision{ other });
             }
             else
             {
@@ -42,15 +55,13 @@ namespace UniDx
             }
 
             // 新しいほうに含まれているので、Stay
-            getCollider()->gameObject->onTriggerStay(other);
-            if(!isValid()) return;
+            add(PhysicsEvent_TriggerStay, Collision{ other });
         }
 
         // 新しいリストになくて古いほうに残っている=離れた
         for(auto other : triggers_)
         {
-            getCollider()->gameObject->onTriggerExit(other);
-            if(!isValid()) return;
+            add(PhysicsEvent_TriggerExit, Collision{ other });
         }
 
         // 古いほうを削除して新しいほうを古いほうに
@@ -64,8 +75,7 @@ namespace UniDx
             if(inOld == collisions_.end())
             {
                 // 以前のリストに含まれていない＝新規
-                getCollider()->gameObject->onCollisionEnter(collision);
-                if(!isValid()) return;
+                add(PhysicsEvent_CollisionEnter, collision);
             }
             else
             {
@@ -74,15 +84,13 @@ namespace UniDx
             }
 
             // 新しいほうに含まれているので、Stay
-            getCollider()->gameObject->onCollisionStay(collision);
-            if(!isValid()) return;
+            add(PhysicsEvent_CollisionStay, collision);
         }
 
         // 新しいリストになくて古いほうに残っている=離れた
-        for(auto col : collisions_)
+        for(const auto& col : collisions_)
         {
-            getCollider()->gameObject->onCollisionExit(col);
-            if(!isValid()) return;
+            add(PhysicsEvent_CollisionExit, col);
         }
 
         // 古いほうを削除して新しいほうを古いほうに
@@ -103,6 +111,11 @@ namespace UniDx
 
     }
 
+    // デストラクタ（PhysicsGridの完全型が必要なためここで定義）
+    Physics::~Physics()
+    {
+    }
+
     // Rigidbodyを登録
     void Physics::registerRigidbody(Rigidbody* rigidbody)
     {
@@ -126,6 +139,8 @@ namespace UniDx
             if(!physicsShapes[i].isValid())
             {
                 physicsShapes[i].initialize(collider);
+                shapeOrderDirty = true;
+                gridValid = false;
                 return;
             }
             if(physicsShapes[i].getCollider() == collider)
@@ -137,6 +152,8 @@ namespace UniDx
         // 無効化されたものがなければ追加
         physicsShapes.push_back(PhysicsShape());
         physicsShapes.back().initialize(collider);
+        shapeOrderDirty = true;
+        gridValid = false;  // 再確保でグリッドのポインタが無効になる
     }
 
 
@@ -176,6 +193,7 @@ namespace UniDx
             if(!it->isValid())
             {
                 it = physicsShapes.erase(it);
+                shapeOrderDirty = true;
             }
             else
             {
@@ -183,15 +201,30 @@ namespace UniDx
             }
         }
 
+        // 休眠中のシェイプを後ろに寄せ、先頭の activeShapeCount 個だけを計算に使う
+        // 休眠中は接触していないことにして、起きたときに Enter から呼び直す
+        if(shapeOrderDirty)
+        {
+            auto mid = std::stable_partition(physicsShapes.begin(), physicsShapes.end(),
+                [](const PhysicsShape& shape) { return !shape.getCollider()->isDormant(); });
+            activeShapeCount = size_t(mid - physicsShapes.begin());
+            for(; mid != physicsShapes.end(); ++mid)
+            {
+                mid->clearContacts();
+            }
+            shapeOrderDirty = false;
+        }
+
         // Rigidbodyの更新
         for(auto& act : physicsActors)
         {
+            if(act.second.getRigidbody()->isDormant()) continue;
             act.second.getRigidbody()->physicsUpdate();
             act.second.initCorrectBounds();
         }
 
         // Shapeの移動Boundsと次に当たるコライダーを初期化
-        for(auto& shape : physicsShapes)
+        for(auto& shape : activeShapes())
         {
             shape.initOtherNew();
 
@@ -222,91 +255,170 @@ namespace UniDx
     // 位置補正法（射影法）による物理計算のシミュレート
     void Physics::simulatePositionCorrection(float step)
     {
-        auto start = std::chrono::system_clock::now(); // 開始時刻を記録
+        simulateStep(step);
+        dispatchEvents();
+    }
 
-        initializeSimulate(step);
+    // 1ステップ分の計算。コールバックは呼ばずに events に集める
+    void Physics::simulateStep(float step)
+    {
+        UNIDX_PROFILE_SCOPE("Physics/Step");
 
-        static double totalTime = 0.0;
-        static double totalInsert = 0.0;
-        static int timeCount = 0;
+        {
+            UNIDX_PROFILE_SCOPE("Physics/Initialize");
+            initializeSimulate(step);
+        }
 
         // まずは当たりそうなペアをAABBで判定して抽出
         potentialPairs.clear();
         potentialPairsTrigger.clear();
 
 #if UNIDX_PHYSICS_USE_GRID
-        physicsGrid->update(physicsShapes);
-        auto insert = std::chrono::system_clock::now(); // 終了時刻を記録
-        totalInsert += std::chrono::duration_cast<std::chrono::microseconds>(insert - start).count() * 0.001;
-        physicsGrid->gatherPairs();
+        {
+            UNIDX_PROFILE_SCOPE("Physics/Broadphase/Insert");
+            physicsGrid->update(activeShapes());
+            gridValid = true;
+        }
+        {
+            UNIDX_PROFILE_SCOPE("Physics/Broadphase/Pairs");
+            physicsGrid->gatherPairs();
+        }
 #else
-        for(size_t i = 0; i < physicsShapes.size(); ++i)
         {
-            for(size_t j = i + 1; j < physicsShapes.size(); ++j)
+            UNIDX_PROFILE_SCOPE("Physics/Broadphase");
+            for(size_t i = 0; i < activeShapeCount; ++i)
             {
-                checkBounds(&physicsShapes[i], &physicsShapes[j]);
+                for(size_t j = i + 1; j < activeShapeCount; ++j)
+                {
+                    checkBounds(&physicsShapes[i], &physicsShapes[j]);
+                }
             }
         }
 #endif
-        auto end = std::chrono::system_clock::now(); // 終了時刻を記録
-        std::chrono::microseconds elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-        totalTime += elapsed.count() * 0.001;
-        timeCount++;
-        if(timeCount % 100 == 0)
-        {
-            //            Debug::Log(totalInsert);
-            //            Debug::Log(totalTime);
-            totalInsert = 0.0;
-            totalTime = 0.0;
-            timeCount = 0;
-        }
 
-        // 先に位置を更新する
-        for(auto& act : physicsActors)
         {
-            act.second.getRigidbody()->applyMove(step);
-        }
+            UNIDX_PROFILE_SCOPE("Physics/Narrowphase");
+            // 先に位置を更新する
+            for(auto& act : physicsActors)
+            {
+                if(act.second.getRigidbody()->isDormant()) continue;
+                act.second.getRigidbody()->applyMove(step);
+            }
 
-        // トリガーチェックする
-        for(auto& pair : potentialPairsTrigger)
-        {
-            if(pair.first->getCollider()->intersects(pair.second->getCollider()))
+            // トリガーチェックする
+            // 判定は読み取りだけなのでジョブで並列に行い、結果の登録はまとめて行う
+            // 並列中にTransformの遅延更新が走らないよう、先に行列を確定させておく
+            for(auto& shape : activeShapes())
             {
-                pair.first->addTrigger(pair.second->getCollider());
-                pair.second->addTrigger(pair.first->getCollider());
+                shape.getCollider()->transform->localToWorldMatrix();
+            }
+            triggerHits.assign(potentialPairsTrigger.size(), 0);
+            Jobs::parallelForAndWait(potentialPairsTrigger.size(), 64, [this](size_t begin, size_t end) {
+                for(size_t i = begin; i < end; ++i)
+                {
+                    auto& pair = potentialPairsTrigger[i];
+                    triggerHits[i] = pair.first->getCollider()->intersects(pair.second->getCollider()) ? 1 : 0;
+                }
+            });
+            for(size_t i = 0; i < potentialPairsTrigger.size(); ++i)
+            {
+                if(triggerHits[i])
+                {
+                    auto& pair = potentialPairsTrigger[i];
+                    pair.first->addTrigger(pair.second->getCollider());
+                    pair.second->addTrigger(pair.first->getCollider());
+                }
             }
-        }
 
-        // 衝突をチェックする
-        for(auto& pair : potentialPairs)
-        {
-            if(pair.first->getCollider()->checkIntersect(pair.second->getCollider(), pair.first->actor, pair.second->actor))
+            // 衝突をチェックする
+            for(auto& pair : potentialPairs)
             {
-                Collision ca;
-                ca.collider = pair.second->getCollider();
-                pair.first->addCollide(ca);
+                if(pair.first->getCollider()->checkIntersect(pair.second->getCollider(), pair.first->actor, pair.second->actor))
+                {
+                    Collision ca;
+                    ca.collider = pair.second->getCollider();
+                    pair.first->addCollide(ca);
 
-                Collision cb;
-                cb.collider = pair.first->getCollider();
-                pair.second->addCollide(cb);
+                    Collision cb;
+                    cb.collider = pair.first->getCollider();
+                    pair.second->addCollide(cb);
+                }
             }
         }
 
-        // 衝突で生じた補正を含めて位置と速度を解決する
-        for(auto& act : physicsActors)
         {
-            act.second.getRigidbody()->solveCorrection(act.second.getCorrectPositionBounds(), act.second.getCorrectVelocityBounds());
+            UNIDX_PROFILE_SCOPE("Physics/Solve");
+            // 衝突で生じた補正を含めて位置と速度を解決する
+            for(auto& act : physicsActors)
+            {
+                if(act.second.getRigidbody()->isDormant()) continue;
+                act.second.getRigidbody()->solveCorrection(act.second.getCorrectPositionBounds(), act.second.getCorrectVelocityBounds());
+            }
         }
 
-        // OnTrigger～, OnCollision～等のコールバックを呼び出す
+        // OnTrigger～, OnCollision～等のイベントを集める
         // TODO: 当たったRigidbodyがついているGameObjectでも呼び出す
-        for(auto& shape : physicsShapes)
+        UNIDX_PROFILE_SCOPE("Physics/CollectEvents");
+        events.clear();
+        for(auto& shape : activeShapes())
         {
             if(shape.isValid())
             {
-                shape.collideCallback();
+                shape.collectEvents(events);
+            }
+        }
+    }
+
+    // 集めたイベントのコールバックをまとめて呼ぶ
+    // コールバックの中で無効化・破棄されたコライダーには、残りのイベントを送らない
+    void Physics::dispatchEvents()
+    {
+        UNIDX_PROFILE_SCOPE("Physics/Events");
+        // 先に配ったコールバックで無効にされたり破棄されたりしたコライダーは、受け取る側でも相手側でも飛ばす
+        auto isValid = [](const Collider* c) {
+            return c != nullptr && c->enabled && !c->isDestroyed();
+        };
+
+        for(const auto& e : events)
+        {
+            if(!isValid(e.collider) || !isValid(e.collision.collider)) continue;
+
+            GameObject* gameObject = e.collider->gameObject;
+            switch(e.type)
+            {
+            case PhysicsEvent_TriggerEnter: gameObject->onTriggerEnter(e.collision.collider); break;
+            case PhysicsEvent_TriggerStay: gameObject->onTriggerStay(e.collision.collider); break;
+            case PhysicsEvent_TriggerExit: gameObject->onTriggerExit(e.collision.collider); break;
+            case PhysicsEvent_CollisionEnter: gameObject->onCollisionEnter(e.collision); break;
+            case PhysicsEvent_CollisionStay: gameObject->onCollisionStay(e.collision); break;
+            case PhysicsEvent_CollisionExit: gameObject->onCollisionExit(e.collision); break;
+            default: break;
             }
         }
+        events.clear();
+    }
+
+    // 複数のワールドを並列にステップする
+    // ワールド間で共有する可変状態はないので、ワールド単位でそのまま分割できる
+    void Physics::simulateWorlds(std::span<Physics* const> worlds, float step)
+    {
+        Jobs::parallelForAndWait(worlds.size(), 1, [worlds, step](size_t begin, size_t end) {
+            for(size_t i = begin; i < end; ++i)
+            {
+                worlds[i]->simulateStep(step);
+            }
+        });
+        for(Physics* world : worlds)
+        {
+            world->dispatchEvents();
+        }
+    }
+
+    // GameObjectが属するシーンの物理ワールド
+    Physics* Physics::of(const GameObject* gameObject)
+    {
+        Scene* scene = gameObject != nullptr ? gameObject->scene() : nullptr;
+        return scene != nullptr ? scene->GetPhysicsScene() : nullptr;
     }
 
     void Physics::checkBounds(PhysicsShape* shape1, PhysicsShape* shape2)
@@ -418,7 +530,7 @@ namespace UniDx
         // 各 Collider の実装された Raycast を呼ぶ（Collider 側で始点内部は除外される）
         for(const auto& shape : physicsShapes)
         {
-            if(!shape.isValid()) continue;
+            if(!shape.isValid() || shape.getCollider()->isDormant()) continue;
             Collider* col = shape.getCollider();
             if(!col) continue;
 
@@ -443,4 +555,87 @@ namespace UniDx
         return hitAny;
     }
 
+    // bounds の近くにある有効なシェイプに func(PhysicsShape&) を呼ぶ
+    // 前回のステップのグリッドが使えればそれで絞り込み、登録が変わった後はすべてを調べる
+    template<typename Func>
+    void Physics::forEachShapeNear(const Bounds& bounds, Func&& func)
+    {
+#if UNIDX_PHYSICS_USE_GRID
+        if(gridValid)
+        {
+            physicsGrid->query(bounds, [&](PhysicsShape* shape) { func(*shape); });
+            return;
+        }
+#endif
+        for(auto& shape : physicsShapes)
+        {
+            func(shape);
+        }
+    }
+
+    // SphereCast
+    bool Physics::SphereCast(Vector3 origin, float radius, Vector3 direction, float maxDistance,
+        RaycastHit* hitInfo, std::function<bool(const Collider*)> filter)
+    {
+        const float eps = 1e-6f;
+        if(maxDistance <= 0.0f) return false;
+        float len = direction.magnitude();
+        if(len < eps) return false;
+        direction /= len;
+
+        // 移動範囲全体の境界で先に絞り込む
+        Bounds sweepBounds(origin, Vector3(radius, radius, radius));
+        sweepBounds.Encapsulate(Bounds(origin + direction * maxDistance, Vector3(radius, radius, radius)));
+
+        bool hitAny = false;
+        float bestT = maxDistance;
+        forEachShapeNear(sweepBounds, [&](const PhysicsShape& shape)
+        {
+            if(!shape.isValid() || shape.getCollider()->isDormant()) return;
+            Collider* col = shape.getCollider();
+            if(filter && !filter(col)) return;
+
+            Bounds b = col->getBounds();
+            b.extents = Vector3(std::abs(b.extents.x), std::abs(b.extents.y), std::abs(b.extents.z));
+            if(!b.Intersects(sweepBounds)) return;
+
+            RaycastHit localHit;
+            if(col->SphereCast(origin, radius, direction, bestT, &localHit) && localHit.distance <= bestT)
+            {
+                bestT = localHit.distance;
+                if(hitInfo != nullptr)
+                {
+                    *hitInfo = localHit;
+                }
+                hitAny = true;
+            }
+        });
+        return hitAny;
+    }
+
+    // OverlapSphere
+    size_t Physics::OverlapSphere(Vector3 center, float radius, std::vector<Collider*>& results,
+        std::function<bool(const Collider*)> filter)
+    {
+        size_t count = 0;
+        Bounds sphereBounds(center, Vector3(radius, radius, radius));
+        forEachShapeNear(sphereBounds, [&](const PhysicsShape& shape)
+        {
+            if(!shape.isValid() || shape.getCollider()->isDormant()) return;
+            Collider* col = shape.getCollider();
+            if(filter && !filter(col)) return;
+
+            Bounds b = col->getBounds();
+            b.extents = Vector3(std::abs(b.extents.x), std::abs(b.extents.y), std::abs(b.extents.z));
+            if(!b.Intersects(sphereBounds)) return;
+
+            if(SqrDistance(col->ClosestPoint(center), center) <= radius * radius)
+            {
+                results.push_back(col);
+                count++;
+            }
+        });
+        return count;
+    }
+
 } // UniDx
@@ -2,14 +2,26 @@
 #include <UniDx/PlayerLoop.h>
 
 #include <chrono>
+#include <algorithm>
 
 #include <UniDx/D3DManager.h>
 #include <UniDx/SceneManager.h>
 #include <UniDx/Scene.h>
+#include <UniDx/Transform.h>
+#include <UniDx/TransformHierarchy.h>
 #include <UniDx/Renderer.h>
 #include <UniDx/LightManager.h>
 #include <UniDx/Input.h>
+#include <UniDx/InputReplay.h>
+#include <UniDx/FrameLimiter.h>
 #include <UniDx/Canvas.h>
+#include <UniDx/Jobs.h>
+#include <UniDx/CommandBuffer.h>
+#include <UniDx/Entities.h>
+#include <UniDx/FrameArena.h>
+#include <UniDx/EntityBridge.h>
+#include <UniDx/Profiler.h>
+#include <UniDx/RenderPacket.h>
 
 using namespace std;
 using namespace UniDx;
@@ -17,29 +29,42 @@ using namespace UniDx;
 namespace UniDx
 {
 
+// 並列Updateで1つのジョブにまとめるBehaviourの数
+constexpr size_t ParallelUpdateBatchSize = 16;
+
+#if UNIDX_D3D11
 // -----------------------------------------------------------------------------
 //   Initialize(HWND hWnd)
 // -----------------------------------------------------------------------------
 void PlayerLoop::Initialize(HWND hWnd)
 {
+    hWnd_ = hWnd;
+
+    // ジョブシステム作成（ワーカースレッドの起動）
+    Jobs::create();
+
     // Direct3Dインスタンス作成
     D3DManager::create();
 
     // Direct3D初期化
     D3DManager::getInstance()->Initialize(hWnd, 1280, 720);
 
+    // 描画スレッドの開始
+    SetRenderBackend(std::make_unique<D3DRenderBackend>());
+
     // 入力の初期化
     Input::initialize();
 
-    // 物理エンジンのインスタンス作成
-    Physics::create();
-
     // ライトマネージャのインスタンス作成
     LightManager::create();
 
+    // ECSのエンティティマネージャ作成
+    EntityManager::create();
+
     // シーンマネージャのインスタンス作成
     SceneManager::create();
 }
+#endif
 
 
 // -----------------------------------------------------------------------------
@@ -48,6 +73,10 @@ void PlayerLoop::Initialize(HWND hWnd)
 void PlayerLoop::createScene()
 {
     SceneManager::getInstance()->createScene();
+    sceneCreated_ = true;
+
+    // Awake の中で作るものも構築の一部としてシーンのアリーナから確保する
+    SceneArena::Scope scope(SceneManager::getInstance()->GetSceneArena());
 
     // Awake
     for (auto& it : SceneManager::getInstance()->GetActiveScene()->GetRootGameObjects())
@@ -57,6 +86,23 @@ void PlayerLoop::createScene()
 }
 
 
+// -----------------------------------------------------------------------------
+// ヘッドレスの初期化
+// ウィンドウとDirect3Dデバイスを作らない。GPUのリソースを作る処理は D3DManager::isHeadless() を見て何もしない
+// -----------------------------------------------------------------------------
+void PlayerLoop::InitializeHeadless()
+{
+    headless_ = true;
+
+    Jobs::create();
+    Input::initialize();
+    LightManager::create();
+    EntityManager::create();
+    SceneManager::create();
+}
+
+
+#if UNIDX_D3D11
 // -----------------------------------------------------------------------------
 // ゲーム全体のメインループ
 // -----------------------------------------------------------------------------
@@ -65,102 +111,244 @@ int PlayerLoop::MainLoop()
     MSG msg;
 
     Time::Start();
-    double restFixedUpdateTime = 0.0f;
+    restFixedUpdateTime_ = 0.0;
 
     // デフォルトのシーン作成
     createScene();
+    Time::GetClock().reset(); // シーンの構築にかかった時間は最初のフレームに含めない
+    frameLimiter_.reset();
 
     // メイン メッセージ ループ:
-    while (true)
+    bool quit = false;
+    while (!quit)
     {
-        if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+        // Windowsのメッセージ処理
+        // フレームの間隔を空けても入力が遅れないように、溜まっている分をすべて処理する
+        while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
         {
-            // Windowsのメッセージ処理
             // 終了メッセージがきた
             if (msg.message == WM_QUIT) {
+                quit = true;
                 break;
             }
-            else
-            {
-                TranslateMessage(&msg);
-                DispatchMessage(&msg);
-            }
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
         }
+        if (quit) break;
 
-        // 経過時間計測
-        using clock = std::chrono::steady_clock;
-        auto start = clock::now();
+        {
+            // 経過時間計測
+            using clock = std::chrono::steady_clock;
+            auto start = clock::now();
+            UNIDX_PROFILE_SCOPE("PlayerLoop/Frame");
 
-        // 画面を塗りつぶす
-        D3DManager::getInstance()->Clear(0.35f, 0.55f, 0.9f, 1.0f);
+            runFrame();
 
-        Time::SetDeltaTimeFixed(); // Unity同様、FixedUpdate()では deltaTime と fixedDeltaTime が同じ
+            // 時間計算
+            endFrame(std::chrono::duration<double>(clock::now() - start).count());
+        }
 
-        while (restFixedUpdateTime > Time::fixedDeltaTime)
+        // 入力の再生が終わったら抜ける
+        if (InputReplay::isReplayFinished() && InputReplay::quitWhenFinished)
         {
-            // 固定時間更新更新
-            fixedUpdate();
+            msg.wParam = 0;
+            break;
+        }
 
-            // 物理計算
-            physics();
+        // 次のフレームの開始時刻まで待つ
+        frameLimiter_.waitForNextFrame(isFocused());
+    }
 
-            restFixedUpdateTime -= Time::fixedDeltaTime;
-        }
+    // フレームレートに上限をかけていたら、間隔のずれを出す
+    auto pacing = frameLimiter_.pacingStats();
+    if (pacing.count > 0)
+    {
+        Debug::Log(u8"pacing frames " + ToString(pacing.count) + u8" interval " + ToString(pacing.meanInterval * 1000.0) + u8"ms jitter p99 " + ToString(pacing.p99Jitter * 1000.0) + u8"ms max " + ToString(pacing.maxJitter * 1000.0) + u8"ms over budget " + ToString(pacing.overBudget));
+    }
 
-        Time::SetDeltaTimeFrame(); // Update()では deltaTime を経過時間に
+    // 終了処理
+    finalize();
 
-        // 入力更新
-        input();
+    return (int)msg.wParam;
+}
 
-        // 更新処理
-        update();
 
-        // 後更新処理
-        lateUpdate();
+// -----------------------------------------------------------------------------
+// メインループを回して、エンジンを片付ける
+// -----------------------------------------------------------------------------
+int PlayerLoop::Run()
+{
+    int result = getInstance()->MainLoop();
 
-        // 描画処理
-        render();
+    // 静的オブジェクトの破棄に任せると順番が決まらないので、ここで破棄する
+    destroy();
 
-        // 削除チェック
-        checkDestroy();
+    return result;
+}
+#endif
 
-        // バックバッファの内容を画面に表示
-        D3DManager::getInstance()->Present();
 
-        // 時間計算
-        double deltaTime = std::chrono::duration<double>(clock::now() - start).count();
-        restFixedUpdateTime += deltaTime;
+// -----------------------------------------------------------------------------
+// ヘッドレスで frames フレーム進める
+// -----------------------------------------------------------------------------
+void PlayerLoop::StepFrames(int frames)
+{
+    assert(headless_ && "StepFrames() は InitializeHeadless() の後で使う");
 
-        Time::UpdateFrame(deltaTime);
+    if (!sceneCreated_)
+    {
+        Time::Start();
+        restFixedUpdateTime_ = 0.0;
+        createScene();
+        Time::GetClock().reset();
     }
 
-    // 終了処理
+    using clock = std::chrono::steady_clock;
+    for (int i = 0; i < frames; ++i)
+    {
+        auto start = clock::now();
+        UNIDX_PROFILE_SCOPE("PlayerLoop/Frame");
+
+        runFrame();
+
+        // 進める時間は Time のクロックから。実時間のクロックでも待たないので上限なしで回る
+        endFrame(std::chrono::duration<double>(clock::now() - start).count());
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// 描画パケットを受け取るバックエンドの差し替え
+// -----------------------------------------------------------------------------
+void PlayerLoop::SetRenderBackend(std::unique_ptr<RenderBackend> backend)
+{
+    // 古いバックエンドで描画中のフレームを描き終えてから差し替える
+    renderThread_.stop();
+    renderBackend_ = std::move(backend);
+    if (renderBackend_ != nullptr)
+    {
+        renderThread_.start(renderBackend_.get(), multithreadedRendering);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// ヘッドレスの終了処理
+// -----------------------------------------------------------------------------
+void PlayerLoop::Shutdown()
+{
     finalize();
+}
 
-    return (int)msg.wParam;
+
+#if UNIDX_D3D11
+// ウィンドウがアクティブで、最小化されていないか
+bool PlayerLoop::isFocused() const
+{
+    return hWnd_ != nullptr && GetForegroundWindow() == hWnd_ && !IsIconic(hWnd_);
 }
+#endif
 
 
-// 固定時間更新更新
-void PlayerLoop::fixedUpdate()
+// 1フレーム分の更新と描画
+void PlayerLoop::runFrame()
 {
-    for (auto& it : SceneManager::getInstance()->GetActiveScene()->GetRootGameObjects())
+    Time::SetDeltaTimeFixed(); // Unity同様、FixedUpdate()では deltaTime と fixedDeltaTime が同じ
+
+    // 経過時間の足し引きで出る丸め誤差で、ちょうど1ステップ分あるのに回らないことがないよう少し甘く比べる
+    constexpr double FixedStepEpsilon = 1e-6;
+    while (restFixedUpdateTime_ + FixedStepEpsilon >= Time::fixedDeltaTime)
     {
-        fixedUpdate(&*it);
+        // 固定時間更新更新
+        fixedUpdate();
+
+        // 物理計算
+        physics();
+
+        // WaitForFixedUpdate で待っているコルーチン
+        {
+            UNIDX_PROFILE_SCOPE("PlayerLoop/Coroutines/FixedUpdate");
+            coroutines_.resumeFixedUpdate();
+        }
+
+        // 物理で動いたTransformを反映
+        updateTransforms();
+
+        restFixedUpdateTime_ -= Time::fixedDeltaTime;
     }
+
+    Time::SetDeltaTimeFrame(); // Update()では deltaTime を経過時間に
+
+    // 入力更新
+    input();
+
+    // 更新処理
+    update();
+
+    // 後更新処理
+    lateUpdate();
+
+    // 描画前にワールド行列をまとめて更新
+    updateTransforms();
+
+    // 削除チェック（Unity と同じく、Destroy() されたものはそのフレームから描かない）
+    checkDestroy();
+
+    // 描画パケットを作って描画スレッドに渡す。画面の塗りつぶしと表示も描画スレッドで行う
+    render();
+}
+
+
+// クロックから読んだ経過時間を時間に反映して、フレームの作業用メモリを巻き戻す
+// frameTime はこのフレームの処理に実際にかかった時間（計測用）
+void PlayerLoop::endFrame(double frameTime)
+{
+    // 入力の再生中は記録したときの経過時間で進める
+    double deltaTime = InputReplay::onFrameEnd(Time::GetClock().tick(), frameTime);
+
+    restFixedUpdateTime_ += deltaTime;
+
+    Time::UpdateFrame(deltaTime);
+
+    FrameArena::resetAll();
+}
+
+
+// 固定時間更新更新
+void PlayerLoop::fixedUpdate()
+{
+    UNIDX_PROFILE_SCOPE("PlayerLoop/FixedUpdate");
+    updateList(UpdatePhase_FixedUpdate).forEach([](Component* c) {
+        UNIDX_PROFILE_OBJECT_SCOPE(c, "FixedUpdate");
+        static_cast<Behaviour*>(c)->FixedUpdate();
+    });
 }
 
 
 // 物理計算
+// 物理ワールドはシーンごとに持つ
 void PlayerLoop::physics()
 {
-    Physics::getInstance()->simulatePositionCorrection(Time::fixedDeltaTime);
+    UNIDX_PROFILE_SCOPE("PlayerLoop/Physics");
+
+    // シーンのワールドはジョブで並列にステップし、コールバックはこのスレッドで呼ぶ
+    Physics* const worlds[] = { SceneManager::getInstance()->GetActiveScene()->GetPhysicsScene() };
+    Physics::simulateWorlds(worlds, Time::fixedDeltaTime);
+}
+
+
+// Transformのワールド行列を深さ順にまとめて更新
+void PlayerLoop::updateTransforms()
+{
+    UNIDX_PROFILE_SCOPE("PlayerLoop/UpdateTransforms");
+    SceneManager::getInstance()->GetActiveScene()->GetTransformHierarchy()->update();
 }
 
 
 // 入力更新
 void PlayerLoop::input()
 {
+    UNIDX_PROFILE_SCOPE("PlayerLoop/Input");
     Input::update();
 }
 
@@ -168,82 +356,166 @@ void PlayerLoop::input()
 //  更新処理
 void PlayerLoop::update()
 {
-    // 各オブジェクトの Start()
-    for (auto& it : SceneManager::getInstance()->GetActiveScene()->GetRootGameObjects())
+    UNIDX_PROFILE_SCOPE("PlayerLoop/Update");
+
+    // まだ呼んでいない Start()
+    auto& startList = updateList(UpdatePhase_Start);
+    startList.forEach([&startList](Component* c) {
+        UNIDX_PROFILE_OBJECT_SCOPE(c, "Start");
+        c->checkStart();
+        startList.remove(c);
+    });
+
+    // 並列実行できるコンポーネントの Update()
+    auto& parallelList = updateList(UpdatePhase_ParallelUpdate);
+    if (parallelList.size() > 0)
     {
-        checkStart(&*it);
+        // ワーカーから親の行列を遅延更新させないよう、先にワールド行列を確定しておく
+        updateTransforms();
+
+        UNIDX_PROFILE_SCOPE("PlayerLoop/ParallelUpdate");
+        CommandBuffer::begin(Jobs::getInstance()->workerCount());
+        parallelList.parallelForEach(ParallelUpdateBatchSize, [](Component* c, size_t order) {
+            UNIDX_PROFILE_OBJECT_SCOPE(c, "Update");
+            CommandBuffer::setOrder(order);
+            static_cast<Behaviour*>(c)->Update();
+        });
+
+        // 並列中に記録された Destroy/AddComponent などを実行順に反映
+        CommandBuffer::end();
     }
 
-    // 各オブジェクトの Update()
-    for (auto& it : SceneManager::getInstance()->GetActiveScene()->GetRootGameObjects())
+    // 各コンポーネントの Update()
+    updateList(UpdatePhase_Update).forEach([](Component* c) {
+        UNIDX_PROFILE_OBJECT_SCOPE(c, "Update");
+        static_cast<Behaviour*>(c)->Update();
+    });
+
+    // ECSのシステム（ブリッジしたGameObjectの値はチャンクに読み込んでから渡し、後で書き戻す）
+    if (auto* entities = EntityManager::getInstance())
     {
-        update(&*it);
+        UNIDX_PROFILE_SCOPE("PlayerLoop/Entities");
+        EntityBridge::pullFromGameObjects(*entities);
+        entities->update();
+        EntityBridge::pushToGameObjects(*entities);
     }
+
+    // 再開する時になったコルーチン
+    UNIDX_PROFILE_SCOPE("PlayerLoop/Coroutines");
+    coroutines_.resumeFrame();
 }
 
 
 // 後更新処理
 void PlayerLoop::lateUpdate()
 {
+    UNIDX_PROFILE_SCOPE("PlayerLoop/LateUpdate");
+
     // 各コンポーネントの LateUpdate()
-    for (auto& it : SceneManager::getInstance()->GetActiveScene()->GetRootGameObjects())
-    {
-        lateUpdate(&*it);
-    }
+    updateList(UpdatePhase_LateUpdate).forEach([](Component* c) {
+        UNIDX_PROFILE_OBJECT_SCOPE(c, "LateUpdate");
+        static_cast<Behaviour*>(c)->LateUpdate();
+    });
 }
 
 
 // 画面の描画処理
-// Unityのようなレンダーキューには未対応で、全てのGameObjectとComponentを巡回して実行する。
+// Unityのようなレンダーキューには未対応で、有効なRendererを登録順に描画する。
+// ここではD3Dを呼ばず、描画パケットを積んで描画スレッドに渡すだけ
 void PlayerLoop::render()
 {
-    // ライトバッファの更新と転送
-    LightManager::getInstance()->updateLightCBuffer();
+    UNIDX_PROFILE_SCOPE("PlayerLoop/Render");
 
-    Camera* camera = Camera::main;
-    if (camera != nullptr)
+    // 描画先がなければパケットも作らない（ヘッドレスの既定）
+    if (!renderThread_.isRunning()) return;
+
+    // 描画スレッドが読んでいない方のフレームに積む
+    RenderFrame& frame = renderFrames_[renderFrameIndex_];
     {
-        // カメラ単位の定数バッファ更新
-        camera->UpdateConstantBuffer();
+        RenderPacketBuilder builder(frame);
 
-        // 不透明描画
-        D3DManager::getInstance()->setCurrentCurrentRenderingMode(RenderingMode_Opaque);
+        // フレーム共通のライト
+        builder.setLights(*LightManager::getInstance());
 
-        // 各コンポーネントの Render
-        for (auto& it : SceneManager::getInstance()->GetActiveScene()->GetRootGameObjects())
+        Camera* camera = Camera::main;
+        if (camera != nullptr)
         {
-            render(&*it, *camera);
+            // カメラ単位の定数
+            builder.setCamera(*camera);
+
+            // 不透明描画
+            builder.beginPass(RenderPass_Opaque);
+            updateList(UpdatePhase_Render).forEach([&builder](Component* c) {
+                UNIDX_PROFILE_OBJECT_SCOPE(c, "Render");
+                static_cast<Renderer*>(c)->buildPackets(builder);
+            });
+
+            // 半透明描画
+            builder.beginPass(RenderPass_Transparent);
+            updateList(UpdatePhase_Render).forEach([&builder](Component* c) {
+                UNIDX_PROFILE_OBJECT_SCOPE(c, "Render");
+                static_cast<Renderer*>(c)->buildPackets(builder);
+            });
         }
-    
-        // 半透明描画
-        D3DManager::getInstance()->setCurrentCurrentRenderingMode(RenderingMode_Transparent);
 
-        // 各コンポーネントの Render
-        for (auto& it : SceneManager::getInstance()->GetActiveScene()->GetRootGameObjects())
+        // UI
+        builder.beginPass(RenderPass_UI);
+        for (auto& it : canvas_)
         {
-            render(&*it, *camera);
+            it->buildPackets(builder);
         }
     }
 
-    // UI
-    for (auto& it : canvas_)
-    {
-        it->render();
-    }
+    // 前のフレームを描き終えるのを待って渡す。描画は次のフレームの更新と並行して進む
+    renderThread_.submit(frame);
+    renderFrameIndex_ ^= 1;
 }
 
 
-// 後の更新処理
+// 削除待ちのコンポーネントとGameObjectを削除
+// 木全体はなめず、Destroy() で積まれたものだけを処理する
 void PlayerLoop::checkDestroy()
 {
-    // 各コンポーネントの checkDestroy()
-    auto* scene = SceneManager::getInstance()->GetActiveScene();
-    for (int i = 0; i < scene->GetRootGameObjects().size();)
+    UNIDX_PROFILE_SCOPE("PlayerLoop/Destroy");
+
+    if (destroyComponentQueue_.empty() && destroyQueue_.empty()) return;
+
+    // 描画中のフレームが消すものを参照しているかもしれないので、描き終えるのを待つ
+    renderThread_.waitIdle();
+
+    auto depth = [](GameObject* o)
+    {
+        int d = 0;
+        for (Transform* t = o->transform->parent; t != nullptr; t = t->parent) ++d;
+        return d;
+    };
+
+    // OnDestroy() の中で Destroy() されたものは次の周で処理する
+    std::pmr::vector<Component*> components(FrameArena::resource());
+    std::pmr::vector<std::pair<int, GameObject*>> objects(FrameArena::resource());
+    while (!destroyComponentQueue_.empty() || !destroyQueue_.empty())
     {
-        auto& o = scene->GetRootGameObjects()[i];
-        if (! o->checkDestroy())
+        components.assign(destroyComponentQueue_.begin(), destroyComponentQueue_.end());
+        destroyComponentQueue_.clear();
+
+        // 先にコンポーネント（持ち主のGameObjectがまだ生きているうちに）
+        for (auto* c : components)
+        {
+            c->gameObject->removeComponent(c);
+        }
+
+        // 深い方から削除して、親の削除で子のポインタが先に無効にならないようにする
+        objects.clear();
+        for (auto* o : destroyQueue_)
         {
-            ++i; // 削除しないときは次
+            objects.emplace_back(depth(o), o);
+        }
+        destroyQueue_.clear();
+        std::stable_sort(objects.begin(), objects.end(),
+            [](const auto& a, const auto& b) { return a.first > b.first; });
+        for (auto& [d, o] : objects)
+        {
+            o->destroyImmediate();
         }
     }
 }
@@ -252,10 +524,18 @@ void PlayerLoop::checkDestroy()
 // 終了処理
 void PlayerLoop::finalize()
 {
+    // 描画スレッドを止めてから、描画が参照しているものを消す
+    renderThread_.stop();
+    renderBackend_.reset();
+    for (auto& frame : renderFrames_) frame.clear();
+
+    destroyQueue_.clear();
+    destroyComponentQueue_.clear();
     SceneManager::destroy();
+    EntityManager::destroy(); // ブリッジがシーンの破棄中にエンティティを消すので後
     LightManager::destroy();
-    Physics::destroy();
     D3DManager::destroy();
+    Jobs::destroy();
 }
 
 
@@ -268,123 +548,110 @@ void PlayerLoop::awake(GameObject* object)
     }
 
     // 子供のオブジェクトについて再帰
-    for (auto& it : object->transform->getChildGameObjects())
+    for (GameObject* it : object->transform->getChildGameObjects())
     {
-        awake(&*it);
+        awake(it);
     }
 }
 
 
-void PlayerLoop::fixedUpdate(GameObject* object)
+void PlayerLoop::registerCanvas(Canvas* c)
 {
-    // アタッチされている各コンポーネントのFixedUpdateを呼ぶ
-    for (auto& it : object->GetComponents())
-    {
-        auto behaviour = dynamic_cast<Behaviour*>(it.get());
-        if (behaviour != nullptr && behaviour->enabled)
-        {
-            behaviour->FixedUpdate();
-        }
-    }
+    canvas_.push_back(c);
+}
 
-    // 子供のオブジェクトについて再帰
-    for (auto& it : object->transform->getChildGameObjects())
-    {
-        fixedUpdate(&*it);
-    }
+
+void PlayerLoop::unregisterCanvas(Canvas* c)
+{
+    auto it = std::find(canvas_.begin(), canvas_.end(), c);
+    if (it != canvas_.end()) canvas_.erase(it);
 }
 
 
-void PlayerLoop::checkStart(GameObject* object)
+// 有効になったコンポーネントを、実装しているフェーズの実行リストに登録
+void PlayerLoop::registerComponent(Component* c)
 {
-    // 自身のコンポーネントの中でStartを呼び出していないものを呼ぶ
-    for (auto& it : object->GetComponents())
+    if (c->isKindOf(ComponentKind_Behaviour))
     {
-        auto behaviour = dynamic_cast<Behaviour*>(it.get());
-        if (behaviour != nullptr)
+        int order = static_cast<Behaviour*>(c)->executionOrder;
+        if (!c->isCalledStart)
         {
-            behaviour->checkStart();
+            updateList(UpdatePhase_Start).add(c, order);
+        }
+        for (auto phase : { UpdatePhase_FixedUpdate, UpdatePhase_Update, UpdatePhase_ParallelUpdate, UpdatePhase_LateUpdate })
+        {
+            if (c->phaseMask_ & (1 << phase)) updateList(phase).add(c, order);
         }
     }
-
-    // 子供のオブジェクトについて再帰
-    for (auto& it : object->transform->getChildGameObjects())
+    if (c->isKindOf(ComponentKind_Renderer))
     {
-        checkStart(&*it);
+        updateList(UpdatePhase_Render).add(c, 0);
     }
 }
 
 
-void PlayerLoop::update(GameObject* object)
+void PlayerLoop::unregisterComponent(Component* c)
 {
-    // アタッチされている各コンポーネントのUpdateを呼ぶ
-    for (auto& it : object->GetComponents())
-    {
-        auto behaviour = dynamic_cast<Behaviour*>(it.get());
-        if (behaviour != nullptr && behaviour->enabled)
-        {
-            behaviour->Update();
-        }
-    }
-
-    // 子供のオブジェクトについて再帰
-    for (auto& it : object->transform->getChildGameObjects())
+    for (auto& list : updateLists_)
     {
-        update(&*it);
+        list.remove(c);
     }
 }
 
 
-void PlayerLoop::lateUpdate(GameObject* object)
+// -----------------------------------------------------------------------------
+// UpdateList
+// -----------------------------------------------------------------------------
+void UpdateList::add(Component* component, int order)
 {
-    // アタッチされている各コンポーネントのLateUpdateを呼ぶ
-    for (auto& it : object->GetComponents())
-    {
-        auto behaviour = dynamic_cast<Behaviour*>(it.get());
-        if (behaviour != nullptr && behaviour->enabled)
-        {
-            behaviour->LateUpdate();
-        }
-    }
+    if (component->phaseSlots_[phase_] >= 0) return; // 登録済み
 
-    // 子供のオブジェクトについて再帰
-    for (auto& it : object->transform->getChildGameObjects())
+    // 同じ巡回ですでに呼んだものが入り直したら、その巡回では飛ばす
+    uint32_t skipPass = 0;
+    if (cursor_ != NotIterating && std::ranges::find(visitedRemoved_, component) != visitedRemoved_.end())
     {
-        lateUpdate(&*it);
+        skipPass = pass_;
     }
+
+    if (!entries_.empty() && entries_.back().order > order) unsorted_ = true;
+    component->phaseSlots_[phase_] = int32_t(entries_.size());
+    entries_.push_back({ component, order, skipPass });
 }
 
 
-void PlayerLoop::render(GameObject* object, const Camera& camera)
+void UpdateList::remove(Component* component)
 {
-    // アタッチされている各コンポーネントのRenderを呼ぶ
-    for (auto& it : object->GetComponents())
-    {
-        auto renderer = dynamic_cast<Renderer*>(it.get());
-        if (renderer != nullptr && renderer->enabled)
-        {
-            renderer->render(camera);
-        }
-    }
+    int32_t slot = component->phaseSlots_[phase_];
+    if (slot < 0) return;
 
-    // 子供のオブジェクトについて再帰
-    for (auto& it : object->transform->getChildGameObjects())
+    // 巡回中に呼び終えたものを外すときは覚えておく
+    if (cursor_ != NotIterating && size_t(slot) <= cursor_ && entries_[slot].skipPass != pass_)
     {
-        render(&*it, camera);
+        visitedRemoved_.push_back(component);
     }
-}
-
 
-void PlayerLoop::registerCanvas(Canvas* c)
-{
-    canvas_.push_back(c);
+    entries_[slot].component = nullptr; // 墓標
+    component->phaseSlots_[phase_] = -1;
+    ++removedCount_;
 }
 
 
-void PlayerLoop::unregisterCanvas(Canvas* c)
+void UpdateList::compact()
 {
-    auto it = std::find(canvas_.begin(), canvas_.end(), c);
-    if (it != canvas_.end()) canvas_.erase(it);
+    if (removedCount_ == 0 && !unsorted_) return;
+
+    std::erase_if(entries_, [](const Entry& e) { return e.component == nullptr; });
+    if (unsorted_)
+    {
+        std::stable_sort(entries_.begin(), entries_.end(),
+            [](const Entry& a, const Entry& b) { return a.order < b.order; });
+    }
+    for (size_t i = 0; i < entries_.size(); ++i)
+    {
+        entries_[i].component->phaseSlots_[phase_] = int32_t(i);
+    }
+    removedCount_ = 0;
+    unsorted_ = false;
 }
 
 
@@ -0,0 +1,127 @@
+﻿#include "pch.h"
+#include <UniDx/Prefab.h>
+
+#include <typeinfo>
+
+#include <UniDx/FrameArena.h>
+#include <UniDx/Debug.h>
+
+
+namespace UniDx{
+
+Prefab::Prefab(unique_ptr<GameObject> source) :
+    source_(std::move(source))
+{
+    assert(source_ != nullptr && source_->transform->parent == nullptr);
+    capture(*source_);
+}
+
+
+// 既存の階層を一旦取り込んで複製し、複製の方を所有し直す
+Prefab::Prefab(const GameObject& source)
+{
+    capture(source);
+    source_ = clone(source.transform->localPosition, source.transform->localRotation);
+    capture(*source_);
+}
+
+
+unique_ptr<GameObject> Prefab::Instantiate(Vector3 position, Quaternion rotation) const
+{
+    return clone(position, rotation);
+}
+
+
+// 幅優先でたどり、親が必ず前に来る順に並べる
+void Prefab::capture(const GameObject& root)
+{
+    nodes_.clear();
+    components_.clear();
+
+    auto push = [this](const GameObject* object, int parent) {
+        Node node{ object, parent, uint32_t(components_.size()), 0 };
+        for (auto& c : object->GetComponents())
+        {
+            if (c.get() == object->transform || c->isDestroyed()) continue;
+            if (c->cloneFunc_ == nullptr)
+            {
+                // コピーコンストラクタのない型（所有者を指すプロパティを持つなど）は複製できない
+                Debug::Log(u8"Prefab: " + ToString(object->name) + u8" の "
+                    + u8string(reinterpret_cast<const char8_t*>(typeid(*c).name())) + u8" はコピーできないので複製しません");
+                continue;
+            }
+            components_.push_back(c.get());
+            ++node.componentCount;
+        }
+        nodes_.push_back(node);
+    };
+
+    push(&root, -1);
+    for (size_t i = 0; i < nodes_.size(); ++i)
+    {
+        for (GameObject* child : nodes_[i].source->transform->getChildGameObjects())
+        {
+            if (!child->isCalledDestroy) push(child, int(i));
+        }
+    }
+}
+
+
+unique_ptr<GameObject> Prefab::clone(Vector3 position, Quaternion rotation) const
+{
+    std::pmr::vector<GameObject*> created(nodes_.size(), FrameArena::resource());
+    unique_ptr<GameObject> root;
+
+    for (size_t i = 0; i < nodes_.size(); ++i)
+    {
+        const Node& node = nodes_[i];
+        const GameObject& src = *node.source;
+
+        auto object = make_unique<GameObject>(src.name_);
+        object->components.reserve(size_t(node.componentCount) + 1); // Transformの分
+        object->tag_ = src.tag_;
+        object->layer_ = src.layer_;
+
+        Transform* t = object->transform;
+        t->localPosition = src.transform->localPosition;
+        t->localRotation = src.transform->localRotation;
+        t->localScale = src.transform->localScale;
+
+        for (uint32_t k = 0; k < node.componentCount; ++k)
+        {
+            const Component* c = components_[node.firstComponent + k];
+            c->cloneFunc_(*c, *object);
+        }
+
+        created[i] = object.get();
+        if (node.parent < 0)
+        {
+            root = std::move(object);
+        }
+        else
+        {
+            Transform::SetParent(std::move(object), created[node.parent]->transform);
+        }
+    }
+
+    root->transform->localPosition = position;
+    root->transform->localRotation = rotation;
+    return root;
+}
+
+
+GameObject* Instantiate(const Prefab& prefab, Vector3 position, Quaternion rotation, Transform* parent)
+{
+    assert(parent != nullptr);
+    auto object = prefab.Instantiate(position, rotation);
+    GameObject* ptr = object.get();
+    Transform::SetParent(std::move(object), parent);
+
+    if (parent->enabled)
+    {
+        ptr->checkAwakeInHierarchy();
+    }
+    return ptr;
+}
+
+}
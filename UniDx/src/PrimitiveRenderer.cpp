@@ -81,9 +81,9 @@ void CubeRenderer::OnEnable()
 
     // メッシュの初期化
     auto submesh = std::make_unique<SubMesh>();
-    submesh->positions = std::span<const Vector3>(static_cast<const Vector3*>(cube_positions), std::size(cube_positions));
-    submesh->uv = std::span<const Vector2>(static_cast<const Vector2*>(cube_uvs), std::size(cube_uvs));
-    submesh->normals = std::span<const Vector3>(static_cast<const Vector3*>(cube_normals), std::size(cube_normals));
+    submesh->positions = std::span<const Vector3>(static_cast<const Vector3*>(&cube_positions[0]), std::size(cube_positions));
+    submesh->uv = std::span<const Vector2>(static_cast<const Vector2*>(&cube_uvs[0]), std::size(cube_uvs));
+    submesh->normals = std::span<const Vector3>(static_cast<const Vector3*>(&cube_normals[0]), std::size(cube_normals));
     submesh->topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
     if (createBufer_ != nullptr)
     {
@@ -174,9 +174,9 @@ void QuadRenderer::OnEnable()
 
     // メッシュの初期化.
     auto submesh = std::make_unique<SubMesh>();
-    submesh->positions = std::span<const Vector3>(static_cast<const Vector3*>(quad_positions), std::size(quad_positions));
-    submesh->uv = std::span<const Vector2>(static_cast<const Vector2*>(quad_uvs), std::size(quad_uvs));
-    submesh->normals = std::span<const Vector3>(static_cast<const Vector3*>(quad_normals), std::size(quad_normals));
+    submesh->positions = std::span<const Vector3>(static_cast<const Vector3*>(&quad_positions[0]), std::size(quad_positions));
+    submesh->uv = std::span<const Vector2>(static_cast<const Vector2*>(&quad_uvs[0]), std::size(quad_uvs));
+    submesh->normals = std::span<const Vector3>(static_cast<const Vector3*>(&quad_normals[0]), std::size(quad_normals));
     submesh->topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
     if (createBufer_ != nullptr)
     {
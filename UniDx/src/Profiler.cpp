@@ -0,0 +1,163 @@
+﻿#include "pch.h"
+#include <UniDx/Profiler.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+
+namespace UniDx{
+
+namespace
+{
+    // スレッドごとのリングバッファ
+    // 書き込むのは持ち主のスレッドだけなので、件数を release で進めればロックはいらない
+    struct ThreadBuffer
+    {
+        std::thread::id threadId;
+        uint32_t index;                         // trace_event の tid
+        std::unique_ptr<Profiler::Event[]> events{ new Profiler::Event[Profiler::EventsPerThread] };
+        std::atomic<uint64_t> written = 0;      // これまでに書いた数
+    };
+
+    // スレッドが終わっても書き出せるように、バッファはここで持ち続ける
+    std::mutex s_bufferMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+
+    int64_t steadyNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // キャプチャ開始の時刻。ワーカーも now() で読むのでアトミックにしておく
+    std::atomic<int64_t> s_origin = steadyNanoseconds();
+    std::thread::id s_mainThread;
+
+    ThreadBuffer& threadBuffer()
+    {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (buffer == nullptr)
+        {
+            auto created = std::make_unique<ThreadBuffer>();
+            created->threadId = std::this_thread::get_id();
+
+            std::lock_guard lock(s_bufferMutex);
+            created->index = uint32_t(s_buffers.size());
+            buffer = created.get();
+            s_buffers.push_back(std::move(created));
+        }
+        return *buffer;
+    }
+
+    // JSONの文字列として書き出す
+    void writeJsonString(std::ofstream& out, const char* s)
+    {
+        out << '"';
+        for (; *s != '\0'; ++s)
+        {
+            const unsigned char c = static_cast<unsigned char>(*s);
+            if (c == '"' || c == '\\')
+            {
+                out << '\\' << char(c);
+            }
+            else if (c < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out << escaped;
+            }
+            else
+            {
+                out << char(c);
+            }
+        }
+        out << '"';
+    }
+}
+
+
+int64_t Profiler::now()
+{
+    return steadyNanoseconds() - s_origin.load(std::memory_order_acquire);
+}
+
+
+void Profiler::BeginCapture()
+{
+    capturing_.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard lock(s_bufferMutex);
+        for (auto& buffer : s_buffers)
+        {
+            buffer->written.store(0, std::memory_order_relaxed);
+        }
+    }
+    s_origin.store(steadyNanoseconds(), std::memory_order_release);
+    s_mainThread = std::this_thread::get_id();
+    capturing_.store(true, std::memory_order_release);
+}
+
+
+void Profiler::EndCapture()
+{
+    capturing_.store(false, std::memory_order_release);
+}
+
+
+void Profiler::record(const char* name, const char* category, int64_t begin, int64_t end)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    const uint64_t n = buffer.written.load(std::memory_order_relaxed);
+    buffer.events[n % EventsPerThread] = Event{ name, category, begin, end };
+    buffer.written.store(n + 1, std::memory_order_release);
+}
+
+
+// 区間は開始と長さを持つ "X"（complete）イベントで書き出す。時刻の単位はマイクロ秒
+bool Profiler::WriteChromeTrace(const u8string& filePath)
+{
+    std::ofstream out(std::filesystem::path(filePath), std::ios::binary);
+    if (!out)
+    {
+        Debug::Log(u8"Profiler: " + filePath + u8" を開けません");
+        return false;
+    }
+
+    std::lock_guard lock(s_bufferMutex);
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    char number[64];
+    for (auto& buffer : s_buffers)
+    {
+        const uint64_t written = buffer->written.load(std::memory_order_acquire);
+        if (written == 0) continue;
+
+        // スレッド名
+        if (!first) out << ",\n";
+        first = false;
+        out << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->index << ",\"name\":\"thread_name\",\"args\":{\"name\":\"";
+        if (buffer->threadId == s_mainThread) out << "Main";
+        else out << "Thread " << buffer->index;
+        out << "\"}}";
+
+        // あふれていれば残っている分だけ
+        const uint64_t start = written > EventsPerThread ? written - EventsPerThread : 0;
+        for (uint64_t i = start; i < written; ++i)
+        {
+            const Event& e = buffer->events[i % EventsPerThread];
+            out << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->index << ",\"name\":";
+            writeJsonString(out, e.name);
+            out << ",\"cat\":";
+            writeJsonString(out, e.category);
+            std::snprintf(number, sizeof(number), ",\"ts\":%.3f,\"dur\":%.3f}", e.begin * 0.001, (e.end - e.begin) * 0.001);
+            out << number;
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return bool(out);
+}
+
+}
@@ -0,0 +1,242 @@
+﻿#include "pch.h"
+#include <UniDx/RenderBackend.h>
+
+#include <algorithm>
+
+#include <UniDx/D3DManager.h>
+#include <UniDx/Font.h>
+#include <UniDx/Mesh.h>
+#include <UniDx/Shader.h>
+#include <UniDx/Texture.h>
+
+#if UNIDX_D3D11
+#include <SpriteFont.h>
+#endif
+
+
+namespace UniDx{
+
+#if UNIDX_D3D11
+
+namespace
+{
+    ComPtr<ID3D11Buffer> createConstantBuffer(UINT byteWidth)
+    {
+        ComPtr<ID3D11Buffer> buffer;
+        D3D11_BUFFER_DESC desc{};
+        desc.ByteWidth = byteWidth;
+        desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        desc.CPUAccessFlags = 0;
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        D3DManager::getInstance()->GetDevice()->CreateBuffer(&desc, nullptr, buffer.GetAddressOf());
+        return buffer;
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// コンストラクタ。定数バッファを種類ごとに作る
+// -----------------------------------------------------------------------------
+D3DRenderBackend::D3DRenderBackend() :
+    skinStaging(std::make_unique<ConstantBufferSkinPerObject>())
+{
+    constantBufferPerCamera = createConstantBuffer(sizeof(ConstantBufferPerCamera));
+    constantBufferPerObject = createConstantBuffer(sizeof(ConstantBufferPerObject));
+    constantBufferSkinPerObject = createConstantBuffer(sizeof(ConstantBufferSkinPerObject));
+    constantBufferLightPerFrame = createConstantBuffer(sizeof(ConstantBufferLightPerFrame));
+    constantBufferLightPerObject = createConstantBuffer(sizeof(ConstantBufferLightPerObject));
+}
+
+
+D3DRenderBackend::~D3DRenderBackend() = default;
+
+
+// -----------------------------------------------------------------------------
+// 1フレーム分を描画して表示する
+// -----------------------------------------------------------------------------
+void D3DRenderBackend::render(const RenderFrame& frame)
+{
+    UNIDX_PROFILE_SCOPE("Render/Frame");
+    ID3D11DeviceContext* context = D3DManager::getInstance()->GetContext().Get();
+
+    // 画面を塗りつぶす
+    D3DManager::getInstance()->Clear(0.35f, 0.55f, 0.9f, 1.0f);
+
+    // カメラ単位の定数バッファ
+    if (frame.hasCamera)
+    {
+        context->UpdateSubresource(constantBufferPerCamera.Get(), 0, nullptr, &frame.camera, 0, 0);
+        ID3D11Buffer* cbs[1] = { constantBufferPerCamera.Get() };
+        context->VSSetConstantBuffers(CB_PerCamera, 1, cbs);
+        context->PSSetConstantBuffers(CB_PerCamera, 1, cbs);
+    }
+
+    // フレーム共通のライト
+    {
+        context->UpdateSubresource(constantBufferLightPerFrame.Get(), 0, nullptr, &frame.lights, 0, 0);
+        ID3D11Buffer* cbs[1] = { constantBufferLightPerFrame.Get() };
+        context->PSSetConstantBuffers(CB_LightPerFrame, 1, cbs);
+    }
+
+    // 直前と同じものは設定し直さない
+    uint32_t currentMaterial = RenderFrame::None;
+    uint32_t currentObject = RenderFrame::None;
+    uint32_t currentLightSet = RenderFrame::None;
+    for (const DrawPacket& draw : frame.draws)
+    {
+        if (draw.kind == DrawPacket::Kind_Text)
+        {
+            drawText(frame.texts[draw.text]);
+
+            // SpriteBatch がステートを書き換えるので、次の描画で設定し直す
+            currentMaterial = RenderFrame::None;
+            currentObject = RenderFrame::None;
+            continue;
+        }
+
+        if (draw.material != RenderFrame::None && draw.material != currentMaterial)
+        {
+            bindMaterial(frame, frame.materials[draw.material]);
+            currentMaterial = draw.material;
+        }
+        if (draw.object != currentObject)
+        {
+            bindObject(frame, frame.objects[draw.object]);
+            currentObject = draw.object;
+        }
+        if (draw.lightSet != RenderFrame::None && draw.lightSet != currentLightSet)
+        {
+            context->UpdateSubresource(constantBufferLightPerObject.Get(), 0, nullptr, &frame.lightSets[draw.lightSet], 0, 0);
+            ID3D11Buffer* cbs[1] = { constantBufferLightPerObject.Get() };
+            context->PSSetConstantBuffers(CB_LightPerObject, 1, cbs);
+            currentLightSet = draw.lightSet;
+        }
+
+        draw.mesh->render();
+    }
+
+    // バックバッファの内容を画面に表示
+    {
+        UNIDX_PROFILE_SCOPE("Render/Present");
+        D3DManager::getInstance()->Present();
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// マテリアルのシェーダー・テクスチャ・ステート・定数を設定
+// -----------------------------------------------------------------------------
+void D3DRenderBackend::bindMaterial(const RenderFrame& frame, const MaterialPacket& material)
+{
+    ID3D11DeviceContext* context = D3DManager::getInstance()->GetContext().Get();
+
+    if (material.shader != nullptr) material.shader->setToContext();
+    for (uint32_t i = 0; i < material.textureCount; ++i)
+    {
+        const Texture* tex = frame.textures[material.textures + i];
+        if (tex != nullptr) tex->bind();
+    }
+
+    context->OMSetDepthStencilState(material.state.depthStencilState.Get(), 1);
+    context->OMSetBlendState(material.state.blendState.Get(), NULL, 0xffffffff);
+    context->RSSetState(material.state.rasterizerState.Get());
+
+    // 定数は前のフレームから変わったときだけ入っている
+    if (material.constantsSize > 0)
+    {
+        context->UpdateSubresource(material.state.constantBuffer.Get(), 0, nullptr, &frame.bytes[material.constants], 0, 0);
+    }
+
+    ID3D11Buffer* cbs[1] = { material.state.constantBuffer.Get() };
+    context->VSSetConstantBuffers(CB_PerMaterial, 1, cbs);
+    context->PSSetConstantBuffers(CB_PerMaterial, 1, cbs);
+}
+
+
+// -----------------------------------------------------------------------------
+// オブジェクトの姿勢を定数バッファに転送
+// -----------------------------------------------------------------------------
+void D3DRenderBackend::bindObject(const RenderFrame& frame, const ObjectPacket& object)
+{
+    ID3D11DeviceContext* context = D3DManager::getInstance()->GetContext().Get();
+
+    ID3D11Buffer* buffer;
+    if (object.skinned)
+    {
+        skinStaging->world = object.world;
+        std::copy_n(frame.bones.begin() + object.bones, object.boneCount, skinStaging->bones);
+        buffer = constantBufferSkinPerObject.Get();
+        context->UpdateSubresource(buffer, 0, nullptr, skinStaging.get(), 0, 0);
+    }
+    else
+    {
+        ConstantBufferPerObject cb{};
+        cb.world = object.world;
+        buffer = constantBufferPerObject.Get();
+        context->UpdateSubresource(buffer, 0, nullptr, &cb, 0, 0);
+    }
+
+    ID3D11Buffer* cbs[1] = { buffer };
+    context->VSSetConstantBuffers(CB_PerObject, 1, cbs);
+}
+
+
+// -----------------------------------------------------------------------------
+// SpriteFontを使ったテキストの描画
+// SpriteBatch はイミディエイトコンテキストを使うので、描画スレッドで初めて使うときに作る
+// -----------------------------------------------------------------------------
+void D3DRenderBackend::drawText(const TextPacket& text)
+{
+    if (text.font == nullptr || text.font->getSpriteFont() == nullptr) return;
+
+    if (spriteBatch == nullptr)
+    {
+        spriteBatch = std::make_unique<DirectX::SpriteBatch>(D3DManager::getInstance()->GetContext().Get());
+    }
+
+    spriteBatch->Begin();
+    text.font->getSpriteFont()->DrawString(
+        spriteBatch.get(), text.text.c_str(), text.position, text.color.XMLoad(), 0.0f, Vector2::zero, text.scale);
+    spriteBatch->End();
+}
+
+#endif
+
+
+// -----------------------------------------------------------------------------
+// 受け取ったパケットを記録する
+// 「直前のまま」の番号は、実際に描画したときに使われるものに置き換えて残す
+// -----------------------------------------------------------------------------
+void RecordingRenderBackend::render(const RenderFrame& frame)
+{
+    Frame& recorded = frames_.emplace_back();
+    recorded.hasCamera = frame.hasCamera;
+    recorded.camera = frame.camera;
+    recorded.materialCount = frame.materials.size();
+    recorded.draws.reserve(frame.draws.size());
+
+    const Material* material = nullptr;
+    const ConstantBufferLightPerObject* lightSet = nullptr;
+    for (const DrawPacket& draw : frame.draws)
+    {
+        Draw& d = recorded.draws.emplace_back();
+        d.kind = draw.kind;
+        d.pass = draw.pass;
+        d.mesh = draw.mesh;
+        d.world = Matrix4x4::identity;
+        d.boneCount = 0;
+
+        if (draw.kind == DrawPacket::Kind_Mesh)
+        {
+            if (draw.material != RenderFrame::None) material = frame.materials[draw.material].material;
+            if (draw.lightSet != RenderFrame::None) lightSet = &frame.lightSets[draw.lightSet];
+            d.world = frame.objects[draw.object].world;
+            d.boneCount = frame.objects[draw.object].boneCount;
+        }
+        d.material = draw.kind == DrawPacket::Kind_Mesh ? material : nullptr;
+        d.pointLightCount = lightSet != nullptr ? lightSet->pointLightCount : 0;
+        d.spotLightCount = lightSet != nullptr ? lightSet->spotLightCount : 0;
+    }
+}
+
+}
@@ -0,0 +1,130 @@
+﻿#include "pch.h"
+#include <UniDx/RenderPacket.h>
+
+#include <UniDx/Camera.h>
+#include <UniDx/Font.h>
+#include <UniDx/LightManager.h>
+#include <UniDx/Mesh.h>
+#include <UniDx/Texture.h>
+
+
+namespace UniDx{
+
+void RenderFrame::clear()
+{
+    hasCamera = false;
+    draws.clear();
+    materials.clear();
+    objects.clear();
+    lightSets.clear();
+    texts.clear();
+    textures.clear();
+    bones.clear();
+    bytes.clear();
+    retained.clear();
+    materialIndex.clear();
+}
+
+
+RenderPacketBuilder::RenderPacketBuilder(RenderFrame& frame) : frame_(frame)
+{
+    frame_.clear();
+}
+
+
+void RenderPacketBuilder::setCamera(const Camera& camera)
+{
+    camera.makeConstantBuffer(frame_.camera);
+    frame_.hasCamera = true;
+}
+
+
+void RenderPacketBuilder::setLights(LightManager& lights)
+{
+    lights_ = &lights;
+    lights.makeLightsPerFrame(frame_.lights);
+}
+
+
+uint32_t RenderPacketBuilder::addMaterial(Material& material, std::shared_ptr<const Material> keep)
+{
+    auto [it, inserted] = frame_.materialIndex.try_emplace(&material, uint32_t(frame_.materials.size()));
+    if (!inserted) return it->second;
+
+    MaterialPacket& packet = frame_.materials.emplace_back();
+    packet.material = &material;
+    packet.shader = material.shader.get();
+    packet.state = material.gpuState();
+
+    // 変わった定数だけコピーする
+    std::span<const uint8_t> constants = material.prepareConstants();
+    packet.constants = uint32_t(frame_.bytes.size());
+    packet.constantsSize = uint32_t(constants.size());
+    frame_.bytes.insert(frame_.bytes.end(), constants.begin(), constants.end());
+
+    auto textures = material.getTextures();
+    packet.textures = uint32_t(frame_.textures.size());
+    packet.textureCount = uint32_t(textures.size());
+    for (auto& tex : textures)
+    {
+        frame_.textures.push_back(tex.get());
+        if (tex != nullptr) frame_.retained.push_back(tex);
+    }
+
+    if (material.shader != nullptr) frame_.retained.push_back(material.shader);
+    if (keep != nullptr) frame_.retained.push_back(std::move(keep));
+    return it->second;
+}
+
+
+uint32_t RenderPacketBuilder::addObject(const Matrix4x4& world)
+{
+    frame_.objects.push_back(ObjectPacket{ world, 0, 0, false });
+    return uint32_t(frame_.objects.size() - 1);
+}
+
+
+uint32_t RenderPacketBuilder::addSkinnedObject(const Matrix4x4& world, uint32_t boneCount)
+{
+    frame_.objects.push_back(ObjectPacket{ world, uint32_t(frame_.bones.size()), boneCount, true });
+    frame_.bones.resize(frame_.bones.size() + boneCount);
+    return uint32_t(frame_.objects.size() - 1);
+}
+
+
+std::span<BoneMat3x4> RenderPacketBuilder::bones(uint32_t object)
+{
+    const ObjectPacket& o = frame_.objects[object];
+    return std::span<BoneMat3x4>(frame_.bones).subspan(o.bones, o.boneCount);
+}
+
+
+uint32_t RenderPacketBuilder::addLightSet(Vector3 position, int lightCount)
+{
+    if (lights_ == nullptr) return None;
+    lights_->makeLightsPerObject(frame_.lightSets.emplace_back(), position, lightCount);
+    return uint32_t(frame_.lightSets.size() - 1);
+}
+
+
+void RenderPacketBuilder::addMesh(const SubMesh& mesh, uint32_t object, uint32_t material, uint32_t lightSet)
+{
+    frame_.draws.push_back(DrawPacket{ DrawPacket::Kind_Mesh, pass_, material, object, lightSet, None, &mesh });
+}
+
+
+void RenderPacketBuilder::addMesh(const std::shared_ptr<SubMesh>& mesh, uint32_t object, uint32_t material, uint32_t lightSet)
+{
+    addMesh(*mesh, object, material, lightSet);
+    frame_.retained.push_back(mesh);
+}
+
+
+void RenderPacketBuilder::addText(const std::shared_ptr<Font>& font, std::wstring text, Vector2 position, Vector2 scale, Color color)
+{
+    frame_.texts.push_back(TextPacket{ font.get(), std::move(text), position, scale, color });
+    frame_.retained.push_back(font);
+    frame_.draws.push_back(DrawPacket{ DrawPacket::Kind_Text, pass_, None, None, None, uint32_t(frame_.texts.size() - 1), nullptr });
+}
+
+}
@@ -0,0 +1,93 @@
+﻿#include "pch.h"
+#include <UniDx/RenderThread.h>
+
+#include <UniDx/RenderBackend.h>
+
+
+namespace UniDx{
+
+RenderThread::~RenderThread()
+{
+    stop();
+}
+
+
+void RenderThread::start(RenderBackend* backend, bool threaded)
+{
+    stop();
+    backend_ = backend;
+    quit_ = false;
+    if (threaded)
+    {
+        thread_ = std::thread(&RenderThread::threadMain, this);
+    }
+}
+
+
+void RenderThread::stop()
+{
+    if (thread_.joinable())
+    {
+        {
+            std::lock_guard lock(mutex_);
+            quit_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+    backend_ = nullptr;
+    pending_ = nullptr;
+}
+
+
+void RenderThread::submit(const RenderFrame& frame)
+{
+    if (backend_ == nullptr) return;
+
+    if (!thread_.joinable())
+    {
+        backend_->render(frame);
+        return;
+    }
+
+    std::unique_lock lock(mutex_);
+    {
+        UNIDX_PROFILE_SCOPE("PlayerLoop/WaitForRender");
+        cv_.wait(lock, [this] { return pending_ == nullptr; });
+    }
+    pending_ = &frame;
+    lock.unlock();
+    cv_.notify_all();
+}
+
+
+void RenderThread::waitIdle()
+{
+    if (!thread_.joinable()) return;
+
+    UNIDX_PROFILE_SCOPE("PlayerLoop/WaitForRender");
+    std::unique_lock lock(mutex_);
+    cv_.wait(lock, [this] { return pending_ == nullptr; });
+}
+
+
+void RenderThread::threadMain()
+{
+    std::unique_lock lock(mutex_);
+    while (true)
+    {
+        // 止めるときも、渡されているフレームは描き終えてから抜ける
+        cv_.wait(lock, [this] { return pending_ != nullptr || quit_; });
+        if (pending_ == nullptr) break;
+
+        const RenderFrame* frame = pending_;
+        lock.unlock();
+        backend_->render(*frame);
+        lock.lock();
+
+        pending_ = nullptr;
+        cv_.notify_all();
+    }
+}
+
+}
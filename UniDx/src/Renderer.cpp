@@ -1,12 +1,12 @@
 ﻿#include "pch.h"
 #include <UniDx/Renderer.h>
 
-#include <UniDx/D3DManager.h>
 #include <UniDx/Texture.h>
 #include <UniDx/Camera.h>
 #include <UniDx/Material.h>
 #include <UniDx/SceneManager.h>
 #include <UniDx/LightManager.h>
+#include <UniDx/RenderPacket.h>
 
 namespace UniDx{
 
@@ -21,51 +21,6 @@ void Renderer::OnEnable()
     {
         material->OnEnable();
     }
-
-    // 行列用の定数バッファ生成
-    createConstantBufferPerObject();
-}
-
-
-// -----------------------------------------------------------------------------
-// 行列用の定数バッファ生成
-// -----------------------------------------------------------------------------
-void Renderer::createConstantBufferPerObject()
-{
-    D3D11_BUFFER_DESC desc{};
-    desc.ByteWidth = sizeof(ConstantBufferPerObject);
-    desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-    desc.CPUAccessFlags = 0;
-    desc.Usage = D3D11_USAGE_DEFAULT;
-    D3DManager::getInstance()->GetDevice()->CreateBuffer(&desc, nullptr, constantBufferPerObject.GetAddressOf());
-}
-
-
-// -----------------------------------------------------------------------------
-// 現在の姿勢をシェーダーの定数バッファに転送
-// -----------------------------------------------------------------------------
-void Renderer::bindPerObject()
-{
-    // ワールド行列を transform から合わせて作成
-    ConstantBufferPerObject cb{};
-    cb.world = transform->localToWorldMatrix();
-    D3DManager::getInstance()->GetContext()->UpdateSubresource(constantBufferPerObject.Get(), 0, nullptr, &cb, 0, 0);
-
-    // 定数バッファ更新
-    ID3D11Buffer* cbs[1] = { constantBufferPerObject.Get() };
-    D3DManager::getInstance()->GetContext()->VSSetConstantBuffers(CB_PerObject, 1, cbs);
-}
-
-
-// -----------------------------------------------------------------------------
-// オブジェクトに合わせたライト情報をシェーダーの定数バッファに転送
-// -----------------------------------------------------------------------------
-void Renderer::bindLightPerObject()
-{
-    if(lightCount > 0)
-    {
-        LightManager::getInstance()->updateLightCBufferObject(transform->position, lightCount);
-    }
 }
 
 
@@ -79,30 +34,50 @@ MeshRenderer::MeshRenderer()
 
 
 // -----------------------------------------------------------------------------
-// メッシュを使って描画
+// メッシュを使って描画パケットを積む
 // -----------------------------------------------------------------------------
-void MeshRenderer::render(const Camera& camera)
+void MeshRenderer::buildPackets(RenderPacketBuilder& builder)
 {
     // レンダーモードが一致するマテリアルがあるか確認
+    const RenderingMode mode = RenderingMode(builder.pass());
     auto it = std::ranges::find_if(materials, 
-        [](auto& m){
-            return m != nullptr && m->renderingMode == D3DManager::getInstance()->getCurrentRenderingMode();
+        [mode](auto& m){
+            return m != nullptr && m->renderingMode == mode;
         });
     if(it == materials.end())
     {
         return;
     }
 
-    // 現在のTransformの情報をシェーダーのConstantBufferに転送
-    bindPerObject();
+    // 現在のTransformの情報
+    const uint32_t object = addObjectPacket(builder);
 
-    // オブジェクトに合わせたライト情報をシェーダーのConstantBufferに転送
-    bindLightPerObject();
+    // オブジェクトに合わせたライト情報
+    const uint32_t lightSet = lightCount > 0 ? builder.addLightSet(transform->position, lightCount) : RenderPacketBuilder::None;
 
     //-----------------------------
-    // 描画実行
+    // サブメッシュごとに積む
     //-----------------------------
-    mesh.render(materials);
+    for (size_t i = 0; i < mesh.submesh.size(); ++i)
+    {
+        uint32_t material = RenderPacketBuilder::None;
+        if (i < materials.size() && materials[i] != nullptr)
+        {
+            // 描画するマテリアルでなければ、以降のサブメッシュも積まない
+            if (materials[i]->renderingMode != mode) return;
+            material = builder.addMaterial(*materials[i], materials[i]);
+        }
+        builder.addMesh(mesh.submesh[i], object, material, lightSet);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// 現在の姿勢を登録して番号を返す
+// -----------------------------------------------------------------------------
+uint32_t MeshRenderer::addObjectPacket(RenderPacketBuilder& builder)
+{
+    return builder.addObject(transform->localToWorldMatrix());
 }
 
 }
@@ -0,0 +1,130 @@
+﻿#include "pch.h"
+#include <UniDx/Scene.h>
+
+#include <UniDx/Physics.h>
+#include <UniDx/TransformHierarchy.h>
+
+
+namespace UniDx{
+
+// コンストラクタ。シーン専用の物理ワールドを作成
+Scene::Scene() :
+	physics(std::make_unique<Physics>()),
+	transformHierarchy(std::make_unique<TransformHierarchy>(this)),
+	nameIndex(GameObjectIndex::Key_Name),
+	tagIndex(GameObjectIndex::Key_Tag)
+{
+}
+
+
+// デストラクタ
+// GameObjectを先に破棄して、コライダーの登録解除が済んでから物理ワールドを破棄する
+Scene::~Scene()
+{
+	routeGameObjects.clear();
+}
+
+
+// ルートにGameObjectを追加
+void Scene::addRootGameObject(unique_ptr<GameObject> obj)
+{
+	obj->setSceneInHierarchy(this);
+	routeGameObjects.push_back(std::move(obj));
+}
+
+
+// ルートからGameObjectを取り外す
+unique_ptr<GameObject> Scene::removeRootGameObject(GameObject* obj)
+{
+	auto it = std::find_if(routeGameObjects.begin(), routeGameObjects.end(),
+		[obj](const unique_ptr<GameObject>& ptr) { return ptr.get() == obj; });
+	if (it == routeGameObjects.end()) return nullptr;
+
+	unique_ptr<GameObject> result = std::move(*it);
+	routeGameObjects.erase(it);
+	transformHierarchy->invalidate();
+	return result;
+}
+
+
+// 名前で探す
+GameObject* Scene::FindByName(StringId name) const
+{
+	for (GameObject* o : nameIndex.find(name))
+	{
+		if (!o->isCalledDestroy) return o;
+	}
+	return nullptr;
+}
+
+
+// タグで探す
+GameObject* Scene::FindWithTag(StringId tag) const
+{
+	for (GameObject* o : tagIndex.find(tag))
+	{
+		if (!o->isCalledDestroy) return o;
+	}
+	return nullptr;
+}
+
+
+// タグで全部探す
+std::vector<GameObject*> Scene::FindGameObjectsWithTag(StringId tag) const
+{
+	std::vector<GameObject*> result;
+	for (GameObject* o : tagIndex.find(tag))
+	{
+		if (!o->isCalledDestroy) result.push_back(o);
+	}
+	return result;
+}
+
+
+// --------------------
+// GameObjectIndex
+// --------------------
+void GameObjectIndex::add(StringId key, GameObject* object)
+{
+	if (key.view().empty()) return; // 空の名前・タグは載せない
+
+	auto& bucket = buckets_[key];
+	slotOf(object) = uint32_t(bucket.size());
+	bucket.push_back(object);
+}
+
+
+void GameObjectIndex::remove(StringId key, GameObject* object)
+{
+	if (key.view().empty()) return;
+
+	auto it = buckets_.find(key);
+	if (it == buckets_.end()) return;
+
+	auto& bucket = it->second;
+	const uint32_t slot = slotOf(object);
+	assert(slot < bucket.size() && bucket[slot] == object);
+
+	// 末尾と入れ替えて外す
+	GameObject* last = bucket.back();
+	bucket[slot] = last;
+	slotOf(last) = slot;
+	bucket.pop_back();
+	if (bucket.empty()) buckets_.erase(it);
+}
+
+
+uint32_t& GameObjectIndex::slotOf(GameObject* object) const
+{
+	return key_ == Key_Name ? object->nameSlot_ : object->tagSlot_;
+}
+
+
+std::span<GameObject* const> GameObjectIndex::find(StringId key) const
+{
+	auto it = buckets_.find(key);
+	if (it == buckets_.end()) return {};
+	return it->second;
+}
+
+}
@@ -0,0 +1,85 @@
+﻿#include "pch.h"
+#include <UniDx/SceneArena.h>
+
+
+namespace UniDx{
+
+namespace
+{
+    thread_local SceneArena* t_current = nullptr;
+}
+
+
+SceneArena::SceneArena(size_t initialSize) :
+    buffer_(initialSize, std::pmr::new_delete_resource())
+{
+}
+
+
+SceneArena* SceneArena::create(size_t initialSize)
+{
+    return new SceneArena(initialSize);
+}
+
+
+// 所有者が手放す
+void SceneArena::release()
+{
+    assert(t_current != this && "使用中のアリーナは手放せません");
+    assert(!released_);
+    released_ = true;
+    unref();
+}
+
+
+SceneArena* SceneArena::current()
+{
+    return t_current;
+}
+
+
+std::pmr::memory_resource* SceneArena::currentResource()
+{
+    return t_current != nullptr ? static_cast<std::pmr::memory_resource*>(t_current) : std::pmr::new_delete_resource();
+}
+
+
+void* SceneArena::do_allocate(size_t bytes, size_t alignment)
+{
+    refCount_.fetch_add(1, std::memory_order_relaxed);
+    return buffer_.allocate(bytes, alignment);
+}
+
+
+// 個別には返さない。数だけ数えて、手放された後に最後の1つならまとめて返す
+void SceneArena::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+    unref();
+}
+
+
+void SceneArena::unref()
+{
+    if (refCount_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete this; // monotonic_buffer_resource のデストラクタで領域をまとめて返す
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// Scope
+// -----------------------------------------------------------------------------
+SceneArena::Scope::Scope(SceneArena* arena) :
+    previous_(t_current)
+{
+    t_current = arena;
+}
+
+
+SceneArena::Scope::~Scope()
+{
+    t_current = previous_;
+}
+
+}
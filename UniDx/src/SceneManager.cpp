@@ -14,6 +14,12 @@ using namespace std;
 // シーン作成
 void SceneManager::createScene()
 {
+	// 前のシーンのアリーナを手放す。前のシーンが残っているあいだは、最後の解放まで領域は残る
+	if (sceneArena != nullptr) sceneArena->release();
+
+	// シーンのGameObjectとComponentはアリーナからまとめて確保する
+	sceneArena = SceneArena::create();
+	SceneArena::Scope scope(sceneArena);
 	activeScene = std::move(CreateDefaultScene());
 //	defaultMaterial = make_unique<Material>();
 //	defaultMaterial->shader.compile<VertexPN>(L"Resource/DefaultShade.hlsl");
@@ -23,6 +29,10 @@ void SceneManager::createScene()
 SceneManager::~SceneManager()
 {
 	DestroyDefaultScene();
+	activeScene.reset();
+
+	// 個別の解放は済んでいるので、領域をまとめて返す（生き残りがいればその解放時）
+	if (sceneArena != nullptr) sceneArena->release();
 }
 
 }
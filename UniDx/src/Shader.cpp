@@ -2,12 +2,13 @@
 #include <UniDx/Shader.h>
 
 #include <filesystem>
-#include <d3d11.h>
 
 #include <UniDx/D3DManager.h>
 #include <UniDx/ConstantBuffer.h>
 
+#if UNIDX_D3D11
 #pragma comment(lib, "d3dcompiler.lib")
+#endif
 
 
 namespace UniDx
@@ -52,8 +53,13 @@ const std::array< D3D11_INPUT_ELEMENT_DESC, 3> VertexPNC::layout =
 };
 
 
+#if UNIDX_D3D11
+
 bool Shader::compile(const u8string& filePath, const D3D11_INPUT_ELEMENT_DESC* layout, size_t layout_size)
 {
+	UNIDX_PROFILE_SCOPE("Asset/Shader");
+	if (D3DManager::isHeadless()) return false;
+
 	ID3DBlob* error = nullptr;
 
 	// 頂点シェーダーを読み込み＆コンパイル
@@ -117,6 +123,14 @@ void Shader::setToContext() const
 	D3DManager::getInstance()->GetContext()->IASetInputLayout(inputLayout.Get());
 }
 
+#else
+
+// Direct3D のない環境ではコンパイルしない。マテリアル変数のレイアウトも空のまま
+bool Shader::compile(const u8string&, const D3D11_INPUT_ELEMENT_DESC*, size_t) { return false; }
+void Shader::setToContext() const {}
+
+#endif
+
 // 変数の名前を指定してレイアウトを取得
 const ShaderVarLayout* Shader::findVar(StringId nameId) const
 {
@@ -125,6 +139,8 @@ const ShaderVarLayout* Shader::findVar(StringId nameId) const
 }
 
 
+#if UNIDX_D3D11
+
 // ピクセルシェーダーから変数のレイアウトを反映
 void Shader::reflectPSLayout(ID3DBlob* psBlob)
 {
@@ -133,7 +149,7 @@ void Shader::reflectPSLayout(ID3DBlob* psBlob)
 
 	if(!psBlob) return;
 
-	Microsoft::WRL::ComPtr<ID3D11ShaderReflection> refl;
+	ComPtr<ID3D11ShaderReflection> refl;
 	if(FAILED(D3DReflect(psBlob->GetBufferPointer(), psBlob->GetBufferSize(),
 		IID_ID3D11ShaderReflection, (void**)refl.GetAddressOf())))
 		return;
@@ -161,4 +177,10 @@ void Shader::reflectPSLayout(ID3DBlob* psBlob)
 	}
 }
 
+#else
+
+void Shader::reflectPSLayout(ID3DBlob*) {}
+
+#endif
+
 }
\ No newline at end of file
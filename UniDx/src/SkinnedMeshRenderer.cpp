@@ -1,9 +1,9 @@
 ﻿#include "pch.h"
 #include <UniDx/SkinnedMeshRenderer.h>
 
-#include <UniDx/D3DManager.h>
 #include <UniDx/Texture.h>
 #include <UniDx/Material.h>
+#include <UniDx/RenderPacket.h>
 
 namespace UniDx{
 
@@ -31,35 +31,21 @@ SkinnedMeshRenderer::SkinnedMeshRenderer()
 
 
 // -----------------------------------------------------------------------------
-// 現在の姿勢をシェーダーの定数バッファに転送
+// 現在の姿勢とボーン行列を登録して番号を返す
 // -----------------------------------------------------------------------------
-void SkinnedMeshRenderer::createConstantBufferPerObject()
-{
-    D3D11_BUFFER_DESC desc{};
-    desc.ByteWidth = sizeof(ConstantBufferSkinPerObject);
-    desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-    desc.CPUAccessFlags = 0;
-    desc.Usage = D3D11_USAGE_DEFAULT;
-    D3DManager::getInstance()->GetDevice()->CreateBuffer(&desc, nullptr, constantBufferPerObject.GetAddressOf());
-
-    constantBuffer = make_unique<ConstantBufferSkinPerObject>();
-}
-
-
-// -----------------------------------------------------------------------------
-// 現在の姿勢をシェーダーの定数バッファに転送
-// -----------------------------------------------------------------------------
-void SkinnedMeshRenderer::bindPerObject()
+uint32_t SkinnedMeshRenderer::addObjectPacket(RenderPacketBuilder& builder)
 {
     // ワールド行列を transform から合わせて作成
-    constantBuffer->world = transform->localToWorldMatrix();
+    const Matrix4x4 world = transform->localToWorldMatrix();
+
+    const uint32_t n = skin ? (uint32_t)std::min<size_t>(skin->joints.size(), SkinMeshBoneMax) : 0;
+    const uint32_t object = builder.addSkinnedObject(world, n);
 
     // ボーン行列
-    if(skin && !skin->joints.empty())
+    if(n > 0)
     {
-        Matrix4x4 invWorld = constantBuffer->world.inverse();
-
-        const uint32_t n = (uint32_t)std::min<size_t>(skin->joints.size(), SkinMeshBoneMax);
+        Matrix4x4 invWorld = world.inverse();
+        std::span<BoneMat3x4> bones = builder.bones(object);
 
         for(uint32_t i = 0; i < n; ++i)
         {
@@ -68,15 +54,10 @@ void SkinnedMeshRenderer::bindPerObject()
             Matrix4x4 m = jointWorld * invWorld * skin->inverseBind[i];
 
             // CB用 3x4 に圧縮
-            constantBuffer->bones[i] = BoneMat3x4::FromMatrix4x4(m);
+            bones[i] = BoneMat3x4::FromMatrix4x4(m);
         }
     }
-
-    D3DManager::getInstance()->GetContext()->UpdateSubresource(constantBufferPerObject.Get(), 0, nullptr, constantBuffer.get(), 0, 0);
-
-    // 定数バッファ更新
-    ID3D11Buffer* cbs[1] = { constantBufferPerObject.Get() };
-    D3DManager::getInstance()->GetContext()->VSSetConstantBuffers(CB_PerObject, 1, cbs);
+    return object;
 }
 
 
@@ -0,0 +1,145 @@
+﻿#include "pch.h"
+#include <UniDx/StringId.h>
+
+#include <cstring>
+
+
+namespace UniDx{
+
+namespace
+{
+    constexpr size_t InitialCapacity = 256;     // シャードごとの表の初期サイズ
+    constexpr int ShardShift = 60;              // ハッシュの上位4bitでシャードを選ぶ
+
+    size_t shardOf(size_t hash)
+    {
+        if constexpr (sizeof(size_t) == 8) return (hash >> ShardShift) & (InternPool::ShardCount - 1);
+        else return (hash >> 28) & (InternPool::ShardCount - 1);
+    }
+}
+
+
+InternPool::InternPool()
+{
+    for (auto& shard : shards_)
+    {
+        Table* table = createTable(InitialCapacity);
+        shard.tables.push_back(table);
+        shard.table.store(table, std::memory_order_release);
+    }
+}
+
+
+InternPool::~InternPool()
+{
+    for (auto& shard : shards_)
+    {
+        for (Table* table : shard.tables)
+        {
+            delete[] table->slots;
+            delete table;
+        }
+    }
+}
+
+
+StringId InternPool::intern(std::u8string_view sv)
+{
+    if (sv.empty()) return StringId();
+
+    const size_t hash = std::hash<std::u8string_view>{}(sv);
+    Shard& shard = shards_[shardOf(hash)];
+
+    // ロックなしで探す
+    if (const Entry* e = find(shard.table.load(std::memory_order_acquire), hash, sv))
+    {
+        return StringId(e->data(), e->size);
+    }
+
+    std::lock_guard lock(shard.mtx);
+
+    // ロック待ちの間に他のスレッドが追加しているかもしれない
+    Table* table = shard.table.load(std::memory_order_relaxed);
+    if (const Entry* e = find(table, hash, sv))
+    {
+        return StringId(e->data(), e->size);
+    }
+
+    // 半分を超えたら倍の表を作って差し替える
+    if ((shard.count + 1) * 2 > table->capacity)
+    {
+        Table* grown = createTable(table->capacity * 2);
+        for (size_t i = 0; i < table->capacity; ++i)
+        {
+            if (const Entry* e = table->slots[i].load(std::memory_order_relaxed)) insert(grown, e);
+        }
+        shard.tables.push_back(grown);
+        shard.table.store(grown, std::memory_order_release);
+        table = grown;
+    }
+
+    // 新規に arena に確保して登録
+    void* p = shard.arena.allocate(sizeof(Entry) + sv.size() + 1, alignof(Entry));
+    Entry* entry = new (p) Entry{ hash, sv.size() };
+    std::memcpy(entry->data(), sv.data(), sv.size());
+    entry->data()[sv.size()] = u8'\0';
+    insert(table, entry);
+    ++shard.count;
+
+    return StringId(entry->data(), entry->size);
+}
+
+
+void InternPool::Log() const
+{
+    for (auto& shard : shards_)
+    {
+        const Table* table = shard.table.load(std::memory_order_acquire);
+        for (size_t i = 0; i < table->capacity; ++i)
+        {
+            if (const Entry* e = table->slots[i].load(std::memory_order_acquire))
+            {
+                Debug::Log(e->data());
+            }
+        }
+    }
+}
+
+
+// 線形探査。空きに当たったら見つからない
+const InternPool::Entry* InternPool::find(const Table* table, size_t hash, std::u8string_view sv)
+{
+    const size_t mask = table->capacity - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+        const Entry* e = table->slots[i].load(std::memory_order_acquire);
+        if (e == nullptr) return nullptr;
+        if (e->hash == hash && e->size == sv.size() && std::memcmp(e->data(), sv.data(), sv.size()) == 0) return e;
+    }
+}
+
+
+InternPool::Table* InternPool::createTable(size_t capacity)
+{
+    Table* table = new Table{ capacity, new std::atomic<const Entry*>[capacity] };
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        table->slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+    return table;
+}
+
+
+// 書き込みはシャードのロック中だけ。読む側には release で公開する
+void InternPool::insert(Table* table, const Entry* entry)
+{
+    const size_t mask = table->capacity - 1;
+    size_t i = entry->hash & mask;
+    while (table->slots[i].load(std::memory_order_relaxed) != nullptr)
+    {
+        i = (i + 1) & mask;
+    }
+    table->slots[i].store(entry, std::memory_order_release);
+}
+
+}
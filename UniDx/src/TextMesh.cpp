@@ -1,37 +1,21 @@
 ﻿#include "pch.h"
 
 #include <UniDx/TextMesh.h>
-#include <UniDx/D3DManager.h>
 #include <UniDx/Font.h>
-
-using namespace DirectX;
+#include <UniDx/RenderPacket.h>
 
 namespace UniDx {
 
 
-void TextMesh::Awake()
+void TextMesh::buildPackets(RenderPacketBuilder& builder) const
 {
-	UIBehaviour::Awake();
-	spriteBatch = std::make_unique<SpriteBatch>(D3DManager::getInstance()->GetContext().Get());
-}
-
-
-void TextMesh::render(const Matrix4x4& proj) const
-{
-	UIBehaviour::render(proj);
-    if(spriteBatch == nullptr || font == nullptr || font->getSpriteFont() == nullptr) return;
-
-    // SpriteFontを使った描画
-    spriteBatch->Begin();
+	UIBehaviour::buildPackets(builder);
+    if(font == nullptr) return;
 
+    // SpriteFontを使った描画は描画スレッドで行う。SpriteBatch はバックエンドが持つ
     Vector3 pos = transform->position;
     Vector3 scale = transform->localScale; // 現状はローカルスケールのみ
-    Vector2 drawPos(pos.x, pos.y);
-    font->getSpriteFont()->DrawString(
-        spriteBatch.get(), ToUtf16(text).c_str(), drawPos, color.XMLoad(), 0.0f, Vector2::zero,
-        Vector2(scale.x, scale.y) );
-
-    spriteBatch->End();
+    builder.addText(font, ToUtf16(text), Vector2(pos.x, pos.y), Vector2(scale.x, scale.y), color);
 }
 
 }
@@ -9,6 +9,8 @@
 namespace UniDx
 {
 
+#if UNIDX_D3D11
+
 void Texture::ensureSampler_()
 {
     if (!samplerState)
@@ -35,6 +37,9 @@ void Texture::ensureSampler_()
 
 bool Texture::Load(const u8string& filePath)
 {
+	UNIDX_PROFILE_SCOPE("Asset/Texture");
+	if (D3DManager::isHeadless()) return false; // GPUに置けないので読まない
+
 	// WIC画像を読み込む
 	auto image = std::make_unique<DirectX::ScratchImage>();
 	if (FAILED(DirectX::LoadFromWICFile(ToUtf16(filePath).c_str(), DirectX::WIC_FLAGS_NONE, &m_info, *image)))
@@ -75,7 +80,7 @@ bool Texture::Load(const u8string& filePath)
 
 bool Texture::LoadFromMemoryRGBA8(const void* pixels, int width, int height, bool isSRGB)
 {
-    if (!pixels || width <= 0 || height <= 0)
+    if (!pixels || width <= 0 || height <= 0 || D3DManager::isHeadless())
     {
         m_info = {};
         m_srv.Reset();
@@ -143,4 +148,14 @@ void Texture::bind() const
 	D3DManager::getInstance()->GetContext()->PSSetSamplers(UNIDX_PS_SLOT_ALBEDO, 1, &pState);
 }
 
+#else
+
+// Direct3D のない環境ではGPUに置けないので読まない
+void Texture::ensureSampler_() {}
+bool Texture::Load(const u8string&) { return false; }
+bool Texture::LoadFromMemoryRGBA8(const void*, int, int, bool) { return false; }
+void Texture::bind() const {}
+
+#endif
+
 }
\ No newline at end of file
@@ -1,160 +1,160 @@
 ﻿#include "pch.h"
 
-#include <SimpleMath.h>
+#include <UniDx/Scene.h>
 
 namespace UniDx
 {
 
+namespace
+{
+    // forward を +Z、up に近い向きを +Y にする回転の行列を作る（左手系）
+    // SimpleMath の Matrix::CreateWorld は右手系で -Z を前にするので使わない
+    Matrix4x4 lookRotation(const Vector3& forward, const Vector3& up)
+    {
+        const Vector3 z = forward.normalized();
+        const Vector3 x = Cross(up, z).normalized();
+        const Vector3 y = Cross(z, x);
+        return Matrix4x4(
+            x.x, x.y, x.z, 0.0f,
+            y.x, y.y, y.z, 0.0f,
+            z.x, z.y, z.z, 0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f);
+    }
+}
+
 // コンストラクタ
 Transform::Transform()
-    : localPosition(
-        [this]() { return _localPosition; },
-        [this](Vector3 v) { _localPosition = v; m_dirty = true; }
-    ),
-    localRotation(
-        [this]() { return _localRotation; },
-        [this](Quaternion q) { _localRotation = q; m_dirty = true; }
-    ),
-    localScale(
-        [this]() { return _localScale; },
-        [this](Vector3 v) { _localScale = v; m_dirty = true; }
-    ),
-    position(
-        // getter: グローバル座標
-        [this]() {
-            updateMatrices();
-            return m_worldMatrix.translation();
-        },
-        // setter: グローバル座標からlocalPositionを逆算
-        [this](Vector3 worldPos) {
-            if (parent) {
-                parent->updateMatrices();
-                Matrix4x4 invParent = parent->m_worldMatrix.inverse();
-                _localPosition = worldPos * invParent;
-            }
-            else {
-                _localPosition = worldPos;
-            }
-            m_dirty = true;
-        }
-    ),
-    rotation(
-        [this]() {
-            updateMatrices();
-            // ワールド行列からクォータニオンを取得
-            Vector3 s, t;
-            Quaternion q;
-            m_worldMatrix.Decompose(s, q, t);
-            return q;
-        },
-        [this](Quaternion worldRot) {
-            if (parent) {
-                parent->updateMatrices();
-                // 親のワールド回転の逆を掛けてローカル回転を算出
-                Quaternion parentWorldRot, parentWorldRotInv;
-                Vector3 s, t;
-                parent->m_worldMatrix.Decompose(s, parentWorldRot, t);
-                parentWorldRotInv = Inverse(parentWorldRot);
-                _localRotation = worldRot * parentWorldRotInv;
-            }
-            else {
-                _localRotation = worldRot;
-            }
-            m_dirty = true;
-        }
-    ),
-    forward(
-        // getter: ワールド空間の前方向
-        [this]() {
-            return TransformDirection(Vector3::forward);
-        },
-        // setter: worldForward に向くようワールド回転を設定
-        [this](Vector3 worldForward) {
-            if (worldForward.magnitude() < 1e-6f) return;
-            Vector3 f = worldForward.normalized();
-
-            // up が前方向とほぼ平行なら代替 up を使う
-            Vector3 up = Vector3::up;
-            if (std::abs(Dot(f, up)) > 0.999f) up = Vector3::right;
-
-            // CreateWorld の引数は (position, forward, up)
-            Matrix4x4 m = DirectX::SimpleMath::Matrix::CreateWorld(Vector3::zero, f, up);
-            Vector3 s, t;
-            Quaternion q;
-            m.Decompose(s, q, t);
-            rotation = q; // rotation プロパティの setter を使ってローカル回転を設定
-        }
-    ),
-    up(
-        // getter: ワールド空間の上方向
-        [this]() {
-            return TransformDirection(Vector3::up);
-        },
-        // setter: worldUp に向くようワールド回転を設定（可能な限り現在の forward を保持）
-        [this](Vector3 worldUp) {
-            if (worldUp.magnitude() < 1e-6f) return;
-            Vector3 upVec = worldUp.normalized();
-
-            // 現在の forward を取得（ワールド）
-            Vector3 currF = TransformDirection(Vector3::forward);
-
-            // 右方向を計算（forward x up）
-            Vector3 right = Cross(currF, upVec);
-            if (right.magnitude() < 1e-6f) {
-                // forward と up がほぼ平行 -> 別の基準を使う
-                currF = Vector3::forward;
-                right = Cross(currF, upVec);
-            }
-
-            // 再計算した forward を正規化
-            Vector3 f = Cross(upVec, right.normalized()).normalized();
-
-            Matrix4x4 m = DirectX::SimpleMath::Matrix::CreateWorld(Vector3::zero, f, upVec);
-            Vector3 s, t;
-            Quaternion q;
-            m.Decompose(s, q, t);
-            rotation = q;
-        }
-    ),
-    right(
-        // getter: ワールド空間の右方向
-        [this]() {
-            return TransformDirection(Vector3::right);
-        },
-        // setter: worldRight に向くようワールド回転を設定（可能な限り現在の up を保持）
-        [this](Vector3 worldRight) {
-            if (worldRight.magnitude() < 1e-6f) return;
-            Vector3 rVec = worldRight.normalized();
-
-            // 現在の up を取得（ワールド）
-            Vector3 currUp = TransformDirection(Vector3::up);
-
-            // forward を計算 (up x right)
-            Vector3 f = Cross(currUp, rVec);
-            if (f.magnitude() < 1e-6f) {
-                // up と right がほぼ平行 -> 別の基準を使う
-                currUp = Vector3::up;
-                f = Cross(currUp, rVec).normalized();
-            }
-
-            // 再計算した up を正規化
-            Vector3 upVec = Cross(rVec, f).normalized();
-
-            Matrix4x4 m = DirectX::SimpleMath::Matrix::CreateWorld(Vector3::zero, f, upVec);
-            Vector3 s, t;
-            Quaternion q;
-            m.Decompose(s, q, t);
-            rotation = q;
-        }
-    )
 {
 }
 
+
+// setter: グローバル座標からlocalPositionを逆算
+void Transform::setPosition(const Vector3& worldPos)
+{
+    if (parent) {
+        Matrix4x4 invParent = parent->localToWorldMatrix().inverse();
+        _localPosition = worldPos * invParent;
+    }
+    else {
+        _localPosition = worldPos;
+    }
+    markDirty();
+}
+
+
+Quaternion Transform::getRotation() const
+{
+    // ワールド行列からクォータニオンを取得
+    Vector3 s, t;
+    Quaternion q;
+    Matrix4x4 m = localToWorldMatrix();
+    m.Decompose(s, q, t);
+    return q;
+}
+
+
+void Transform::setRotation(const Quaternion& worldRot)
+{
+    if (parent) {
+        // 親のワールド回転の逆を掛けてローカル回転を算出
+        Quaternion parentWorldRot, parentWorldRotInv;
+        Vector3 s, t;
+        Matrix4x4 parentWorld = parent->localToWorldMatrix();
+        parentWorld.Decompose(s, parentWorldRot, t);
+        parentWorldRotInv = Inverse(parentWorldRot);
+        _localRotation = worldRot * parentWorldRotInv;
+    }
+    else {
+        _localRotation = worldRot;
+    }
+    markDirty();
+}
+
+
+// setter: worldForward に向くようワールド回転を設定
+void Transform::setForward(const Vector3& worldForward)
+{
+    if (worldForward.magnitude() < 1e-6f) return;
+    Vector3 f = worldForward.normalized();
+
+    // up が前方向とほぼ平行なら代替 up を使う
+    Vector3 up = Vector3::up;
+    if (std::abs(Dot(f, up)) > 0.999f) up = Vector3::right;
+
+    Matrix4x4 m = lookRotation(f, up);
+    Vector3 s, t;
+    Quaternion q;
+    m.Decompose(s, q, t);
+    setRotation(q);
+}
+
+
+// setter: worldUp に向くようワールド回転を設定（可能な限り現在の forward を保持）
+void Transform::setUp(const Vector3& worldUp)
+{
+    if (worldUp.magnitude() < 1e-6f) return;
+    Vector3 upVec = worldUp.normalized();
+
+    // 現在の forward を取得（ワールド）
+    Vector3 currF = TransformDirection(Vector3::forward);
+
+    // 右方向を計算（forward x up）
+    Vector3 right = Cross(currF, upVec);
+    if (right.magnitude() < 1e-6f) {
+        // forward と up がほぼ平行 -> 別の基準を使う
+        currF = std::abs(Dot(upVec, Vector3::forward)) > 0.999f ? Vector3::up : Vector3::forward;
+        right = Cross(currF, upVec);
+    }
+
+    // 再計算した forward を正規化
+    Vector3 f = Cross(upVec, right.normalized()).normalized();
+
+    Matrix4x4 m = lookRotation(f, upVec);
+    Vector3 s, t;
+    Quaternion q;
+    m.Decompose(s, q, t);
+    setRotation(q);
+}
+
+
+// setter: worldRight に向くようワールド回転を設定（可能な限り現在の up を保持）
+void Transform::setRight(const Vector3& worldRight)
+{
+    if (worldRight.magnitude() < 1e-6f) return;
+    Vector3 rVec = worldRight.normalized();
+
+    // 現在の up を取得（ワールド）
+    Vector3 currUp = TransformDirection(Vector3::up);
+
+    // forward を計算 (right x up)
+    Vector3 f = Cross(rVec, currUp);
+    if (f.magnitude() < 1e-6f) {
+        // up と right がほぼ平行 -> 別の基準を使う
+        currUp = std::abs(Dot(rVec, Vector3::up)) > 0.999f ? Vector3::forward : Vector3::up;
+        f = Cross(rVec, currUp);
+    }
+    f = f.normalized();
+
+    // 再計算した up を正規化
+    Vector3 upVec = Cross(f, rVec).normalized();
+
+    Matrix4x4 m = lookRotation(f, upVec);
+    Vector3 s, t;
+    Quaternion q;
+    m.Decompose(s, q, t);
+    setRotation(q);
+}
+
 Transform::~Transform()
 {
-    for (auto& child : children)
+    // 階層配列に残っているポインタを使わせない
+    if (hierarchy_) hierarchy_->invalidate();
+
+    // 子は追加した順に削除する
+    while (firstChild_ != nullptr)
     {
-        if (child) child->transform->parent = nullptr;
+        unique_ptr<GameObject> child = unlinkChild(firstChild_);
+        child.reset();
     }
 }
 
@@ -176,29 +176,29 @@ GameObject* Transform::SetParent(Transform * newParent)
         abort();
         return nullptr;
     }
-    auto& siblings = parent->children;
 
     // 以前の親からGameObjectのスマートポインタを所有権ごと移動
-    auto it = std::find_if(
-        siblings.begin(), siblings.end(),
-        [this](const unique_ptr<GameObject>& ptr) { return ptr->transform == this; });
-    assert(it != siblings.end());
-
-    GameObject* gameObject_ptr = it->get();
+    unique_ptr<GameObject> self = parent->unlinkChild(this);
+    GameObject* gameObject_ptr = self.get();
     assert(gameObject_ptr != nullptr);
 
-    // 元の親から削除
-    siblings.erase(it);
-
-    // 新しい親を設定
-    parent = newParent;
-
-    if (parent)
+    if (newParent)
     {
         // 新しい親に自分を持つGameObjectを追加
-        parent->children.push_back(std::move(*it));
+        gameObject_ptr->setSceneInHierarchy(newParent->gameObject->scene());
+        newParent->linkChild(std::move(self));
     }
-    m_dirty = true;
+    else if (Scene* scene = gameObject_ptr->scene())
+    {
+        // 親がなくなったのでシーンのルートに移す
+        scene->addRootGameObject(std::move(self));
+    }
+    else
+    {
+        // 所有者がいないので削除
+        return nullptr;
+    }
+    markDirty();
 
     return gameObject_ptr;
 }
@@ -214,13 +214,14 @@ void Transform::SetParent(unique_ptr<GameObject> gameObjectPtr, Transform* newPa
         return;
     }
 
-    // 新しい親を設定
-    gameObjectPtr->transform->parent = newParent;
-    gameObjectPtr->transform->m_dirty = true;
+    gameObjectPtr->transform->markDirty();
     if (newParent)
     {
+        // 新しい親のシーンに所属させる
+        gameObjectPtr->setSceneInHierarchy(newParent->gameObject->scene());
+
         // 新しい親に自分を持つGameObjectを追加
-        newParent->children.push_back(std::move(gameObjectPtr));
+        newParent->linkChild(std::move(gameObjectPtr));
     }
 }
 
@@ -228,48 +229,120 @@ void Transform::SetParent(unique_ptr<GameObject> gameObjectPtr, Transform* newPa
 // 子を取得
 Transform* Transform::GetChild(size_t index) const
 {
-    if (index < children.size() && children[index]) {
-        return children[index]->transform;
+    if (index >= childCount_) return nullptr;
+
+    Transform* t = firstChild_;
+    for (size_t i = 0; i < index; ++i)
+    {
+        t = t->nextSibling_;
     }
-    return nullptr;
+    return t;
+}
+
+
+// 子リストの末尾に追加
+void Transform::linkChild(unique_ptr<GameObject> child)
+{
+    Transform* t = child->transform;
+    assert(t->parent == nullptr && t->prevSibling_ == nullptr && t->nextSibling_ == nullptr);
+
+    t->parent = this;
+    t->prevSibling_ = lastChild_;
+    if (lastChild_) lastChild_->nextSibling_ = t;
+    else firstChild_ = t;
+    lastChild_ = t;
+    ++childCount_;
+
+    child.release(); // 以降はリンクが所有する（unlinkChild() で取り戻す）
+}
+
+
+// 子リストから外す
+unique_ptr<GameObject> Transform::unlinkChild(Transform* child)
+{
+    assert(child->parent == this);
+
+    if (child->prevSibling_) child->prevSibling_->nextSibling_ = child->nextSibling_;
+    else firstChild_ = child->nextSibling_;
+    if (child->nextSibling_) child->nextSibling_->prevSibling_ = child->prevSibling_;
+    else lastChild_ = child->prevSibling_;
+    child->prevSibling_ = nullptr;
+    child->nextSibling_ = nullptr;
+    child->parent = nullptr;
+    --childCount_;
+
+    return unique_ptr<GameObject>(child->gameObject);
 }
 
 const Matrix4x4& Transform::localMatrix() const
 {
-    if (m_dirty) {
-        m_localMatrix = DirectX::SimpleMath::Matrix::CreateScale(_localScale.x, _localScale.y, _localScale.z)
-            * DirectX::SimpleMath::Matrix::CreateFromQuaternion(DirectX::XMFLOAT4(_localRotation))
-            * DirectX::SimpleMath::Matrix::CreateTranslation(_localPosition.x, _localPosition.y, _localPosition.z);
+    if (m_localDirty) {
+        m_localMatrix = Matrix4x4::Scale(_localScale)
+            * Matrix4x4::Rotate(_localRotation)
+            * Matrix4x4::Translate(_localPosition);
+        m_localDirty = false;
     }
     return m_localMatrix;
 }
 
 
+// ローカルが変わったのでサブツリーをダーティにする
+void Transform::markDirty()
+{
+    m_localDirty = true;
+    markWorldDirty();
+}
+
+
+void Transform::markWorldDirty()
+{
+    // すでにダーティならサブツリーもダーティなので打ち切る
+    if (m_worldDirty) return;
+
+    m_worldDirty = true;
+    for (Transform* c = firstChild_; c != nullptr; c = c->nextSibling_)
+    {
+        c->markWorldDirty();
+    }
+}
+
+
 // 行列を更新
+// ダーティな祖先だけをたどる（クリーンなノードの親は必ずクリーン）
 void Transform::updateMatrices() const
 {
+    if (!m_worldDirty) return;
+
     if (parent) {
         parent->updateMatrices();
+        updateWorldMatrix(&parent->m_worldMatrix);
     }
+    else {
+        updateWorldMatrix(nullptr);
+    }
+}
+
+
+void Transform::updateWorldMatrix(const Matrix4x4* parentWorld) const
+{
+    if (parentWorld) {
+        m_worldMatrix = localMatrix() * *parentWorld;
+    }
+    else {
+        m_worldMatrix = localMatrix();
+    }
+    m_worldDirty = false;
+    m_worldChanged = true;
+}
 
-    if (m_dirty)
+
+// シーンの階層配列から外す
+void Transform::leaveHierarchy()
+{
+    if (hierarchy_)
     {
-        m_localMatrix = DirectX::SimpleMath::Matrix::CreateScale(_localScale)
-            * DirectX::SimpleMath::Matrix::CreateFromQuaternion(DirectX::XMFLOAT4(_localRotation))
-            * DirectX::SimpleMath::Matrix::CreateTranslation(_localPosition);
-        if (parent) {
-            m_worldMatrix = m_localMatrix * parent->m_worldMatrix;
-        }
-        else {
-            m_worldMatrix = m_localMatrix;
-        }
-        m_dirty = false;
-
-        // 親の行列が変わったので、子も変わるように
-        for (auto& c : children)
-        {
-            c->transform->m_dirty = true;
-        }
+        hierarchy_->invalidate();
+        hierarchy_ = nullptr;
     }
 }
 
@@ -0,0 +1,91 @@
+﻿#include "pch.h"
+#include <UniDx/TransformHierarchy.h>
+
+#include <UniDx/Scene.h>
+#include <UniDx/Jobs.h>
+
+
+namespace UniDx{
+
+// ダーティなTransformのワールド行列を深さ順に更新
+void TransformHierarchy::update()
+{
+    if (structureDirty_)
+    {
+        rebuild();
+    }
+
+    // 親は必ず前の深さにあるので、深さ順に1回なめるだけで済む
+    // 同じ深さの中は親の行列を読むだけなので分割して並列に更新できる
+    for (size_t level = 0; level + 1 < levels_.size(); ++level)
+    {
+        const size_t begin = levels_[level];
+        const size_t end = levels_[level + 1];
+        Jobs::parallelForAndWait(end - begin, BatchSize, [this, begin](size_t b, size_t e) {
+            updateRange(begin + b, begin + e);
+        });
+    }
+}
+
+
+void TransformHierarchy::updateRange(size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        const Transform* t = nodes_[i];
+        if (t->m_worldDirty)
+        {
+            int p = parents_[i];
+            t->updateWorldMatrix(p >= 0 ? &worldMatrices_[p] : nullptr);
+        }
+
+        // getterで先に更新されていた分も含めて配列へ反映
+        if (t->m_worldChanged)
+        {
+            worldMatrices_[i] = t->m_worldMatrix;
+            t->m_worldChanged = false;
+        }
+    }
+}
+
+
+// シーンのGameObjectを幅優先でたどって深さ順に並べ直す
+void TransformHierarchy::rebuild()
+{
+    nodes_.clear();
+    parents_.clear();
+    levels_.clear();
+
+    auto push = [this](Transform* t, int parentIndex) {
+        t->hierarchy_ = this;
+        t->m_worldChanged = true; // 配列を作り直したので全て反映する
+        nodes_.push_back(t);
+        parents_.push_back(parentIndex);
+    };
+
+    for (auto& root : scene_->GetRootGameObjects())
+    {
+        if (root) push(root->transform, -1);
+    }
+    // 幅優先なので深さごとに連続して並ぶ。1つ前の深さの子を積んだところが次の深さの境目
+    levels_.push_back(0);
+    size_t levelEnd = nodes_.size();
+    for (size_t i = 0; i < nodes_.size(); ++i)
+    {
+        if (i == levelEnd)
+        {
+            levels_.push_back(i);
+            levelEnd = nodes_.size();
+        }
+        for (GameObject* child : nodes_[i]->getChildGameObjects())
+        {
+            push(child->transform, int(i));
+        }
+    }
+    levels_.push_back(nodes_.size());
+
+    worldMatrices_.resize(nodes_.size());
+    structureDirty_ = false;
+}
+
+}
@@ -1,11 +1,14 @@
 ﻿#include "pch.h"
 
+#ifdef _WIN32
 #include <Windows.h>
+#endif
 
 
 namespace UniDx
 {
 
+#ifdef _WIN32
 u8string ToUtf8(std::wstring_view wstr)
 {
     if (wstr.empty()) return {};
@@ -24,5 +27,59 @@ std::wstring ToUtf16(u8string_view str)
     MultiByteToWideChar(CP_UTF8, 0, cp, (int)str.size(), &strTo[0], size_needed);
     return strTo;
 }
+#else
+// Windows 以外は wchar_t が 32bit なので、UTF-32 との間で変換する
+u8string ToUtf8(std::wstring_view wstr)
+{
+    u8string strTo;
+    strTo.reserve(wstr.size());
+    for (wchar_t wc : wstr)
+    {
+        const uint32_t c = static_cast<uint32_t>(wc);
+        if (c < 0x80)
+        {
+            strTo.push_back(char8_t(c));
+        }
+        else if (c < 0x800)
+        {
+            strTo.push_back(char8_t(0xC0 | (c >> 6)));
+            strTo.push_back(char8_t(0x80 | (c & 0x3F)));
+        }
+        else if (c < 0x10000)
+        {
+            strTo.push_back(char8_t(0xE0 | (c >> 12)));
+            strTo.push_back(char8_t(0x80 | ((c >> 6) & 0x3F)));
+            strTo.push_back(char8_t(0x80 | (c & 0x3F)));
+        }
+        else
+        {
+            strTo.push_back(char8_t(0xF0 | (c >> 18)));
+            strTo.push_back(char8_t(0x80 | ((c >> 12) & 0x3F)));
+            strTo.push_back(char8_t(0x80 | ((c >> 6) & 0x3F)));
+            strTo.push_back(char8_t(0x80 | (c & 0x3F)));
+        }
+    }
+    return strTo;
+}
+
+std::wstring ToUtf16(u8string_view str)
+{
+    std::wstring strTo;
+    strTo.reserve(str.size());
+    for (size_t i = 0; i < str.size();)
+    {
+        const uint32_t b = str[i];
+        const size_t len = b < 0x80 ? 1 : b < 0xE0 ? 2 : b < 0xF0 ? 3 : 4;
+        uint32_t c = len == 1 ? b : len == 2 ? (b & 0x1F) : len == 3 ? (b & 0x0F) : (b & 0x07);
+        for (size_t k = 1; k < len && i + k < str.size(); ++k)
+        {
+            c = (c << 6) | (uint32_t(str[i + k]) & 0x3F);
+        }
+        strTo.push_back(wchar_t(c));
+        i += len;
+    }
+    return strTo;
+}
+#endif
 
 }
@@ -0,0 +1,218 @@
+﻿#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "TestScene.h"
+#include <UniDx/CharacterController.h>
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+
+
+namespace
+{
+
+// 原点のキャラクターと、x = 4 の 1m の箱
+std::unique_ptr<Scene> wallScene()
+{
+    auto controller = std::make_unique<CharacterController>();
+    controller->center = Vector3(0.0f, 0.0f, 2.0f);
+    controller->stepOffset = 0.0f;
+    return std::make_unique<Scene>(
+        std::make_unique<GameObject>(u8"Character", Vector3(0.0f, 0.0f, 0.0f), std::move(controller)),
+        std::make_unique<GameObject>(u8"Wall", Vector3(4.0f, 0.0f, 0.0f), std::make_unique<AABBCollider>()));
+}
+
+CharacterController* character()
+{
+    return UniDxTest::findObject(u8"Character")->GetComponent<CharacterController>();
+}
+
+std::unique_ptr<GameObject> box(const char8_t* name, Vector3 position, Vector3 halfSize)
+{
+    auto collider = std::make_unique<AABBCollider>();
+    collider->size = halfSize;
+    return std::make_unique<GameObject>(name, position, std::move(collider));
+}
+
+// 上面が y = 0 の床
+std::unique_ptr<GameObject> floorBox()
+{
+    return box(u8"Floor", Vector3(0.0f, -0.5f, 0.0f), Vector3(20.0f, 0.5f, 20.0f));
+}
+
+std::unique_ptr<GameObject> characterAt(Vector3 position, float stepOffset = 0.3f, float slopeLimit = 45.0f)
+{
+    auto controller = std::make_unique<CharacterController>();
+    controller->stepOffset = stepOffset;
+    controller->slopeLimit = slopeLimit;
+    return std::make_unique<GameObject>(u8"Character", position, std::move(controller));
+}
+
+// 床の上のキャラクターと、x = 2～4 にある高さ ledgeHeight の段
+std::function<std::unique_ptr<Scene>()> ledgeScene(float ledgeHeight, float stepOffset)
+{
+    return [=]() {
+        return std::make_unique<Scene>(
+            floorBox(),
+            box(u8"Ledge", Vector3(3.0f, ledgeHeight * 0.5f, 0.0f), Vector3(1.0f, ledgeHeight * 0.5f, 1.0f)),
+            characterAt(Vector3(0.0f, 0.52f, 0.0f), stepOffset));
+    };
+}
+
+// 半径 5 の球の上で、真上から slopeDegrees 傾いた位置に立つキャラクター
+std::function<std::unique_ptr<Scene>()> hillScene(float slopeDegrees, float slopeLimit)
+{
+    return [=]() {
+        auto hill = std::make_unique<SphereCollider>();
+        hill->radius = 5.0f;
+        const float r = 5.0f + 0.5f + 0.05f;
+        const float a = slopeDegrees * Deg2Rad;
+        return std::make_unique<Scene>(
+            std::make_unique<GameObject>(u8"Hill", Vector3(0.0f, 0.0f, 0.0f), std::move(hill)),
+            characterAt(Vector3(r * std::sin(a), r * std::cos(a), 0.0f), 0.0f, slopeLimit));
+    };
+}
+
+Vector3 positionOf(CharacterController* c)
+{
+    return c->transform->position;
+}
+
+// 重力のように下向きの移動を加えながら、毎回 (dx, 0, 0) ずつ歩かせる
+void walk(CharacterController* c, float dx, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        c->Move(Vector3(dx, -0.1f, 0.0f));
+    }
+}
+
+} // namespace
+
+
+TEST(CharacterController, CenterIsInLocalSpace)
+{
+    HeadlessLoop loop(wallScene);
+    loop.step(1);
+
+    // 回転していなければ球は z = 2 にあり、箱の横を通り抜ける
+    CharacterController* c = character();
+    c->Move(Vector3(2.0f, 0.0f, 0.0f));
+    EXPECT_NEAR(c->transform->position.get().x, 2.0f, 1e-4f);
+
+    // y 軸で 90 度回すと球は x の正の側に来て、箱に当たって止まる
+    c->transform->position = Vector3(0.0f, 0.0f, 0.0f);
+    c->transform->rotation = Quaternion::AngleAxis(90.0f, Vector3::up);
+    CollisionFlags flags = c->Move(Vector3(2.0f, 0.0f, 0.0f));
+
+    EXPECT_NE(flags & CollisionFlags_Sides, 0);
+    EXPECT_NEAR(c->transform->position.get().x, 3.5f - c->radius - 2.0f, c->skinWidth + 1e-3f);
+    EXPECT_NEAR(c->transform->position.get().z, 0.0f, 1e-4f);
+}
+
+
+// 宙に浮いているあいだは接地せず、床に着いたら接地する
+TEST(CharacterController, ReportsGroundedAfterLanding)
+{
+    HeadlessLoop loop([]() { return std::make_unique<Scene>(floorBox(), characterAt(Vector3(0.0f, 2.0f, 0.0f))); });
+    loop.step(2);
+
+    CharacterController* c = character();
+    c->Move(Vector3(0.0f, -0.1f, 0.0f));
+    EXPECT_FALSE(c->isGrounded());
+
+    for (int i = 0; i < 30; ++i)
+    {
+        c->Move(Vector3(0.0f, -0.1f, 0.0f));
+    }
+    EXPECT_TRUE(c->isGrounded());
+    EXPECT_NE(c->collisionFlags() & CollisionFlags_Below, 0);
+    EXPECT_NEAR(positionOf(c).y, c->radius, c->skinWidth + 1e-3f);
+
+    // 平らな床を歩いているあいだも接地したまま
+    walk(c, 0.1f, 10);
+    EXPECT_TRUE(c->isGrounded());
+    EXPECT_NEAR(positionOf(c).x, 1.0f, 1e-3f);
+}
+
+
+// stepOffset より低い段は登り、高い段では止まる
+TEST(CharacterController, StepOffsetClimbsLowLedge)
+{
+    HeadlessLoop loop(ledgeScene(0.2f, 0.3f));
+    loop.step(2);
+
+    CharacterController* c = character();
+    c->Move(Vector3(0.0f, -0.1f, 0.0f));
+    ASSERT_TRUE(c->isGrounded());
+
+    walk(c, 0.1f, 30);
+    EXPECT_NEAR(positionOf(c).x, 3.0f, 1e-3f);
+    EXPECT_NEAR(positionOf(c).y, 0.2f + c->radius, c->skinWidth + 1e-3f);
+    EXPECT_TRUE(c->isGrounded());
+}
+
+
+TEST(CharacterController, StepOffsetStopsAtTallLedge)
+{
+    HeadlessLoop loop(ledgeScene(0.6f, 0.3f));
+    loop.step(2);
+
+    CharacterController* c = character();
+    c->Move(Vector3(0.0f, -0.1f, 0.0f));
+    ASSERT_TRUE(c->isGrounded());
+
+    walk(c, 0.1f, 30);
+    EXPECT_LT(positionOf(c).x, 2.0f);
+    EXPECT_NEAR(positionOf(c).y, c->radius, c->skinWidth + 1e-3f);
+    EXPECT_NE(c->collisionFlags() & CollisionFlags_Sides, 0);
+}
+
+
+// stepOffset が 0 なら低い段でも登らない
+TEST(CharacterController, ZeroStepOffsetDoesNotClimb)
+{
+    HeadlessLoop loop(ledgeScene(0.2f, 0.0f));
+    loop.step(2);
+
+    CharacterController* c = character();
+    c->Move(Vector3(0.0f, -0.1f, 0.0f));
+    walk(c, 0.1f, 30);
+    EXPECT_LT(positionOf(c).x, 2.0f);
+    EXPECT_NEAR(positionOf(c).y, c->radius, c->skinWidth + 1e-3f);
+}
+
+
+// slopeLimit より急な斜面では立っていられずに滑り落ちる
+TEST(CharacterController, SlidesDownSlopeSteeperThanLimit)
+{
+    HeadlessLoop loop(hillScene(60.0f, 45.0f));
+    loop.step(2);
+
+    CharacterController* c = character();
+    const Vector3 start = positionOf(c);
+    for (int i = 0; i < 10; ++i)
+    {
+        c->Move(Vector3(0.0f, -0.1f, 0.0f));
+    }
+    EXPECT_FALSE(c->isGrounded());
+    EXPECT_GT(positionOf(c).x, start.x + 0.1f);
+}
+
+
+// 同じ斜面でも slopeLimit 以下なら接地して止まる
+TEST(CharacterController, StandsOnSlopeWithinLimit)
+{
+    HeadlessLoop loop(hillScene(60.0f, 70.0f));
+    loop.step(2);
+
+    CharacterController* c = character();
+    const Vector3 start = positionOf(c);
+    for (int i = 0; i < 10; ++i)
+    {
+        c->Move(Vector3(0.0f, -0.1f, 0.0f));
+    }
+    EXPECT_TRUE(c->isGrounded());
+    EXPECT_NEAR(positionOf(c).x, start.x, 1e-3f);
+}
@@ -0,0 +1,63 @@
+﻿#include <gtest/gtest.h>
+
+#include "TestScene.h"
+
+using namespace UniDx;
+
+
+namespace
+{
+
+class Base : public Component
+{
+};
+
+class Derived : public Base
+{
+};
+
+class Other : public Component
+{
+};
+
+} // namespace
+
+
+TEST(ComponentIndex, FindDoesNotRegisterUnknownTypes)
+{
+    ComponentIndex index;
+    ComponentIndex::ComponentContainer components;
+    components.push_back(std::make_unique<Derived>());
+    index.onAdded<Derived>(components.back().get(), components);
+
+    // 追加した型は引ける。基底は宣言していないので索引に載っていない
+    ASSERT_TRUE(index.find<Derived>().has_value());
+    EXPECT_EQ(index.find<Derived>()->size(), 1u);
+    EXPECT_FALSE(index.find<Base>().has_value());
+
+    // 引いただけでは載らない
+    EXPECT_FALSE(index.find<Base>().has_value());
+
+    index.track<Base>(components);
+    ASSERT_TRUE(index.find<Base>().has_value());
+    EXPECT_EQ(index.find<Base>()->front().component, components.front().get());
+}
+
+
+TEST(ComponentIndex, TrackedTypesSeeLaterComponents)
+{
+    ComponentIndex index;
+    ComponentIndex::ComponentContainer components;
+    index.track<Base>(components);
+
+    components.push_back(std::make_unique<Other>());
+    index.onAdded<Other>(components.back().get(), components);
+    components.push_back(std::make_unique<Derived>());
+    index.onAdded<Derived>(components.back().get(), components);
+
+    ASSERT_EQ(index.find<Base>()->size(), 1u);
+    EXPECT_EQ(index.find<Base>()->front().component, components.back().get());
+
+    index.onRemoved(components.back().get());
+    EXPECT_TRUE(index.find<Base>()->empty());
+}
@@ -0,0 +1,85 @@
+﻿#include <gtest/gtest.h>
+
+#include "TestScene.h"
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+
+
+namespace
+{
+
+// 毎フレーム進むコルーチンと、終わらないうちにループが片付けられるコルーチンを持つ
+class Ticker : public Behaviour
+{
+public:
+    static inline int ticks = 0;
+    static inline int zeroWaitTicks = 0;
+
+    virtual void Start() override
+    {
+        StartCoroutine(tick());
+        StartCoroutine(zeroWait());
+        StartCoroutine(sleep());
+    }
+
+private:
+    Coroutine tick()
+    {
+        while (true)
+        {
+            ++ticks;
+            co_await WaitForNextFrame();
+        }
+    }
+
+    // 0秒待ちでも、待ち始めたフレームのうちには再開しない
+    Coroutine zeroWait()
+    {
+        while (true)
+        {
+            ++zeroWaitTicks;
+            co_await WaitForSeconds(0.0f);
+        }
+    }
+
+    Coroutine sleep()
+    {
+        co_await WaitForSeconds(1000.0f);
+        ADD_FAILURE() << "1000秒は経たないはず";
+    }
+};
+
+
+std::unique_ptr<Scene> tickerScene()
+{
+    return std::make_unique<Scene>(std::make_unique<GameObject>(u8"Ticker", std::make_unique<Ticker>()));
+}
+
+} // namespace
+
+
+TEST(Coroutine, ResumesEveryFrame)
+{
+    Ticker::ticks = 0;
+    Ticker::zeroWaitTicks = 0;
+    HeadlessLoop loop(tickerScene);
+    loop.step(5);
+
+    // Start() で1回、以降のフレームで1回ずつ
+    EXPECT_EQ(Ticker::ticks, 5);
+    EXPECT_EQ(Ticker::zeroWaitTicks, 5);
+}
+
+
+// 待機中のフレームを残したままループを破棄しても、フレームのプールは有効なまま使い回せる
+TEST(Coroutine, PendingFramesSurviveLoopDestruction)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        Ticker::ticks = 0;
+        HeadlessLoop loop(tickerScene);
+        loop.step(2);
+        EXPECT_EQ(Ticker::ticks, 2);
+    }
+}
@@ -0,0 +1,117 @@
+﻿#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "TestScene.h"
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+using UniDxTest::findObject;
+
+
+namespace
+{
+
+// OnDestroy() が呼ばれた順に持ち主の名前を残す。alsoDestroy があれば OnDestroy() の中で破棄する
+class DestroyRecorder : public Behaviour
+{
+public:
+    static inline std::vector<std::string> destroyed;   // gtest で表示できるよう char の文字列で持つ
+
+    GameObject* alsoDestroy = nullptr;
+
+    virtual void OnDestroy() override
+    {
+        destroyed.push_back(gameObject->name.get().c_str());
+        if (alsoDestroy != nullptr) Destroy(alsoDestroy);
+    }
+};
+
+
+std::unique_ptr<GameObject> recorded(const char8_t* name)
+{
+    return std::make_unique<GameObject>(name, std::make_unique<DestroyRecorder>());
+}
+
+// Parent の下に Child、その下に Grandchild。別に Other と Target
+std::unique_ptr<Scene> familyScene()
+{
+    auto root = std::make_unique<GameObject>(u8"Root");
+    auto parent = recorded(u8"Parent");
+    auto child = recorded(u8"Child");
+    Transform::SetParent(recorded(u8"Grandchild"), child->transform);
+    Transform::SetParent(std::move(child), parent->transform);
+    Transform::SetParent(std::move(parent), root->transform);
+    Transform::SetParent(recorded(u8"Other"), root->transform);
+    Transform::SetParent(recorded(u8"Target"), root->transform);
+    return std::make_unique<Scene>(std::move(root));
+}
+
+DestroyRecorder* recorderOf(const char8_t* name)
+{
+    return findObject(name)->GetComponent<DestroyRecorder>(true);
+}
+
+} // namespace
+
+
+// 親を先に Destroy() しても、深い方から削除する
+TEST(DestroyQueue, DeepestObjectsAreDestroyedFirst)
+{
+    HeadlessLoop loop(familyScene);
+    loop.step(1);
+    DestroyRecorder::destroyed.clear();
+
+    Destroy(findObject(u8"Parent"));
+    Destroy(findObject(u8"Child"));
+    loop.step(1);
+
+    EXPECT_EQ(DestroyRecorder::destroyed, (std::vector<std::string>{ "Child", "Grandchild", "Parent" }));
+    EXPECT_EQ(findObject(u8"Parent"), nullptr);
+    EXPECT_EQ(findObject(u8"Child"), nullptr);
+    EXPECT_EQ(findObject(u8"Grandchild"), nullptr);
+    EXPECT_NE(findObject(u8"Other"), nullptr);
+}
+
+
+// OnDestroy() の中で Destroy() したものも、同じフレームの終わりに削除する
+TEST(DestroyQueue, DestroyInsideOnDestroyRunsInTheSameFrame)
+{
+    HeadlessLoop loop(familyScene);
+    loop.step(1);
+    DestroyRecorder::destroyed.clear();
+
+    recorderOf(u8"Other")->alsoDestroy = findObject(u8"Target");
+    Destroy(findObject(u8"Other"));
+    loop.step(1);
+
+    EXPECT_EQ(DestroyRecorder::destroyed, (std::vector<std::string>{ "Other", "Target" }));
+    EXPECT_EQ(findObject(u8"Other"), nullptr);
+    EXPECT_EQ(findObject(u8"Target"), nullptr);
+}
+
+
+// 持ち主と同じフレームに Destroy() したコンポーネントも、OnDestroy() は1回だけ
+TEST(DestroyQueue, ComponentAndItsObjectInTheSameFrame)
+{
+    HeadlessLoop loop(familyScene);
+    loop.step(1);
+    DestroyRecorder::destroyed.clear();
+
+    GameObject* other = findObject(u8"Other");
+    Destroy(other);
+    Destroy(other->GetComponent<DestroyRecorder>(true));
+    GameObject* target = findObject(u8"Target");
+    Destroy(target->GetComponent<DestroyRecorder>(true));
+    Destroy(target);
+    loop.step(1);
+
+    EXPECT_EQ(DestroyRecorder::destroyed, (std::vector<std::string>{ "Other", "Target" }));
+    EXPECT_EQ(findObject(u8"Other"), nullptr);
+    EXPECT_EQ(findObject(u8"Target"), nullptr);
+
+    // 何も積まれていないフレームでは何も起きない
+    loop.step(1);
+    EXPECT_EQ(DestroyRecorder::destroyed.size(), 2u);
+}
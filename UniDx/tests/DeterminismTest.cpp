@@ -0,0 +1,124 @@
+﻿#include <gtest/gtest.h>
+
+#include "TestScene.h"
+
+#include <filesystem>
+#include <vector>
+
+#include <UniDx/InputReplay.h>
+#include <UniDx/Random.h>
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+
+
+namespace
+{
+
+// FixedUpdate() の回数をフレームごとに数える
+class FixedStepCounter : public Behaviour
+{
+public:
+    static inline int fixedUpdateCount = 0;
+    static inline std::vector<int> perFrame;
+
+    virtual void FixedUpdate() override { ++fixedUpdateCount; }
+    virtual void Update() override
+    {
+        perFrame.push_back(fixedUpdateCount);
+        fixedUpdateCount = 0;
+    }
+};
+
+
+// Start() で既定のシードの Random を作り、Update() ごとに引いた値を残す
+class RandomSampler : public Behaviour
+{
+public:
+    static inline std::vector<float> values;
+
+    virtual void Start() override { random_ = std::make_unique<Random>(); }
+    virtual void Update() override { values.push_back(random_->value()); }
+
+private:
+    std::unique_ptr<Random> random_;
+};
+
+
+std::unique_ptr<Scene> counterScene()
+{
+    return std::make_unique<Scene>(
+        std::make_unique<GameObject>(u8"Counter", Vector3(0.0f, 0.0f, 0.0f),
+            std::make_unique<FixedStepCounter>()));
+}
+
+
+std::unique_ptr<Scene> samplerScene()
+{
+    return std::make_unique<Scene>(
+        std::make_unique<GameObject>(u8"Sampler", Vector3(0.0f, 0.0f, 0.0f),
+            std::make_unique<RandomSampler>()));
+}
+
+} // namespace
+
+
+TEST(Determinism, FixedUpdateRunsOncePerFrameWithDefaultStep)
+{
+    FixedStepCounter::fixedUpdateCount = 0;
+    FixedStepCounter::perFrame.clear();
+    HeadlessLoop loop(counterScene);
+
+    const int frames = 600;
+    loop.step(frames);
+
+    // 最初のフレームはまだ時間が経っていないので回らず、以降は毎フレームちょうど1回
+    ASSERT_EQ(FixedStepCounter::perFrame.size(), size_t(frames));
+    EXPECT_EQ(FixedStepCounter::perFrame[0], 0);
+    for (int i = 1; i < frames; ++i)
+    {
+        ASSERT_EQ(FixedStepCounter::perFrame[i], 1) << "frame " << i;
+    }
+}
+
+
+TEST(Determinism, EnableStepsByFixedDeltaTime)
+{
+    Determinism::Enable();
+    const auto* clock = dynamic_cast<const FixedStepClock*>(&Time::GetClock());
+    ASSERT_NE(clock, nullptr);
+    EXPECT_EQ(clock->step(), double(Time::fixedDeltaTime));
+    Determinism::Disable();
+}
+
+
+TEST(Determinism, ReplayReproducesDefaultSeededRandom)
+{
+    const auto path = std::filesystem::temp_directory_path() / "unidx_determinism_test.inputrec";
+    const u8string file = path.u8string();
+    const float fixedDeltaTime = Time::fixedDeltaTime;
+
+    RandomSampler::values.clear();
+    {
+        HeadlessLoop loop(samplerScene);
+        InputReplay::StartRecording();
+        loop.step(30);
+        ASSERT_TRUE(InputReplay::StopRecording(file));
+    }
+    const std::vector<float> recorded = RandomSampler::values;
+
+    RandomSampler::values.clear();
+    {
+        HeadlessLoop loop(samplerScene);
+        ASSERT_TRUE(InputReplay::StartReplay(file));
+        loop.step(30);
+        EXPECT_TRUE(InputReplay::isReplayFinished());
+    }
+
+    ASSERT_EQ(recorded.size(), size_t(30));
+    EXPECT_EQ(RandomSampler::values, recorded);
+
+    Random::setDefaultSeedSequence(false);
+    Time::fixedDeltaTime = fixedDeltaTime;
+    std::filesystem::remove(path);
+}
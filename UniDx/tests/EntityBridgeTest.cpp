@@ -0,0 +1,75 @@
+﻿#include <gtest/gtest.h>
+
+#include "TestScene.h"
+
+#include <UniDx/Entities.h>
+#include <UniDx/EntityBridge.h>
+#include <UniDx/Renderer.h>
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+
+
+namespace
+{
+
+// ブリッジしたRigidbodyとMeshRendererの値をチャンク上で書き換えるシステム
+class HalveGravity : public EntitySystem
+{
+public:
+    virtual void OnUpdate(EntityManager& entities) override
+    {
+        entities.ForEach<RigidbodyData>([](RigidbodyData& rb) { rb.gravityScale = 0.5f; });
+        entities.ForEach<MeshRendererData>([](MeshRendererData& mr) { mr.enabled = false; });
+    }
+};
+
+
+std::unique_ptr<Scene> bridgedScene()
+{
+    return std::make_unique<Scene>(std::make_unique<GameObject>(u8"Body", Vector3(0.0f, 0.0f, 0.0f),
+        std::make_unique<Rigidbody>(), std::make_unique<MeshRenderer>(), std::make_unique<EntityBridge>()));
+}
+
+GameObject* body()
+{
+    return UniDxTest::findObject(u8"Body");
+}
+
+} // namespace
+
+
+TEST(EntityBridge, SystemChangesAreWrittenBack)
+{
+    HeadlessLoop loop(bridgedScene);
+    EntityManager::getInstance()->AddSystem<HalveGravity>();
+    loop.step(1);
+
+    GameObject* object = body();
+    ASSERT_NE(object, nullptr);
+    EXPECT_TRUE(object->GetComponent<EntityBridge>(true)->entity().isValid());
+    EXPECT_EQ(float(object->GetComponent<Rigidbody>(true)->gravityScale), 0.5f);
+    EXPECT_FALSE(bool(object->GetComponent<MeshRenderer>(true)->enabled));
+}
+
+
+// ブリッジより先にRigidbodyとMeshRendererを破棄しても、残ったエンティティから触らない
+TEST(EntityBridge, DestroyedComponentsAreNotTouched)
+{
+    HeadlessLoop loop(bridgedScene);
+    EntityManager::getInstance()->AddSystem<HalveGravity>();
+    loop.step(1);
+
+    GameObject* object = body();
+    ASSERT_NE(object, nullptr);
+    Destroy(object->GetComponent<Rigidbody>(true));
+    Destroy(object->GetComponent<MeshRenderer>(true));
+    loop.step(3);
+
+    EXPECT_EQ(object->GetComponent<Rigidbody>(true), nullptr);
+    EXPECT_EQ(object->GetComponent<MeshRenderer>(true), nullptr);
+
+    Entity entity = object->GetComponent<EntityBridge>(true)->entity();
+    ASSERT_TRUE(EntityManager::getInstance()->Exists(entity));
+    EXPECT_TRUE(EntityManager::getInstance()->HasComponent<RigidbodyData>(entity));
+}
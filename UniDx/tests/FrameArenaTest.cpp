@@ -0,0 +1,48 @@
+﻿#include <gtest/gtest.h>
+
+#include <UniDx/FrameArena.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace UniDx;
+
+
+TEST(FrameArena, ResetRewindsTheCallingThread)
+{
+    FrameArena::resource()->allocate(1000, 8);
+    EXPECT_GE(FrameArena::current().used(), 1000u);
+
+    FrameArena::resetAll();
+    EXPECT_EQ(FrameArena::current().used(), 0u);
+}
+
+
+// 他のスレッドのアリーナには触らず、そのスレッドの次の確保で巻き戻る
+TEST(FrameArena, OtherThreadsRewindOnTheirNextAllocation)
+{
+    std::atomic<int> stage{ 0 };
+    size_t usedBefore = 0;
+    size_t usedAfterReset = 0;
+    size_t usedNextFrame = 0;
+
+    std::thread worker([&] {
+        FrameArena::resource()->allocate(1000, 8);
+        usedBefore = FrameArena::current().used();
+        stage.store(1);
+
+        while (stage.load() != 2) std::this_thread::yield();
+        usedAfterReset = FrameArena::current().used();
+        FrameArena::resource()->allocate(100, 8);
+        usedNextFrame = FrameArena::current().used();
+    });
+
+    while (stage.load() != 1) std::this_thread::yield();
+    FrameArena::resetAll();
+    stage.store(2);
+    worker.join();
+
+    EXPECT_GE(usedBefore, 1000u);
+    EXPECT_EQ(usedAfterReset, usedBefore);
+    EXPECT_EQ(usedNextFrame, 100u);
+}
@@ -0,0 +1,142 @@
+﻿#include <gtest/gtest.h>
+
+#include <UniDx/FrameLimiter.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+using namespace UniDx;
+
+
+namespace
+{
+
+// 眠らずに時刻だけ進める。lateness に並べた分だけ、眠ると目標より遅れて起きる
+class ManualFrameClock : public FrameClock
+{
+public:
+    time_point current{};
+    std::vector<double> lateness;
+    size_t sleeps = 0;
+
+    virtual time_point now() override { return current; }
+
+    virtual void sleepUntil(time_point deadline) override
+    {
+        double late = sleeps < lateness.size() ? lateness[sleeps] : 0.0;
+        ++sleeps;
+        current = std::max(current, deadline + std::chrono::duration_cast<duration>(std::chrono::duration<double>(late)));
+    }
+
+    virtual void spin() override { current += std::chrono::microseconds(1); }
+
+    double seconds() const { return std::chrono::duration<double>(current.time_since_epoch()).count(); }
+};
+
+
+// 静的な設定をテストごとに戻す
+class FrameLimiterTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        auto clock = std::make_unique<ManualFrameClock>();
+        clock_ = clock.get();
+        limiter_ = std::make_unique<FrameLimiter>(std::move(clock));
+
+        FrameLimiter::vSyncCount = 0;
+        FrameLimiter::targetFrameRate = 0;
+        FrameLimiter::unfocusedFrameRate = 10;
+        FrameLimiter::spinMargin = 0.0;
+        FrameLimiter::jitterBudget = 0.001;
+    }
+
+    void TearDown() override
+    {
+        FrameLimiter::vSyncCount = saved_.vSyncCount;
+        FrameLimiter::targetFrameRate = saved_.targetFrameRate;
+        FrameLimiter::unfocusedFrameRate = saved_.unfocusedFrameRate;
+        FrameLimiter::spinMargin = saved_.spinMargin;
+        FrameLimiter::jitterBudget = saved_.jitterBudget;
+    }
+
+    void wait(int frames, bool focused)
+    {
+        for (int i = 0; i < frames; ++i) limiter_->waitForNextFrame(focused);
+    }
+
+    ManualFrameClock* clock_ = nullptr;
+    std::unique_ptr<FrameLimiter> limiter_;
+
+private:
+    struct Settings
+    {
+        int vSyncCount = FrameLimiter::vSyncCount;
+        int targetFrameRate = FrameLimiter::targetFrameRate;
+        int unfocusedFrameRate = FrameLimiter::unfocusedFrameRate;
+        double spinMargin = FrameLimiter::spinMargin;
+        double jitterBudget = FrameLimiter::jitterBudget;
+    } saved_;
+};
+
+} // namespace
+
+
+// 上限なしでアクティブなら待たず、統計にも数えない
+TEST_F(FrameLimiterTest, UncappedFocusedDoesNotWait)
+{
+    wait(5, true);
+
+    EXPECT_EQ(clock_->seconds(), 0.0);
+    EXPECT_EQ(clock_->sleeps, 0u);
+    EXPECT_EQ(limiter_->pacingStats().count, 0u);
+}
+
+
+// 非アクティブの間は、上限なしでも targetFrameRate が高くても unfocusedFrameRate まで落とす
+TEST_F(FrameLimiterTest, UnfocusedCapsFrameRate)
+{
+    wait(5, false);
+    EXPECT_NEAR(clock_->seconds(), 0.5, 1e-9);
+
+    FrameLimiter::targetFrameRate = 144;
+    limiter_->reset();
+    wait(5, false);
+    EXPECT_NEAR(clock_->seconds(), 1.0, 1e-9);
+
+    FramePacingStats stats = limiter_->pacingStats();
+    EXPECT_EQ(stats.count, 4u);
+    EXPECT_NEAR(stats.meanInterval, 0.1, 1e-9);
+
+    // 垂直同期で待つ設定でも、非アクティブなら落とす
+    FrameLimiter::vSyncCount = 1;
+    limiter_->reset();
+    wait(2, false);
+    EXPECT_NEAR(clock_->seconds(), 1.2, 1e-9);
+
+    // アクティブに戻れば targetFrameRate で待つ
+    FrameLimiter::vSyncCount = 0;
+    limiter_->reset();
+    wait(144, true);
+    EXPECT_NEAR(clock_->seconds(), 2.2, 1e-6);
+}
+
+
+// 1回だけ遅れて起きると、その前後の2つの間隔がずれる
+TEST_F(FrameLimiterTest, PacingStatsReportJitter)
+{
+    FrameLimiter::targetFrameRate = 100;
+    clock_->lateness = { 0.0, 0.0, 0.003 };
+    wait(9, true);
+
+    // 間隔は 10, 10, 13, 7, 10, 10, 10, 10 ms
+    FramePacingStats stats = limiter_->pacingStats();
+    EXPECT_EQ(stats.count, 8u);
+    EXPECT_NEAR(stats.meanInterval, 0.010, 1e-9);
+    EXPECT_NEAR(stats.meanJitter, 0.006 / 8.0, 1e-9);
+    EXPECT_NEAR(stats.maxJitter, 0.003, 1e-9);
+    EXPECT_NEAR(stats.p99Jitter, 0.003, 1e-9);
+    EXPECT_EQ(stats.overBudget, 2u);
+}
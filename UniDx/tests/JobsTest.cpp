@@ -0,0 +1,137 @@
+﻿#include <gtest/gtest.h>
+
+#include <UniDx/Jobs.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace UniDx;
+
+
+namespace
+{
+
+// テストごとにジョブシステムを作り直す
+class JobsTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(Jobs::getInstance(), nullptr);
+        Jobs::create();
+    }
+
+    void TearDown() override
+    {
+        Jobs::destroy();
+    }
+
+    Jobs* jobs() { return Jobs::getInstance(); }
+};
+
+} // namespace
+
+
+TEST_F(JobsTest, ParallelForVisitsEveryIndexOnce)
+{
+    constexpr size_t Count = 10000;
+    std::vector<std::atomic<int>> visited(Count);
+
+    jobs()->wait(jobs()->parallelFor(Count, 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) visited[i].fetch_add(1);
+    }));
+
+    for (size_t i = 0; i < Count; ++i)
+    {
+        EXPECT_EQ(visited[i].load(), 1) << i;
+    }
+}
+
+
+TEST_F(JobsTest, DependenciesRunBeforeContinuations)
+{
+    std::atomic<int> step{ 0 };
+    int firstSeen = -1;
+    int secondSeen = -1;
+
+    JobHandle first = jobs()->schedule([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        firstSeen = step.fetch_add(1);
+    });
+    JobHandle second = jobs()->parallelFor(4, 1, [&](size_t, size_t) {
+        int s = step.fetch_add(1);
+        if (s == 1) secondSeen = s;
+    }, { first });
+
+    jobs()->wait(second);
+    EXPECT_TRUE(jobs()->isCompleted(first));
+    EXPECT_EQ(firstSeen, 0);
+    EXPECT_EQ(secondSeen, 1);
+    EXPECT_EQ(step.load(), 5);
+}
+
+
+// ワーカー以外の複数のスレッドから同時に登録して待つ
+TEST_F(JobsTest, ConcurrentScheduleFromManyThreads)
+{
+    constexpr int Threads = 4;
+    constexpr int PerThread = 2000;
+    std::atomic<int> executed{ 0 };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; ++t)
+    {
+        threads.emplace_back([&] {
+            std::vector<JobHandle> handles;
+            for (int i = 0; i < PerThread; ++i)
+            {
+                handles.push_back(jobs()->schedule([&] { executed.fetch_add(1); }));
+            }
+            for (auto& h : handles) jobs()->wait(h);
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(executed.load(), Threads * PerThread);
+}
+
+
+// プールが後続のジョブで埋まり、実行できるジョブもないときは、空きを待たずにその場で実行する
+TEST_F(JobsTest, ExhaustedPoolRunsInline)
+{
+    std::atomic<bool> started{ false };
+    std::atomic<bool> open{ false };
+    std::atomic<int> followers{ 0 };
+
+    // ワーカーが実行している間、open になるまで終わらないジョブ
+    JobHandle gate = jobs()->schedule([&] {
+        started.store(true);
+        while (!open.load()) std::this_thread::yield();
+    });
+    while (!started.load()) std::this_thread::yield();
+
+    // 残りのスロットをすべて gate の後続で埋める
+    std::vector<JobHandle> handles;
+    for (uint32_t i = 0; i < Jobs::MaxJobs - 1; ++i)
+    {
+        handles.push_back(jobs()->schedule([&] { followers.fetch_add(1); }, { gate }));
+    }
+
+    // 空きがなく、実行できるジョブもない。待ち続けずにその場で実行される
+    int inlineRuns = 0;
+    JobHandle extra = jobs()->schedule([&] { ++inlineRuns; });
+    EXPECT_FALSE(extra.isValid());
+    EXPECT_EQ(inlineRuns, 1);
+
+    // parallelFor も同様に全範囲をその場で実行する
+    size_t covered = 0;
+    JobHandle range = jobs()->parallelFor(10, 1, [&](size_t begin, size_t end) { covered += end - begin; });
+    EXPECT_FALSE(range.isValid());
+    EXPECT_EQ(covered, 10u);
+
+    open.store(true);
+    for (auto& h : handles) jobs()->wait(h);
+    EXPECT_EQ(followers.load(), int(Jobs::MaxJobs - 1));
+}
@@ -0,0 +1,174 @@
+﻿#include <gtest/gtest.h>
+
+#include "TestScene.h"
+
+#include <UniDx/ObjectPool.h>
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+using UniDxTest::findObject;
+
+
+namespace
+{
+
+// 取り出し・戻し・Update の回数を数える
+class SpawnProbe : public Behaviour
+{
+public:
+    int spawned = 0;
+    int despawned = 0;
+    int updated = 0;
+
+    virtual void OnSpawn() override { ++spawned; }
+    virtual void OnDespawn() override { ++despawned; }
+    virtual void Update() override { ++updated; }
+};
+
+
+std::unique_ptr<GameObject> makeInstance()
+{
+    return std::make_unique<GameObject>(u8"Instance",
+        std::make_unique<AABBCollider>(Vector3(0.5f, 0.5f, 0.5f)),
+        std::make_unique<SpawnProbe>());
+}
+
+// Root の下にプールを置き、シーンを作る前に3個作っておく
+std::unique_ptr<Scene> poolScene()
+{
+    auto root = std::make_unique<GameObject>(u8"Root");
+    auto poolObject = std::make_unique<GameObject>(u8"Pool", std::make_unique<ObjectPool>(makeInstance));
+    poolObject->GetComponent<ObjectPool>(true)->Prewarm(3);
+    Transform::SetParent(std::move(poolObject), root->transform);
+    return std::make_unique<Scene>(std::move(root));
+}
+
+ObjectPool* pool()
+{
+    return findObject(u8"Pool")->GetComponent<ObjectPool>(true);
+}
+
+SpawnProbe* probeOf(GameObject* instance)
+{
+    return instance->GetComponent<SpawnProbe>(true);
+}
+
+size_t overlapCount(Vector3 center)
+{
+    std::vector<Collider*> results;
+    return SceneManager::getInstance()->GetActiveScene()->GetPhysicsScene()->OverlapSphere(center, 0.1f, results);
+}
+
+} // namespace
+
+
+// Prewarm() したものは休眠していて、取り出すまで Update() も OnSpawn() も呼ばれない
+TEST(ObjectPool, PrewarmedInstancesStayDormant)
+{
+    HeadlessLoop loop(poolScene);
+    loop.step(2);
+
+    EXPECT_EQ(pool()->countAll(), 3u);
+    EXPECT_EQ(pool()->countInactive(), 3u);
+    EXPECT_EQ(pool()->countActive(), 0u);
+    for (GameObject* instance : pool()->transform->getChildGameObjects())
+    {
+        EXPECT_EQ(probeOf(instance)->updated, 0);
+        EXPECT_EQ(probeOf(instance)->spawned, 0);
+    }
+
+    // 足りている分には増やさない
+    pool()->Prewarm(2);
+    EXPECT_EQ(pool()->countAll(), 3u);
+}
+
+
+// Spawn() は休眠中のものを使い回し、足りなくなったら作る
+TEST(ObjectPool, SpawnReusesThenGrows)
+{
+    HeadlessLoop loop(poolScene);
+    loop.step(1);
+
+    GameObject* first = pool()->Spawn(Vector3(1.0f, 2.0f, 3.0f));
+    EXPECT_EQ(pool()->countAll(), 3u);
+    EXPECT_EQ(pool()->countActive(), 1u);
+    EXPECT_EQ(Vector3(first->transform->position).y, 2.0f);
+    EXPECT_EQ(probeOf(first)->spawned, 1);
+
+    loop.step(1);
+    EXPECT_EQ(probeOf(first)->updated, 1);
+
+    // 残りの2個を使い切ってから、もう1個
+    pool()->Spawn(Vector3::zero);
+    pool()->Spawn(Vector3::zero);
+    GameObject* grown = pool()->Spawn(Vector3::zero);
+    EXPECT_EQ(pool()->countAll(), 4u);
+    EXPECT_EQ(pool()->countInactive(), 0u);
+    EXPECT_EQ(grown->transform->parent, pool()->transform);
+
+    // シーンが動いてから作ったものも Awake されて、次のフレームから動く
+    loop.step(1);
+    EXPECT_EQ(probeOf(grown)->updated, 1);
+}
+
+
+// Despawn() で休眠に戻り、同じインスタンスが次の Spawn() で出てくる
+TEST(ObjectPool, DespawnReturnsInstanceForReuse)
+{
+    HeadlessLoop loop(poolScene);
+    loop.step(1);
+
+    GameObject* instance = pool()->Spawn(Vector3::zero);
+    loop.step(1);
+    pool()->Despawn(instance);
+    pool()->Despawn(instance);  // 2回戻しても1回分
+
+    EXPECT_EQ(probeOf(instance)->despawned, 1);
+    EXPECT_EQ(pool()->countInactive(), 3u);
+
+    loop.step(1);
+    EXPECT_EQ(probeOf(instance)->updated, 1);
+
+    EXPECT_EQ(pool()->Spawn(Vector3::zero), instance);
+    EXPECT_EQ(probeOf(instance)->spawned, 2);
+}
+
+
+// 休眠中のコライダーは物理クエリに出てこない
+TEST(ObjectPool, DormantCollidersAreSkippedByQueries)
+{
+    HeadlessLoop loop(poolScene);
+    loop.step(1);
+
+    const Vector3 position(10.0f, 0.0f, 0.0f);
+    GameObject* instance = pool()->Spawn(position);
+    loop.step(1);
+    EXPECT_EQ(overlapCount(position), 1u);
+
+    pool()->Despawn(instance);
+    EXPECT_EQ(overlapCount(position), 0u);
+    loop.step(1);
+    EXPECT_EQ(overlapCount(position), 0u);
+
+    pool()->Spawn(position);
+    EXPECT_EQ(overlapCount(position), 1u);
+}
+
+
+// Release() はプールのインスタンスなら戻し、そうでなければ破棄する
+TEST(ObjectPool, ReleaseDespawnsOrDestroys)
+{
+    HeadlessLoop loop(poolScene);
+    loop.step(1);
+
+    GameObject* instance = pool()->Spawn(Vector3::zero);
+    ObjectPool::Release(instance);
+    EXPECT_EQ(pool()->countInactive(), 3u);
+
+    auto loose = std::make_unique<GameObject>(u8"Loose");
+    Transform::SetParent(std::move(loose), findObject(u8"Root")->transform);
+    ObjectPool::Release(findObject(u8"Loose"));
+    loop.step(1);
+    EXPECT_EQ(findObject(u8"Loose"), nullptr);
+    EXPECT_EQ(pool()->countAll(), 3u);
+}
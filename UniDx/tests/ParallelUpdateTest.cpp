@@ -0,0 +1,114 @@
+﻿#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "TestScene.h"
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+
+
+namespace
+{
+
+constexpr int ObjectCount = 64;
+
+// 並列Update中に引かれるだけのコンポーネント（それまで一度も GetComponent されない型）
+class Tag : public Component
+{
+public:
+    int value = 0;
+};
+
+// 並列Update中に追加されるコンポーネント
+class Added : public Component
+{
+};
+
+// 並列Update中に無効にされるBehaviour。OnDisable() を呼んだスレッドを覚える
+class Sibling : public Behaviour
+{
+public:
+    static inline std::atomic<int> disableCount = 0;
+    static inline std::atomic<int> offMainThreadCount = 0;
+    static inline std::thread::id mainThread;
+
+    virtual void OnDisable() override
+    {
+        ++disableCount;
+        if (std::this_thread::get_id() != mainThread) ++offMainThreadCount;
+    }
+};
+
+class ParallelWorker : public Behaviour
+{
+public:
+    static constexpr bool parallelUpdate = true;
+    static inline std::atomic<int> tagMismatch = 0;
+    static inline std::atomic<int> visibleBeforeApply = 0;
+
+    int expectedTag = 0;
+
+    virtual void Update() override
+    {
+        if (Time::frameCount != 1) return;
+
+        Tag* tag = gameObject->GetComponent<Tag>();
+        if (tag == nullptr || tag->value != expectedTag) ++tagMismatch;
+
+        gameObject->GetComponent<Sibling>()->enabled = false;
+        gameObject->AddComponent<Added>();
+
+        // 反映は並列区間の後
+        if (gameObject->GetComponent<Added>(true) != nullptr) ++visibleBeforeApply;
+    }
+};
+
+
+std::unique_ptr<Scene> workerScene()
+{
+    auto root = std::make_unique<GameObject>(u8"Root");
+    for (int i = 0; i < ObjectCount; ++i)
+    {
+        auto tag = std::make_unique<Tag>();
+        tag->value = i;
+        auto worker = std::make_unique<ParallelWorker>();
+        worker->expectedTag = i;
+        std::u8string name = u8"Worker" + ToUtf8(std::to_wstring(i));
+        Transform::SetParent(std::make_unique<GameObject>(name.c_str(), Vector3(0.0f, 0.0f, 0.0f),
+            std::move(tag), std::make_unique<Sibling>(), std::move(worker)), root->transform);
+    }
+    return std::make_unique<Scene>(std::move(root));
+}
+
+} // namespace
+
+
+TEST(ParallelUpdate, StructuralChangesAreAppliedAfterTheParallelPhase)
+{
+    Sibling::disableCount = 0;
+    Sibling::offMainThreadCount = 0;
+    Sibling::mainThread = std::this_thread::get_id();
+    ParallelWorker::tagMismatch = 0;
+    ParallelWorker::visibleBeforeApply = 0;
+
+    HeadlessLoop loop(workerScene);
+    loop.step(3);
+
+    EXPECT_EQ(ParallelWorker::tagMismatch, 0);
+    EXPECT_EQ(ParallelWorker::visibleBeforeApply, 0);
+    EXPECT_EQ(Sibling::disableCount, ObjectCount);
+    EXPECT_EQ(Sibling::offMainThreadCount, 0);
+
+    Scene* scene = SceneManager::getInstance()->GetActiveScene();
+    for (int i = 0; i < ObjectCount; ++i)
+    {
+        std::u8string name = u8"Worker" + ToUtf8(std::to_wstring(i));
+        GameObject* object = scene->FindByName(StringId::intern(name));
+        ASSERT_NE(object, nullptr);
+        EXPECT_NE(object->GetComponent<Added>(true), nullptr);
+        EXPECT_FALSE(object->GetComponent<Sibling>(true)->enabled);
+    }
+}
@@ -0,0 +1,70 @@
+﻿#include <gtest/gtest.h>
+
+#include "TestScene.h"
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+
+
+namespace
+{
+
+// 触れたら自分のコライダーを無効にする（拾われて消えるアイテムのような動き）
+class Consumed : public Behaviour
+{
+public:
+    static inline int enterCount = 0;
+
+    virtual void OnTriggerEnter(Collider* other) override
+    {
+        ++enterCount;
+        gameObject->GetComponent<SphereCollider>(true)->enabled = false;
+    }
+};
+
+// Update だけを実装し、物理のコールバックは受け取らない
+class UpdateOnly : public Behaviour
+{
+public:
+    virtual void Update() override {}
+};
+
+
+std::unique_ptr<GameObject> consumable(const char8_t* name, Vector3 position)
+{
+    auto rb = std::make_unique<Rigidbody>();
+    rb->gravityScale = 0.0f;
+    auto collider = std::make_unique<SphereCollider>();
+    collider->radius = 1.0f;
+    collider->isTrigger = true;
+    return std::make_unique<GameObject>(name, position, std::move(rb), std::move(collider), std::make_unique<Consumed>());
+}
+
+std::unique_ptr<Scene> overlappingScene()
+{
+    auto root = std::make_unique<GameObject>(u8"Root");
+    Transform::SetParent(consumable(u8"A", Vector3(0.0f, 0.0f, 0.0f)), root->transform);
+    Transform::SetParent(consumable(u8"B", Vector3(0.5f, 0.0f, 0.0f)), root->transform);
+    return std::make_unique<Scene>(std::move(root));
+}
+
+} // namespace
+
+
+TEST(PhysicsEvents, MaskHasOnlyOverriddenCallbacks)
+{
+    EXPECT_EQ(behaviourPhysicsEventMask<Consumed>(), uint8_t(PhysicsEvent_TriggerEnter));
+    EXPECT_EQ(behaviourPhysicsEventMask<UpdateOnly>(), uint8_t(0));
+    EXPECT_EQ(behaviourPhysicsEventMask<Behaviour>(), uint8_t(0x7f));
+}
+
+
+// 先に配ったコールバックで相手側のコライダーが無効になったら、その相手からのイベントは配らない
+TEST(PhysicsEvents, EventsFromAColliderDisabledByAnEarlierCallbackAreDropped)
+{
+    Consumed::enterCount = 0;
+    HeadlessLoop loop(overlappingScene);
+    loop.step(5);
+
+    EXPECT_EQ(Consumed::enterCount, 1);
+}
@@ -0,0 +1,88 @@
+﻿#include <gtest/gtest.h>
+
+#include <string>
+
+#include "TestScene.h"
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+
+
+namespace
+{
+
+constexpr int BoxCount = 40;
+constexpr float BoxSpacing = 2.0f;
+
+// x 軸に沿って 1m の箱を BoxSpacing おきに並べる
+std::unique_ptr<Scene> boxRowScene()
+{
+    auto row = std::make_unique<GameObject>(u8"Row");
+    for (int i = 0; i < BoxCount; ++i)
+    {
+        std::u8string name = u8"Box" + ToUtf8(std::to_wstring(i));
+        Transform::SetParent(std::make_unique<GameObject>(name.c_str(), Vector3(i * BoxSpacing, 0.0f, 0.0f),
+            std::make_unique<AABBCollider>()), row->transform);
+    }
+    return std::make_unique<Scene>(std::move(row));
+}
+
+GameObject* box(int i)
+{
+    std::u8string name = u8"Box" + ToUtf8(std::to_wstring(i));
+    return UniDxTest::findObject(name);
+}
+
+Physics* world()
+{
+    return SceneManager::getInstance()->GetActiveScene()->GetPhysicsScene();
+}
+
+} // namespace
+
+
+TEST(PhysicsQuery, OverlapSphereFindsOnlyNearbyColliders)
+{
+    HeadlessLoop loop(boxRowScene);
+    loop.step(5);   // ステップを回してブロードフェーズのグリッドを作る
+
+    std::vector<Collider*> results;
+    size_t count = world()->OverlapSphere(Vector3(20 * BoxSpacing, 0.0f, 0.0f), 0.6f, results);
+
+    ASSERT_EQ(count, 1u);
+    EXPECT_EQ(results[0]->gameObject, box(20));
+}
+
+
+TEST(PhysicsQuery, SphereCastHitsClosestCollider)
+{
+    HeadlessLoop loop(boxRowScene);
+    loop.step(5);
+
+    RaycastHit hit;
+    ASSERT_TRUE(world()->SphereCast(Vector3(10 * BoxSpacing + 1.0f, 0.0f, 0.0f), 0.25f, Vector3(1.0f, 0.0f, 0.0f), 100.0f, &hit));
+    EXPECT_EQ(hit.collider->gameObject, box(11));
+    EXPECT_NEAR(hit.distance, 0.25f, 1e-3f);
+
+    // 列の外に向けたら当たらない
+    EXPECT_FALSE(world()->SphereCast(Vector3(0.0f, 5.0f, 0.0f), 0.25f, Vector3(0.0f, 1.0f, 0.0f), 100.0f));
+}
+
+
+TEST(PhysicsQuery, QueriesSeeCollidersRegisteredAfterTheStep)
+{
+    HeadlessLoop loop(boxRowScene);
+    loop.step(5);
+
+    // 登録し直した直後（次のステップの前）でも見つかる
+    Collider* collider = box(30)->GetComponent<Collider>();
+    collider->enabled = false;
+    collider->enabled = true;
+
+    std::vector<Collider*> results;
+    EXPECT_EQ(world()->OverlapSphere(Vector3(30 * BoxSpacing, 0.0f, 0.0f), 0.6f, results), 1u);
+
+    RaycastHit hit;
+    ASSERT_TRUE(world()->SphereCast(Vector3(29 * BoxSpacing + 1.0f, 0.0f, 0.0f), 0.25f, Vector3(1.0f, 0.0f, 0.0f), 100.0f, &hit));
+    EXPECT_EQ(hit.collider, collider);
+}
@@ -0,0 +1,172 @@
+﻿#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "TestScene.h"
+
+#include <UniDx/Jobs.h>
+
+using namespace UniDx;
+
+
+namespace
+{
+
+constexpr int WorldCount = 8;
+constexpr int StepCount = 120;
+
+// ぶつかった回数を数える
+class CollisionCounter : public Behaviour
+{
+public:
+    int enterCount = 0;
+
+    virtual void OnCollisionEnter(const Collision& collision) override { ++enterCount; }
+};
+
+
+std::unique_ptr<GameObject> ground()
+{
+    auto collider = std::make_unique<AABBCollider>();
+    collider->size = Vector3(10.0f, 0.5f, 10.0f);
+    return std::make_unique<GameObject>(u8"Ground", Vector3(0.0f, 0.0f, 0.0f), std::move(collider));
+}
+
+std::unique_ptr<GameObject> ball(float height)
+{
+    auto collider = std::make_unique<SphereCollider>();
+    collider->radius = 0.5f;
+    return std::make_unique<GameObject>(u8"Ball", Vector3(0.0f, height, 0.0f),
+        std::make_unique<Rigidbody>(), std::move(collider), std::make_unique<CollisionCounter>());
+}
+
+// 地面に球を落とすだけのシーン。PlayerLoop を通さずに Awake() と OnEnable() まで済ませる
+std::unique_ptr<Scene> dropScene(float height)
+{
+    auto scene = std::make_unique<Scene>(ground(), ball(height));
+    for (auto& root : scene->GetRootGameObjects())
+    {
+        root->checkAwakeInHierarchy();
+    }
+    return scene;
+}
+
+GameObject* ballOf(Scene* scene)
+{
+    return scene->FindByName(StringId::intern(u8"Ball"));
+}
+
+float heightOf(GameObject* object)
+{
+    return Vector3(object->transform->position).y;
+}
+
+
+class PhysicsWorlds : public ::testing::Test
+{
+protected:
+    void SetUp() override { Jobs::create(); }
+    void TearDown() override { Jobs::destroy(); }
+};
+
+} // namespace
+
+
+// 並列にステップしても、ワールドごとに順にステップしたときと位置もイベントも同じになる
+TEST_F(PhysicsWorlds, ParallelStepMatchesSerialStep)
+{
+    std::vector<std::unique_ptr<Scene>> parallel;
+    std::vector<std::unique_ptr<Scene>> serial;
+    std::vector<Physics*> parallelWorlds;
+    for (int i = 0; i < WorldCount; ++i)
+    {
+        const float height = 2.0f + 0.25f * i;
+        parallel.push_back(dropScene(height));
+        serial.push_back(dropScene(height));
+        parallelWorlds.push_back(parallel.back()->GetPhysicsScene());
+    }
+
+    for (int step = 0; step < StepCount; ++step)
+    {
+        Physics::simulateWorlds(parallelWorlds, Time::fixedDeltaTime);
+        for (auto& scene : serial)
+        {
+            scene->GetPhysicsScene()->simulatePositionCorrection(Time::fixedDeltaTime);
+        }
+    }
+
+    for (int i = 0; i < WorldCount; ++i)
+    {
+        GameObject* p = ballOf(parallel[i].get());
+        GameObject* s = ballOf(serial[i].get());
+        const Vector3 pp = p->transform->position;
+        const Vector3 sp = s->transform->position;
+        EXPECT_EQ(pp.x, sp.x) << "world " << i;
+        EXPECT_EQ(pp.y, sp.y) << "world " << i;
+        EXPECT_EQ(pp.z, sp.z) << "world " << i;
+
+        // 地面まで落ちて当たっている。跳ねた回数も同じ
+        const int enterCount = p->GetComponent<CollisionCounter>(true)->enterCount;
+        EXPECT_LT(pp.y, 1.5f) << "world " << i;
+        EXPECT_GE(enterCount, 1) << "world " << i;
+        EXPECT_EQ(enterCount, s->GetComponent<CollisionCounter>(true)->enterCount) << "world " << i;
+    }
+}
+
+
+// ワールドの重力はそのワールドの Rigidbody にだけ効く
+TEST_F(PhysicsWorlds, GravityIsPerWorld)
+{
+    auto normal = dropScene(5.0f);
+    auto floating = dropScene(5.0f);
+    floating->GetPhysicsScene()->gravity = 0.0f;
+
+    Physics* const worlds[] = { normal->GetPhysicsScene(), floating->GetPhysicsScene() };
+    for (int step = 0; step < 10; ++step)
+    {
+        Physics::simulateWorlds(worlds, Time::fixedDeltaTime);
+    }
+
+    EXPECT_LT(heightOf(ballOf(normal.get())), 5.0f);
+    EXPECT_EQ(heightOf(ballOf(floating.get())), 5.0f);
+}
+
+
+// 別のシーンへ付け替えたコライダーとRigidbodyは、移った先のワールドでだけ動く
+TEST_F(PhysicsWorlds, ReparentingIntoAnotherSceneMovesPhysicsRegistration)
+{
+    // ルートのままでは SetParent() できないので、付け替える球は子にしておく
+    auto fromRoot = std::make_unique<GameObject>(u8"Root");
+    Transform::SetParent(ball(3.0f), fromRoot->transform);
+    auto from = std::make_unique<Scene>(ground(), std::move(fromRoot));
+    auto to = std::make_unique<Scene>(ground());
+    for (Scene* scene : { from.get(), to.get() })
+    {
+        for (auto& root : scene->GetRootGameObjects())
+        {
+            root->checkAwakeInHierarchy();
+        }
+    }
+    GameObject* toGround = to->GetRootGameObjects().front().get();
+
+    GameObject* moved = ballOf(from.get());
+    const float startY = heightOf(moved);
+    moved->transform->SetParent(toGround->transform);
+    ASSERT_EQ(moved->scene(), to.get());
+    EXPECT_EQ(moved->GetComponent<SphereCollider>(true)->getWorld(), to->GetPhysicsScene());
+
+    // 元のワールドを進めても動かない
+    for (int step = 0; step < 10; ++step)
+    {
+        from->GetPhysicsScene()->simulatePositionCorrection(Time::fixedDeltaTime);
+    }
+    EXPECT_EQ(heightOf(moved), startY);
+
+    // 移った先のワールドで落ちて、地面に当たる
+    for (int step = 0; step < StepCount; ++step)
+    {
+        to->GetPhysicsScene()->simulatePositionCorrection(Time::fixedDeltaTime);
+    }
+    EXPECT_LT(heightOf(moved), startY);
+    EXPECT_GE(moved->GetComponent<CollisionCounter>(true)->enterCount, 1);
+}
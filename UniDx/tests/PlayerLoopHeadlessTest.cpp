@@ -0,0 +1,147 @@
+﻿#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "TestScene.h"
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+
+
+namespace
+{
+
+// 呼ばれた回数を数え、Update() で x 方向に 1 秒あたり speed 進む
+class CountingMover : public Behaviour
+{
+public:
+    static inline int awakeCount = 0;
+    static inline int startCount = 0;
+    static inline int updateCount = 0;
+    static inline int fixedUpdateCount = 0;
+
+    float speed = 1.0f;
+
+    virtual void Awake() override { ++awakeCount; }
+    virtual void Start() override { ++startCount; }
+    virtual void Update() override
+    {
+        ++updateCount;
+        transform->position = transform->position + Vector3(speed * Time::deltaTime, 0.0f, 0.0f);
+    }
+    virtual void FixedUpdate() override { ++fixedUpdateCount; }
+
+    static void resetCounts()
+    {
+        awakeCount = startCount = updateCount = fixedUpdateCount = 0;
+    }
+};
+
+
+// Update() の回数を自分で数える
+class UpdateCounter : public Behaviour
+{
+public:
+    int updateCount = 0;
+
+    virtual void Update() override { ++updateCount; }
+};
+
+// Update() の中で、前後のコンポーネントを無効にしてすぐ有効に戻す
+class Toggler : public Behaviour
+{
+public:
+    std::vector<Behaviour*> targets;
+
+    virtual void Update() override
+    {
+        for (Behaviour* target : targets)
+        {
+            target->enabled = false;
+            target->enabled = true;
+        }
+    }
+};
+
+
+std::unique_ptr<Scene> moverScene()
+{
+    return std::make_unique<Scene>(
+        std::make_unique<GameObject>(u8"Mover", Vector3(0.0f, 0.0f, 0.0f),
+            std::make_unique<CountingMover>()));
+}
+
+} // namespace
+
+
+TEST(PlayerLoopHeadless, StepFramesRunsEveryPhase)
+{
+    CountingMover::resetCounts();
+    HeadlessLoop loop(moverScene);
+
+    loop.step(10);
+
+    EXPECT_TRUE(loop.loop()->isHeadless());
+    EXPECT_EQ(CountingMover::awakeCount, 1);
+    EXPECT_EQ(CountingMover::startCount, 1);
+    EXPECT_EQ(CountingMover::updateCount, 10);
+    EXPECT_EQ(Time::frameCount, 10);
+    EXPECT_GT(CountingMover::fixedUpdateCount, 0);
+}
+
+
+TEST(PlayerLoopHeadless, StepFramesContinuesTheSameScene)
+{
+    CountingMover::resetCounts();
+    HeadlessLoop loop(moverScene);
+
+    loop.step(3);
+    loop.step(4);
+
+    // 2回目の呼び出しでシーンを作り直さない
+    EXPECT_EQ(CountingMover::awakeCount, 1);
+    EXPECT_EQ(CountingMover::updateCount, 7);
+}
+
+
+// 同じフレームで無効にして有効に戻しても、Update() は1フレームに1回だけ
+TEST(PlayerLoopHeadless, ReenabledComponentUpdatesOncePerFrame)
+{
+    HeadlessLoop loop([]() {
+        auto root = std::make_unique<GameObject>(u8"Root");
+        Transform::SetParent(std::make_unique<GameObject>(u8"Before", std::make_unique<UpdateCounter>()), root->transform);
+        Transform::SetParent(std::make_unique<GameObject>(u8"Toggler", std::make_unique<Toggler>()), root->transform);
+        Transform::SetParent(std::make_unique<GameObject>(u8"After", std::make_unique<UpdateCounter>()), root->transform);
+        return std::make_unique<Scene>(std::move(root));
+    });
+    loop.step(1);
+
+    auto* before = UniDxTest::findObject(u8"Before")->GetComponent<UpdateCounter>(true);
+    auto* after = UniDxTest::findObject(u8"After")->GetComponent<UpdateCounter>(true);
+    UniDxTest::findObject(u8"Toggler")->GetComponent<Toggler>(true)->targets = { before, after };
+    before->updateCount = 0;
+    after->updateCount = 0;
+
+    loop.step(3);
+
+    // 呼び終えたものも、まだ呼んでいないものも、入り直した分で余計に呼ばない
+    EXPECT_EQ(before->updateCount, 3);
+    EXPECT_EQ(after->updateCount, 3);
+}
+
+
+TEST(PlayerLoopHeadless, FixedStepClockAdvancesTime)
+{
+    CountingMover::resetCounts();
+    HeadlessLoop loop(moverScene, 0.05);
+
+    loop.step(1);
+    GameObject* mover = &*SceneManager::getInstance()->GetActiveScene()->GetRootGameObjects().front();
+    const float startX = mover->transform->position.get().x;
+
+    loop.step(20);
+
+    // 1 フレーム 0.05 秒ずつ進む
+    EXPECT_NEAR(Time::time, 21 * 0.05f, 1e-4f);
+    EXPECT_NEAR(mover->transform->position.get().x - startX, 20 * 0.05f, 1e-4f);
+}
@@ -0,0 +1,88 @@
+﻿#include <gtest/gtest.h>
+
+#include "TestScene.h"
+
+#include <UniDx/Prefab.h>
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+
+
+namespace
+{
+
+// 所有者を指すプロパティを持つのでコピーできないコンポーネント
+class Gauge : public Component
+{
+    float value_ = 0.0f;
+
+    float getValue() const { return value_; }
+    void setValue(const float& v) { value_ = v; }
+
+public:
+    MemberProperty<&Gauge::getValue, &Gauge::setValue> value{ this };
+};
+
+class Marker : public Component
+{
+public:
+    int id = 0;
+};
+
+
+std::unique_ptr<Scene> bodyScene()
+{
+    auto root = std::make_unique<GameObject>(u8"Root");
+    auto marker = std::make_unique<Marker>();
+    marker->id = 7;
+    Transform::SetParent(std::make_unique<GameObject>(u8"Body", Vector3(0.0f, 0.0f, 0.0f),
+        std::make_unique<Rigidbody>(), std::make_unique<SphereCollider>(), std::make_unique<Gauge>(), std::move(marker)),
+        root->transform);
+    return std::make_unique<Scene>(std::move(root));
+}
+
+} // namespace
+
+
+// 複製したコライダーはコピー元の登録先と剛体を引き継がず、有効になったときに自分の剛体を探す
+TEST(Prefab, ClonedColliderFindsItsOwnRigidbody)
+{
+    HeadlessLoop loop(bodyScene);
+    loop.step(1);
+
+    Scene* scene = SceneManager::getInstance()->GetActiveScene();
+    GameObject* body = scene->FindByName(StringId::intern(u8"Body"));
+    ASSERT_NE(body, nullptr);
+    ASSERT_EQ(body->GetComponent<SphereCollider>()->attachedRigidbody, body->GetComponent<Rigidbody>());
+
+    Prefab prefab(*body);
+    auto detached = prefab.Instantiate(Vector3(5.0f, 0.0f, 0.0f));
+    SphereCollider* detachedCollider = detached->GetComponent<SphereCollider>(true);
+    ASSERT_NE(detachedCollider, nullptr);
+    EXPECT_EQ(detachedCollider->attachedRigidbody, nullptr);
+    EXPECT_EQ(detachedCollider->getWorld(), nullptr);
+
+    GameObject* root = scene->FindByName(StringId::intern(u8"Root"));
+    GameObject* copy = Instantiate(prefab, Vector3(10.0f, 0.0f, 0.0f), Quaternion::identity, root->transform);
+    SphereCollider* collider = copy->GetComponent<SphereCollider>(true);
+    ASSERT_NE(collider, nullptr);
+    EXPECT_EQ(collider->attachedRigidbody, copy->GetComponent<Rigidbody>(true));
+    EXPECT_EQ(collider->getWorld(), scene->GetPhysicsScene());
+}
+
+
+// コピーできないコンポーネントは外し、それ以外は複製する
+TEST(Prefab, NonCopyableComponentsAreLeftOut)
+{
+    HeadlessLoop loop(bodyScene);
+    loop.step(1);
+
+    GameObject* body = UniDxTest::findObject(u8"Body");
+    ASSERT_NE(body, nullptr);
+
+    Prefab prefab(*body);
+    auto copy = prefab.Instantiate(Vector3(0.0f, 0.0f, 0.0f));
+    EXPECT_EQ(copy->GetComponent<Gauge>(true), nullptr);
+    ASSERT_NE(copy->GetComponent<Marker>(true), nullptr);
+    EXPECT_EQ(copy->GetComponent<Marker>(true)->id, 7);
+}
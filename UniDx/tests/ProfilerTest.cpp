@@ -0,0 +1,51 @@
+﻿#include <gtest/gtest.h>
+
+#include <UniDx/Profiler.h>
+#include <UniDx/Jobs.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace UniDx;
+
+
+// メインスレッドとワーカーの区間が、キャプチャ開始からの時刻で書き出される
+TEST(Profiler, CapturesScopesFromWorkersIntoTheTrace)
+{
+    Jobs::create();
+    Profiler::BeginCapture();
+    {
+        UNIDX_PROFILE_SCOPE("Test/Main");
+        Jobs* jobs = Jobs::getInstance();
+        jobs->wait(jobs->parallelFor(64, 1, [](size_t, size_t) {
+            UNIDX_PROFILE_SCOPE("Test/Worker");
+        }));
+    }
+    Profiler::EndCapture();
+    Jobs::destroy();
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "unidx_profiler_test.json";
+    ASSERT_TRUE(Profiler::WriteChromeTrace(path.u8string()));
+
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    const std::string trace = text.str();
+    std::filesystem::remove(path);
+
+    EXPECT_NE(trace.find("\"name\":\"Test/Main\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"Test/Worker\""), std::string::npos);
+    EXPECT_EQ(trace.find("\"ts\":-"), std::string::npos);
+}
+
+
+TEST(Profiler, NowIsMeasuredFromBeginCapture)
+{
+    Profiler::BeginCapture();
+    const int64_t t = Profiler::now();
+    Profiler::EndCapture();
+
+    EXPECT_GE(t, 0);
+    EXPECT_LT(t, int64_t(1000000000));
+}
@@ -0,0 +1,153 @@
+﻿#include <gtest/gtest.h>
+
+#include "TestScene.h"
+
+#include <UniDx/Camera.h>
+#include <UniDx/Material.h>
+#include <UniDx/Mesh.h>
+#include <UniDx/RenderBackend.h>
+#include <UniDx/Renderer.h>
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+using UniDxTest::findObject;
+
+
+namespace
+{
+
+std::shared_ptr<Material> s_opaque;
+std::shared_ptr<Material> s_transparent;
+
+std::shared_ptr<Material> makeMaterial(RenderingMode mode)
+{
+    auto material = std::make_shared<Material>();
+    material->renderingMode = mode;
+    return material;
+}
+
+// サブメッシュを submeshCount 個持ち、すべて material で描くレンダラー
+std::unique_ptr<MeshRenderer> meshRenderer(const std::shared_ptr<Material>& material, int submeshCount)
+{
+    auto renderer = std::make_unique<MeshRenderer>();
+    for (int i = 0; i < submeshCount; ++i)
+    {
+        renderer->mesh.submesh.push_back(std::make_shared<SubMesh>());
+        renderer->AddMaterial(material);
+    }
+    return renderer;
+}
+
+// 不透明が2つ（片方はサブメッシュ2つ）、半透明が1つ
+std::unique_ptr<Scene> renderScene()
+{
+    s_opaque = makeMaterial(RenderingMode_Opaque);
+    s_transparent = makeMaterial(RenderingMode_Transparent);
+
+    auto scene = std::make_unique<Scene>(std::make_unique<GameObject>(u8"World", Vector3(0.0f, 0.0f, 0.0f)));
+    GameObject* root = scene->GetRootGameObjects().front().get();
+    Transform::SetParent(std::make_unique<GameObject>(u8"Camera", Vector3(0.0f, 0.0f, -10.0f),
+        std::make_unique<Camera>()), root->transform);
+    Transform::SetParent(std::make_unique<GameObject>(u8"Glass", Vector3(0.0f, 1.0f, 0.0f),
+        meshRenderer(s_transparent, 1)), root->transform);
+    Transform::SetParent(std::make_unique<GameObject>(u8"Box", Vector3(2.0f, 0.0f, 0.0f),
+        meshRenderer(s_opaque, 2)), root->transform);
+    Transform::SetParent(std::make_unique<GameObject>(u8"Floor", Vector3(0.0f, -1.0f, 0.0f),
+        meshRenderer(s_opaque, 1)), root->transform);
+    return scene;
+}
+
+void expectTranslation(const Matrix4x4& world, Vector3 position)
+{
+    EXPECT_FLOAT_EQ(world.m30, position.x);
+    EXPECT_FLOAT_EQ(world.m31, position.y);
+    EXPECT_FLOAT_EQ(world.m32, position.z);
+}
+
+} // namespace
+
+
+// 不透明を先に、半透明を後に積み、同じマテリアルは1つのパケットにまとめる
+TEST(RenderBackend, RecordsDrawsByPassWithSharedMaterials)
+{
+    HeadlessLoop loop(renderScene);
+    auto backend = std::make_unique<RecordingRenderBackend>();
+    RecordingRenderBackend* recording = backend.get();
+    loop.loop()->SetRenderBackend(std::move(backend));
+
+    loop.step(1);
+
+    ASSERT_EQ(recording->frames().size(), size_t(1));
+    const RecordingRenderBackend::Frame& frame = recording->frames().front();
+    EXPECT_TRUE(frame.hasCamera);
+    EXPECT_EQ(frame.materialCount, size_t(2));
+
+    ASSERT_EQ(frame.draws.size(), size_t(4));
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(frame.draws[i].kind, DrawPacket::Kind_Mesh);
+        EXPECT_EQ(frame.draws[i].pass, RenderPass_Opaque);
+        EXPECT_EQ(frame.draws[i].material, s_opaque.get());
+    }
+    EXPECT_EQ(frame.draws[3].pass, RenderPass_Transparent);
+    EXPECT_EQ(frame.draws[3].material, s_transparent.get());
+
+    // サブメッシュごとに1つずつ、同じ姿勢で積む
+    const auto& box = findObject(u8"Box")->GetComponent<MeshRenderer>(true)->mesh.submesh;
+    EXPECT_EQ(frame.draws[0].mesh, box[0].get());
+    EXPECT_EQ(frame.draws[1].mesh, box[1].get());
+    expectTranslation(frame.draws[0].world, Vector3(2.0f, 0.0f, 0.0f));
+    expectTranslation(frame.draws[1].world, Vector3(2.0f, 0.0f, 0.0f));
+    expectTranslation(frame.draws[2].world, Vector3(0.0f, -1.0f, 0.0f));
+    expectTranslation(frame.draws[3].world, Vector3(0.0f, 1.0f, 0.0f));
+
+    s_opaque.reset();
+    s_transparent.reset();
+}
+
+
+// 動かしたオブジェクトと無効にしたレンダラーが次のフレームのパケットに反映される
+TEST(RenderBackend, LaterFramesFollowTheScene)
+{
+    HeadlessLoop loop(renderScene);
+    auto backend = std::make_unique<RecordingRenderBackend>();
+    RecordingRenderBackend* recording = backend.get();
+    loop.loop()->SetRenderBackend(std::move(backend));
+
+    loop.step(1);
+    findObject(u8"Floor")->transform->position = Vector3(0.0f, -5.0f, 0.0f);
+    findObject(u8"Glass")->GetComponent<MeshRenderer>(true)->enabled = false;
+    loop.step(1);
+
+    ASSERT_EQ(recording->frames().size(), size_t(2));
+    const RecordingRenderBackend::Frame& frame = recording->frames().back();
+    EXPECT_EQ(frame.materialCount, size_t(1));
+    ASSERT_EQ(frame.draws.size(), size_t(3));
+    expectTranslation(frame.draws[2].world, Vector3(0.0f, -5.0f, 0.0f));
+    for (const auto& draw : frame.draws)
+    {
+        EXPECT_EQ(draw.pass, RenderPass_Opaque);
+    }
+
+    s_opaque.reset();
+    s_transparent.reset();
+}
+
+
+// カメラがなければメッシュは積まず、フレームだけが届く
+TEST(RenderBackend, NoCameraSubmitsEmptyFrame)
+{
+    HeadlessLoop loop([]() {
+        return std::make_unique<Scene>(std::make_unique<GameObject>(u8"Floor", Vector3(0.0f, 0.0f, 0.0f),
+            meshRenderer(makeMaterial(RenderingMode_Opaque), 1)));
+    });
+    auto backend = std::make_unique<RecordingRenderBackend>();
+    RecordingRenderBackend* recording = backend.get();
+    loop.loop()->SetRenderBackend(std::move(backend));
+
+    loop.step(2);
+
+    ASSERT_EQ(recording->frames().size(), size_t(2));
+    EXPECT_FALSE(recording->frames().back().hasCamera);
+    EXPECT_TRUE(recording->frames().back().draws.empty());
+}
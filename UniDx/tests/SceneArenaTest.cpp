@@ -0,0 +1,42 @@
+﻿#include <gtest/gtest.h>
+
+#include "TestScene.h"
+
+#include <UniDx/SceneArena.h>
+
+using namespace UniDx;
+
+
+namespace
+{
+
+class Marker : public Component
+{
+};
+
+} // namespace
+
+
+// 構築中に作ったオブジェクトだけがアリーナから確保され、実行中の追加はヒープに行く
+TEST(SceneArena, OnlyConstructionAllocatesFromTheArena)
+{
+    SceneArena* arena = SceneArena::create(4096);
+    unique_ptr<GameObject> object;
+    {
+        SceneArena::Scope scope(arena);
+        object = make_unique<GameObject>(u8"Object");
+    }
+    const size_t live = arena->liveCount();
+    EXPECT_GT(live, 0u);
+
+    for (int i = 0; i < 32; ++i)
+    {
+        object->AddComponent<Marker>();
+    }
+    EXPECT_EQ(object->GetComponents().size(), 33u);
+    EXPECT_EQ(arena->liveCount(), live);
+
+    object.reset();
+    EXPECT_EQ(arena->liveCount(), 0u);
+    arena->release();
+}
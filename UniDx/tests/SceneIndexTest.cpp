@@ -0,0 +1,98 @@
+﻿#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "TestScene.h"
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+using UniDxTest::findObject;
+
+
+namespace
+{
+
+// Root の下に Enemy タグの A と B、タグなしの C
+std::unique_ptr<Scene> taggedScene()
+{
+    auto root = std::make_unique<GameObject>(u8"Root");
+    auto a = std::make_unique<GameObject>(u8"A");
+    auto b = std::make_unique<GameObject>(u8"B");
+    a->setTag(u8"Enemy");
+    b->setTag(u8"Enemy");
+    Transform::SetParent(std::move(a), root->transform);
+    Transform::SetParent(std::move(b), root->transform);
+    Transform::SetParent(std::make_unique<GameObject>(u8"C"), root->transform);
+    return std::make_unique<Scene>(std::move(root));
+}
+
+Scene* activeScene()
+{
+    return SceneManager::getInstance()->GetActiveScene();
+}
+
+bool contains(const std::vector<GameObject*>& objects, GameObject* o)
+{
+    return std::find(objects.begin(), objects.end(), o) != objects.end();
+}
+
+} // namespace
+
+
+// SetName() で名前の索引が付け替わる
+TEST(SceneIndex, SetNameMovesNameIndex)
+{
+    HeadlessLoop loop(taggedScene);
+    loop.step(1);
+
+    GameObject* c = findObject(u8"C");
+    ASSERT_NE(c, nullptr);
+    c->SetName(StringId::intern(u8"Renamed"));
+
+    EXPECT_EQ(findObject(u8"C"), nullptr);
+    EXPECT_EQ(findObject(u8"Renamed"), c);
+}
+
+
+// setTag() でタグの索引が付け替わる
+TEST(SceneIndex, SetTagMovesTagIndex)
+{
+    HeadlessLoop loop(taggedScene);
+    loop.step(1);
+
+    const StringId enemy = StringId::intern(u8"Enemy");
+    const StringId player = StringId::intern(u8"Player");
+    GameObject* a = findObject(u8"A");
+    GameObject* c = findObject(u8"C");
+    EXPECT_EQ(activeScene()->FindGameObjectsWithTag(enemy).size(), 2u);
+
+    a->setTag(player);
+    c->setTag(enemy);
+
+    EXPECT_EQ(activeScene()->FindWithTag(player), a);
+    auto enemies = activeScene()->FindGameObjectsWithTag(enemy);
+    EXPECT_EQ(enemies.size(), 2u);
+    EXPECT_FALSE(contains(enemies, a));
+    EXPECT_TRUE(contains(enemies, c));
+    EXPECT_TRUE(contains(enemies, findObject(u8"B")));
+}
+
+
+// Destroy() してフレームの終わりを待っているものは検索に出てこない
+TEST(SceneIndex, DestroyedObjectsAreNotFound)
+{
+    HeadlessLoop loop(taggedScene);
+    loop.step(1);
+
+    const StringId enemy = StringId::intern(u8"Enemy");
+    GameObject* a = findObject(u8"A");
+    GameObject* b = findObject(u8"B");
+    Destroy(a);
+
+    EXPECT_EQ(findObject(u8"A"), nullptr);
+    EXPECT_EQ(activeScene()->FindWithTag(enemy), b);
+    EXPECT_EQ(activeScene()->FindGameObjectsWithTag(enemy), std::vector<GameObject*>{ b });
+
+    loop.step(1);
+    EXPECT_EQ(activeScene()->FindGameObjectsWithTag(enemy), std::vector<GameObject*>{ b });
+}
@@ -0,0 +1,53 @@
+﻿#include <gtest/gtest.h>
+
+#include <UniDx/Jobs.h>
+#include <UniDx/StringId.h>
+
+#include <string>
+#include <vector>
+
+using namespace UniDx;
+
+
+namespace
+{
+
+constexpr size_t NameCount = 5000;
+constexpr size_t Rounds = 4;
+
+// まだプールにない名前にして、表の追加と拡張も同時に起こす
+std::string nameOf(size_t i)
+{
+    return "ConcurrentIntern" + std::to_string(i);
+}
+
+} // namespace
+
+
+// ワーカーから同じ文字列を同時に intern しても、どのスレッドにも同じ StringId が返る
+TEST(StringId, ConcurrentInternReturnsSameId)
+{
+    Jobs::create();
+
+    // 同じ名前を Rounds 回ずつ、奇数回目は逆順に並べて別のバッチから重ねる
+    std::vector<StringId> results(NameCount * Rounds);
+    auto nameIndex = [](size_t i) {
+        size_t round = i / NameCount;
+        size_t n = i % NameCount;
+        return round % 2 == 0 ? n : NameCount - 1 - n;
+    };
+    Jobs::getInstance()->wait(Jobs::getInstance()->parallelFor(results.size(), 32, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            results[i] = StringId::intern(nameOf(nameIndex(i)));
+        }
+    }));
+    Jobs::destroy();
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        std::string name = nameOf(nameIndex(i));
+        ASSERT_EQ(results[i], StringId::intern(name)) << name;
+        ASSERT_EQ(std::string(results[i]), name);
+    }
+}
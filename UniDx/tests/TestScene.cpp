@@ -0,0 +1,29 @@
+﻿#include "TestScene.h"
+
+
+namespace
+{
+    std::function<std::unique_ptr<UniDx::Scene>()> sceneFactory;
+}
+
+
+// ゲーム側で定義する初期シーンの作成と破棄。テストでは差し替えた関数で作る
+std::unique_ptr<UniDx::Scene> CreateDefaultScene()
+{
+    return sceneFactory ? sceneFactory() : std::make_unique<UniDx::Scene>();
+}
+
+void DestroyDefaultScene()
+{
+}
+
+
+namespace UniDxTest
+{
+
+void SetSceneFactory(std::function<std::unique_ptr<UniDx::Scene>()> factory)
+{
+    sceneFactory = std::move(factory);
+}
+
+} // namespace UniDxTest
@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include <functional>
+#include <memory>
+#include <string_view>
+
+#include <UniDx/UniDx.h>
+#include <UniDx/Scene.h>
+#include <UniDx/SceneManager.h>
+#include <UniDx/PlayerLoop.h>
+#include <UniDx/Clock.h>
+#include <UniDx/Time.h>
+
+
+namespace UniDxTest
+{
+
+/** @brief CreateDefaultScene() が返すシーンを作る関数を差し替える。テストごとに設定する */
+void SetSceneFactory(std::function<std::unique_ptr<UniDx::Scene>()> factory);
+
+/** @brief アクティブなシーンから名前が一致するGameObjectを探す（なければ nullptr） */
+inline UniDx::GameObject* findObject(std::u8string_view name)
+{
+    return UniDx::SceneManager::getInstance()->GetActiveScene()->FindByName(UniDx::StringId::intern(name));
+}
+
+
+// --------------------
+// HeadlessLoopクラス
+// ヘッドレスの PlayerLoop を固定ステップのクロックで作り、スコープを抜けたら片付ける
+// --------------------
+class HeadlessLoop
+{
+public:
+    // step が 0 なら Time::fixedDeltaTime ずつ進め、毎フレーム FixedUpdate を1回回す
+    explicit HeadlessLoop(std::function<std::unique_ptr<UniDx::Scene>()> factory, double step = 0.0)
+    {
+        SetSceneFactory(std::move(factory));
+        if (step <= 0.0) step = UniDx::Time::fixedDeltaTime;
+        UniDx::Time::SetClock(std::make_unique<UniDx::FixedStepClock>(step));
+        UniDx::PlayerLoop::create();
+        loop()->multithreadedRendering = false;
+        loop()->InitializeHeadless();
+    }
+
+    ~HeadlessLoop()
+    {
+        loop()->Shutdown();
+        UniDx::PlayerLoop::destroy();
+        UniDx::Time::SetClock(nullptr);
+        SetSceneFactory(nullptr);
+    }
+
+    HeadlessLoop(const HeadlessLoop&) = delete;
+    HeadlessLoop& operator=(const HeadlessLoop&) = delete;
+
+    UniDx::PlayerLoop* loop() const { return UniDx::PlayerLoop::getInstance(); }
+    void step(int frames) { loop()->StepFrames(frames); }
+};
+
+} // namespace UniDxTest
@@ -0,0 +1,243 @@
+﻿#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "TestScene.h"
+
+using namespace UniDx;
+using UniDxTest::HeadlessLoop;
+
+
+namespace
+{
+
+void expectNear(const Vector3& actual, const Vector3& expected)
+{
+    EXPECT_NEAR(actual.x, expected.x, 1e-4f);
+    EXPECT_NEAR(actual.y, expected.y, 1e-4f);
+    EXPECT_NEAR(actual.z, expected.z, 1e-4f);
+}
+
+
+// 1つの深さにジョブで分割されるだけの数を並べた3段の階層
+constexpr int WideChildCount = 600;
+
+std::unique_ptr<Scene> wideScene()
+{
+    auto root = std::make_unique<GameObject>(u8"Root");
+    for (int i = 0; i < WideChildCount; ++i)
+    {
+        std::u8string name = u8"Child" + ToUtf8(std::to_wstring(i));
+        auto child = std::make_unique<GameObject>(name.c_str(), Vector3(float(i), 0.0f, 0.0f));
+        Transform* parent = child->transform;
+        Transform::SetParent(std::move(child), root->transform);
+        Transform::SetParent(std::make_unique<GameObject>(u8"Grandchild", Vector3(0.0f, 1.0f, 0.0f)), parent);
+    }
+    return std::make_unique<Scene>(std::move(root));
+}
+
+
+// 破棄された数を数える
+class LifetimeProbe : public Component
+{
+public:
+    static inline int destroyedCount = 0;
+
+    virtual ~LifetimeProbe() override { ++destroyedCount; }
+};
+
+std::u8string childName(int i)
+{
+    return u8"C" + ToUtf8(std::to_wstring(i));
+}
+
+// Root の下に A と B。A の下に C0～C4
+std::unique_ptr<Scene> siblingScene()
+{
+    auto root = std::make_unique<GameObject>(u8"Root");
+    auto a = std::make_unique<GameObject>(u8"A");
+    for (int i = 0; i < 5; ++i)
+    {
+        Transform::SetParent(std::make_unique<GameObject>(childName(i).c_str(), std::make_unique<LifetimeProbe>()),
+            a->transform);
+    }
+    Transform::SetParent(std::move(a), root->transform);
+    Transform::SetParent(std::make_unique<GameObject>(u8"B"), root->transform);
+    return std::make_unique<Scene>(std::move(root));
+}
+
+GameObject* child(int i)
+{
+    return UniDxTest::findObject(childName(i));
+}
+
+// 子を先頭からたどった順
+std::vector<GameObject*> childrenOf(const char8_t* name)
+{
+    std::vector<GameObject*> result;
+    for (GameObject* c : UniDxTest::findObject(name)->transform->getChildGameObjects())
+    {
+        result.push_back(c);
+    }
+    return result;
+}
+
+} // namespace
+
+
+TEST(Transform, SetForwardTurnsTowardsDirection)
+{
+    GameObject object(u8"Object");
+    Transform* t = object.transform;
+
+    t->forward = Vector3(1.0f, 0.0f, 0.0f);
+
+    expectNear(t->forward, Vector3(1.0f, 0.0f, 0.0f));
+    expectNear(t->up, Vector3(0.0f, 1.0f, 0.0f));
+}
+
+
+TEST(Transform, SetUpKeepsForwardWhenPossible)
+{
+    GameObject object(u8"Object");
+    Transform* t = object.transform;
+
+    t->up = Vector3(0.0f, 0.0f, -1.0f);
+
+    expectNear(t->up, Vector3(0.0f, 0.0f, -1.0f));
+    EXPECT_NEAR(Dot(t->forward, t->up), 0.0f, 1e-4f);
+}
+
+
+TEST(Transform, SetRightKeepsUp)
+{
+    GameObject object(u8"Object");
+    Transform* t = object.transform;
+
+    t->right = Vector3(0.0f, 0.0f, 1.0f);
+
+    expectNear(t->right, Vector3(0.0f, 0.0f, 1.0f));
+    expectNear(t->up, Vector3(0.0f, 1.0f, 0.0f));
+    expectNear(t->forward, Vector3(-1.0f, 0.0f, 0.0f));
+}
+
+
+TEST(Transform, LocalMatrixAppliesScaleRotationTranslation)
+{
+    GameObject object(u8"Object");
+    Transform* t = object.transform;
+
+    t->localScale = Vector3(2.0f, 2.0f, 2.0f);
+    t->localRotation = Quaternion::AngleAxis(90.0f, Vector3::up);
+    t->localPosition = Vector3(1.0f, 2.0f, 3.0f);
+
+    // 拡大してから Y 軸で 90 度回し、最後に平行移動する
+    expectNear(t->TransformPoint(Vector3(1.0f, 0.0f, 0.0f)), Vector3(1.0f, 2.0f, 1.0f));
+}
+
+
+// 親を動かすと、深さごとに並列に更新された配列のワールド行列がすべて追従する
+TEST(TransformHierarchy, WideHierarchyFollowsRootInParallel)
+{
+    HeadlessLoop loop(wideScene);
+    loop.step(1);
+
+    Scene* scene = SceneManager::getInstance()->GetActiveScene();
+    GameObject* root = scene->FindByName(StringId::intern(u8"Root"));
+    ASSERT_NE(root, nullptr);
+    root->transform->localPosition = Vector3(0.0f, 10.0f, 0.0f);
+    loop.step(1);
+
+    TransformHierarchy* hierarchy = scene->GetTransformHierarchy();
+    ASSERT_EQ(hierarchy->size(), size_t(1 + WideChildCount * 2));
+
+    auto transforms = hierarchy->transforms();
+    auto parents = hierarchy->parentIndices();
+    auto worlds = hierarchy->worldMatrices();
+    const DirectX::XMFLOAT3 origin(0.0f, 0.0f, 0.0f);
+    for (size_t i = 0; i < hierarchy->size(); ++i)
+    {
+        Vector3 expected(0.0f, 10.0f, 0.0f);
+        if (parents[i] >= 0)
+        {
+            Vector3 local = transforms[i]->localPosition;
+            expected = worlds[parents[i]].MultiplyPoint(origin) + local;
+            ASSERT_LT(parents[i], int(i));
+        }
+        expectNear(worlds[i].MultiplyPoint(origin), expected);
+    }
+    expectNear(transforms.back()->position, Vector3(float(WideChildCount - 1), 11.0f, 0.0f));
+}
+
+
+// 別の親へ移すと元の兄弟の順は保たれ、移した先では末尾に付く
+TEST(TransformChildren, ReparentKeepsSiblingOrder)
+{
+    LifetimeProbe::destroyedCount = 0;
+    HeadlessLoop loop(siblingScene);
+    loop.step(1);
+
+    Transform* a = UniDxTest::findObject(u8"A")->transform;
+    Transform* b = UniDxTest::findObject(u8"B")->transform;
+    GameObject* moved = child(2);
+
+    EXPECT_EQ(moved->transform->SetParent(b), moved);
+    EXPECT_EQ(moved->transform->parent, b);
+    EXPECT_EQ(childrenOf(u8"A"), (std::vector<GameObject*>{ child(0), child(1), child(3), child(4) }));
+    EXPECT_EQ(childrenOf(u8"B"), (std::vector<GameObject*>{ moved }));
+    EXPECT_EQ(a->childCount(), 4u);
+    EXPECT_EQ(a->GetChild(2), child(3)->transform);
+
+    // 戻すと末尾に付く。同じオブジェクトのまま、名前でも引ける
+    EXPECT_EQ(moved->transform->SetParent(a), moved);
+    EXPECT_EQ(childrenOf(u8"A"), (std::vector<GameObject*>{ child(0), child(1), child(3), child(4), moved }));
+    EXPECT_EQ(b->childCount(), 0u);
+    EXPECT_EQ(child(2), moved);
+    EXPECT_EQ(LifetimeProbe::destroyedCount, 0);
+
+    loop.step(1);
+    EXPECT_EQ(LifetimeProbe::destroyedCount, 0);
+}
+
+
+// 真ん中の兄弟を破棄すると、その1つだけが削除されて前後がつながる
+TEST(TransformChildren, DestroyMiddleSiblingUnlinksOnlyIt)
+{
+    LifetimeProbe::destroyedCount = 0;
+    HeadlessLoop loop(siblingScene);
+    loop.step(1);
+
+    GameObject* c0 = child(0);
+    GameObject* c1 = child(1);
+    GameObject* c3 = child(3);
+    GameObject* c4 = child(4);
+    Destroy(child(2));
+    loop.step(1);
+
+    EXPECT_EQ(LifetimeProbe::destroyedCount, 1);
+    EXPECT_EQ(child(2), nullptr);
+    EXPECT_EQ(childrenOf(u8"A"), (std::vector<GameObject*>{ c0, c1, c3, c4 }));
+    EXPECT_EQ(c1->transform->GetChild(0), nullptr);
+    EXPECT_EQ(UniDxTest::findObject(u8"A")->transform->GetChild(2), c3->transform);
+}
+
+
+// 移した子は元の親と一緒には破棄されない
+TEST(TransformChildren, ReparentedChildOutlivesOldParent)
+{
+    LifetimeProbe::destroyedCount = 0;
+    HeadlessLoop loop(siblingScene);
+    loop.step(1);
+
+    GameObject* moved = child(1);
+    moved->transform->SetParent(UniDxTest::findObject(u8"B")->transform);
+    Destroy(UniDxTest::findObject(u8"A"));
+    loop.step(1);
+
+    // A の下に残った4つだけが破棄される
+    EXPECT_EQ(LifetimeProbe::destroyedCount, 4);
+    EXPECT_EQ(UniDxTest::findObject(u8"A"), nullptr);
+    EXPECT_EQ(child(1), moved);
+    EXPECT_EQ(childrenOf(u8"B"), (std::vector<GameObject*>{ moved }));
+}
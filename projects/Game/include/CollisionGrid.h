@@ -3,6 +3,7 @@
 #include <UniDx.h>
 #include <UniDx/Collider.h>
 #include <UniDx/Physics.h>
+#include <UniDx/FrameArena.h>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -64,11 +65,8 @@ private:
     // 動的オブジェクトのTransformリスト.
     std::vector<Transform*> dynamicObjects_;
 
-    // 現在有効なセル.
-    std::unordered_set<CellCoord, CellHash> activeCells_;
-
-    // 前フレームで有効だったセル.
-    std::unordered_set<CellCoord, CellHash> prevActiveCells_;
+    // 前フレームで有効だったセル（昇順、重複なし）.
+    std::vector<CellCoord> prevActiveCells_;
 
     // 現在Physicsに登録されているコライダー.
     std::unordered_set<Collider*> registeredColliders_;
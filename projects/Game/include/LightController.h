@@ -5,6 +5,8 @@
 class LightController : public UniDx::Behaviour
 {
 public:
+    static constexpr bool parallelUpdate = true;
+
     virtual void OnEnable() override;
     virtual void Update() override;
 
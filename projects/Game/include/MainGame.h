@@ -8,6 +8,7 @@ namespace UniDx
 {
     class Scene;
     class TextMesh;
+    class ObjectPool;
 }
 
 class CollisionGrid;
@@ -27,6 +28,8 @@ public:
 protected:
     int score = 0;
     unique_ptr<UniDx::GameObject> mapObj;
+    unique_ptr<UniDx::GameObject> coinPoolObj;
+    UniDx::ObjectPool* coinPool = nullptr;
     UniDx::TextMesh* scoreTextMesh;
 
     void createMap();
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <UniDx.h>
-#include <UniDx/Rigidbody.h>
+#include <UniDx/CharacterController.h>
 
 using namespace UniDx;
 
@@ -16,21 +16,18 @@ public:
     virtual void OnCollisionEnter(const Collision& collision) override;
     virtual void OnCollisionStay(const Collision& collision) override;
     virtual void OnCollisionExit(const Collision& collision) override;
+    virtual void OnControllerColliderHit(const ControllerColliderHit& hit) override;
 
-    UniDx::Rigidbody* rb = nullptr;
+    UniDx::CharacterController* controller = nullptr;
 
     // 接地判定.
-    bool isGrounded() const { return groundContactCount > 0; }
-    void onGroundEnter();
-    void onGroundExit();
+    bool isGrounded() const { return controller->isGrounded(); }
 
 private:
     float animFrame;
-    int groundContactCount = 0;    // 地面との接触数.
+    float gravityScale = 2.0f;      // 重力スケール.
+    float fallSpeed = 0.0f;         // 重力で溜まった縦方向の速度（上向きが正）.
     float jumpTimer = 0.0f;         // ジャンプ経過時間（秒）.
     float jumpDuration = 1.5;     // ジャンプ最大時間（秒）.
-    float gravityScaleTimer = 0.0f; // 重力スケール用タイマー（秒）.
     bool isJumping = false;         // ジャンプ中フラグ.
-
-    void createGroundCheck();      // 足元トリガー作成.
 };
@@ -15,7 +15,11 @@ void CollisionGrid::enableCollider(Collider* col)
 {
     if (col && registeredColliders_.find(col) == registeredColliders_.end())
     {
-        Physics::getInstance()->register3d(col);
+        // シーンに属していなければ登録先がないので、次に有効になったときに登録し直す.
+        Physics* world = Physics::of(gameObject);
+        if (world == nullptr) return;
+
+        world->register3d(col);
         registeredColliders_.insert(col);
     }
 }
@@ -25,7 +29,10 @@ void CollisionGrid::disableCollider(Collider* col)
 {
     if (col && registeredColliders_.find(col) != registeredColliders_.end())
     {
-        Physics::getInstance()->unregister3d(col);
+        if (Physics* world = Physics::of(gameObject))
+        {
+            world->unregister3d(col);
+        }
         registeredColliders_.erase(col);
     }
 }
@@ -43,7 +50,10 @@ void CollisionGrid::registerStatic(Collider* collider)
     staticColliders_[cell].push_back(collider);
 
     // 初期状態ではPhysicsから解除（OnEnableで登録されているので解除）.
-    Physics::getInstance()->unregister3d(collider);
+    if (Physics* world = Physics::of(gameObject))
+    {
+        world->unregister3d(collider);
+    }
 }
 
 
@@ -101,8 +111,10 @@ void CollisionGrid::Update()
     // 動的オブジェクトがない場合は処理しない.
     if (dynamicObjects_.empty()) return;
 
-    // 現在有効なセルをクリア.
-    activeCells_.clear();
+    // 現在有効なセル（フレームの作業用メモリに作る）.
+    std::pmr::vector<CellCoord> activeCells(FrameArena::resource());
+    const size_t cellsPerObject = size_t(2 * activeRadius + 1) * size_t(2 * activeRadius + 1) * size_t(2 * activeRadius + 1);
+    activeCells.reserve(dynamicObjects_.size() * cellsPerObject);
 
     // 各動的オブジェクトの周囲セルを有効セットに追加.
     for (Transform* dynObj : dynamicObjects_)
@@ -120,46 +132,53 @@ void CollisionGrid::Update()
             {
                 for (int dz = -activeRadius; dz <= activeRadius; ++dz)
                 {
-                    activeCells_.insert({ cx + dx, cy + dy, cz + dz });
+                    activeCells.push_back({ cx + dx, cy + dy, cz + dz });
                 }
             }
         }
     }
 
+    // 並べて重複を除き、前フレームとの差分を先頭からたどって求める.
+    std::sort(activeCells.begin(), activeCells.end());
+    activeCells.erase(std::unique(activeCells.begin(), activeCells.end()), activeCells.end());
+
+    // from にあって in にないセルに func を呼ぶ（どちらも昇順）.
+    auto forEachMissing = [](const auto& from, const auto& in, auto&& func)
+    {
+        auto it = in.begin();
+        for (const CellCoord& cell : from)
+        {
+            while (it != in.end() && *it < cell) ++it;
+            if (it == in.end() || cell < *it) func(cell);
+        }
+    };
+
     // 前フレームから無効になったセルのコライダーを無効化.
-    for (const CellCoord& cell : prevActiveCells_)
+    forEachMissing(prevActiveCells_, activeCells, [this](const CellCoord& cell)
     {
-        if (activeCells_.find(cell) == activeCells_.end())
+        auto it = staticColliders_.find(cell);
+        if (it != staticColliders_.end())
         {
-            // このセルは無効になった.
-            auto it = staticColliders_.find(cell);
-            if (it != staticColliders_.end())
+            for (Collider* col : it->second)
             {
-                for (Collider* col : it->second)
-                {
-                    disableCollider(col);
-                }
+                disableCollider(col);
             }
         }
-    }
+    });
 
     // 新しく有効になったセルのコライダーを有効化.
-    for (const CellCoord& cell : activeCells_)
+    forEachMissing(activeCells, prevActiveCells_, [this](const CellCoord& cell)
     {
-        if (prevActiveCells_.find(cell) == prevActiveCells_.end())
+        auto it = staticColliders_.find(cell);
+        if (it != staticColliders_.end())
         {
-            // このセルは新しく有効になった.
-            auto it = staticColliders_.find(cell);
-            if (it != staticColliders_.end())
+            for (Collider* col : it->second)
             {
-                for (Collider* col : it->second)
-                {
-                    enableCollider(col);
-                }
+                enableCollider(col);
             }
         }
-    }
+    });
 
-    // 現在のセットを前フレームとして保存.
-    prevActiveCells_ = activeCells_;
+    // 現在のセルを前フレームとして保存（確保済みの領域を使い回す）.
+    prevActiveCells_.assign(activeCells.begin(), activeCells.end());
 }
@@ -13,6 +13,8 @@
 #include <UniDx/Image.h>
 #include <UniDx/LightManager.h>
 #include <UniDx/Layer.h>
+#include <UniDx/ObjectPool.h>
+#include <UniDx/Prefab.h>
 
 #include "CameraController.h"
 #include "Player.h"
@@ -106,16 +108,30 @@ void MainGame::createMap()
         return wall;
     });
 
+    // コインのプレハブ. モデルの読み込みはここで1回だけ.
+    auto coin = make_unique<GameObject>(u8"Coin",
+        make_unique<GltfModel>(),
+        make_unique<Rigidbody>(),
+        make_unique<SphereCollider>(Vector3(0, -0.1f, 0), 0.4f));
+    auto coinModel = coin->GetComponent<GltfModel>(true);
+    coinModel->Load<VertexPN>(u8"resource/coin.glb", coinMat);
+    coin->transform->localScale = Vector3(3, 3, 3);
+    auto coinPrefab = make_shared<Prefab>(move(coin));
+
+    // コインはプールから取り出して使い回す.
+    // プールが足りないときもプレハブの複製なので、メッシュやマテリアルは共有される.
+    auto pool = make_unique<ObjectPool>([coinPrefab]() {
+        return coinPrefab->Instantiate(Vector3::zero);
+    });
+    coinPool = pool.get();
+    coinPoolObj = make_unique<GameObject>(u8"コインプール", move(pool));
+    coinPool->Prewarm(8);   // インスタンスはプールの子になるので、GameObjectに付けてから作る
+
     // コインオブジェクト登録 'c'.
-    builder.Register('c', [&coinMat](Vector3 pos, Vector3 size) {
-        auto coin = make_unique<GameObject>(u8"Coin",
-            make_unique<GltfModel>(),
-            make_unique<Rigidbody>(),
-            make_unique<SphereCollider>(Vector3(0, -0.1f, 0), 0.4f));
-        auto model = coin->GetComponent<GltfModel>(true);
-        model->Load<VertexPN>(u8"resource/coin.glb", coinMat);
-        coin->transform->localScale = Vector3(3, 3, 3);
-        return coin;
+    // プールのインスタンスを配置するので、マップの階層には加えない.
+    builder.Register('c', [this](Vector3 pos, Vector3 size) {
+        coinPool->Spawn(pos);
+        return unique_ptr<GameObject>();
     });
 
     // 3Dマップデータ [高さ][Z行][X列] - 90度回転済み.
@@ -349,14 +365,14 @@ unique_ptr<UniDx::Scene> MainGame::CreateScene()
     // -- プレイヤー --
     auto playerObj = make_unique<GameObject>(u8"プレイヤー",
         make_unique<GltfModel>(),
-        make_unique<Rigidbody>(),
-        make_unique<SphereCollider>(Vector3(0, 0.25f,0.0f)),
+        make_unique<CharacterController>(),
         make_unique<Player>()
         );
     auto model = playerObj->GetComponent<GltfModel>(true);
     model->Load<VertexSkin>(
         u8"resource/mini_emma.glb",
         u8"resource/SkinBasic.hlsl");
+    playerObj->GetComponent<CharacterController>(true)->center = Vector3(0, 0.25f, 0);
     playerObj->transform->localPosition = Vector3(0, 5, 0);
     playerObj->transform->localRotation = Quaternion::Euler(0, 180, 0);
 
@@ -431,6 +447,7 @@ unique_ptr<UniDx::Scene> MainGame::CreateScene()
         make_unique<GameObject>(u8"オブジェクトルート",
             move(playerObj),
             move(mapObj),
+            move(coinPoolObj),
             move(collisionGridObj)
         ),
 
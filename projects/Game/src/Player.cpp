@@ -1,12 +1,13 @@
 #pragma once
 
 #include "Player.h"
-#include "GroundCheck.h"
 
 #include <UniDx/Input.h>
 #include <UniDx/Collider.h>
 #include <UniDx/Time.h>
+#include <UniDx/Physics.h>
 #include <UniDx/Layer.h>
+#include <UniDx/ObjectPool.h>
 
 #include "MainGame.h"
 
@@ -22,22 +23,17 @@ namespace
 
 void Player::OnEnable()
 {
-    rb = GetComponent<Rigidbody>(true);
-    assert(rb != nullptr);
+    controller = GetComponent<CharacterController>(true);
+    assert(controller != nullptr);
 
-    rb->gravityScale = 30.0f;
+    fallSpeed = 0.0f;
     animFrame = 0.0f;
 
-    // プレイヤー本体のコライダー設定.
-    auto col = GetComponent<Collider>(true);
-    col->bounciness = 0.0f;
-    col->layer = Layer::Player;
+    // キャラクターコントローラーの設定.
+    controller->layer = Layer::Player;
 
     // プレイヤーのレイヤーを設定.
     gameObject->setLayer(Layer::Player);
-
-    // 足元トリガーを作成.
-    createGroundCheck();
 }
 
 void Player::Update()
@@ -97,26 +93,14 @@ void Player::Update()
         }
     }
 
-    // 重力スケールの更新.
-    if (isJumping && jumpTimer <= jumpDuration)
+    // シーンの物理ワールドの重力で落下速度を溜める。接地している間は溜めない.
+    if (isGrounded() && !isJumping)
     {
-        float progress = jumpTimer / jumpDuration;
-        rb->gravityScale = 30.0f * std::sin(progress * 3.14159f * 0.5f);
+        fallSpeed = 0.0f;
     }
     else
     {
-        if (!isGrounded())
-        {
-            gravityScaleTimer += dt;
-            if (gravityScaleTimer > jumpDuration) gravityScaleTimer = jumpDuration;
-            float progress = gravityScaleTimer / jumpDuration;
-            rb->gravityScale = 30.0f * std::sin(progress * 3.14159f * 0.5f);
-        }
-        else
-        {
-            rb->gravityScale = 0;
-            gravityScaleTimer = 0.0f;
-        }
+        fallSpeed += Physics::of(gameObject)->gravity * gravityScale * dt;
     }
 
     Vector3 Yvelocity = Vector3(0, 0, 0);
@@ -137,10 +121,11 @@ void Player::Update()
     Vector3 velocity = (cont.normalized() * moveSpeed) * Quaternion::AngleAxis(camAngle, Vector3::up);
     float vAngle = std::atan2(velocity.x, velocity.z) * UniDx::Rad2Deg;
 
-    rb->linearVelocity = velocity + Yvelocity;
+    Vector3 gravity = Vector3(0, fallSpeed, 0);
+    controller->Move((velocity + Yvelocity + gravity) * dt);
     if (cont != Vector3::zero)
     {
-        rb->rotation = Quaternion::Euler(0, vAngle, 0);
+        transform->rotation = Quaternion::Euler(0, vAngle, 0);
     }
 
     // �A�j���i���Ή��j
@@ -165,11 +150,6 @@ void Player::OnTriggerExit(Collider* other)
 
 void Player::OnCollisionEnter(const Collision& collision)
 {
-    if (collision.collider->name == StringId::intern("Coin"))
-    {
-        MainGame::getInstance()->AddScore(1);
-        Destroy(collision.collider->gameObject);
-    }
 }
 
 
@@ -182,41 +162,12 @@ void Player::OnCollisionExit(const Collision& collision)
 }
 
 
-void Player::onGroundEnter()
+void Player::OnControllerColliderHit(const ControllerColliderHit& hit)
 {
-    groundContactCount++;
-}
-
-
-void Player::onGroundExit()
-{
-    groundContactCount--;
-    if (groundContactCount < 0) groundContactCount = 0;  // 安全対策.
-}
-
-
-void Player::createGroundCheck()
-{
-    // 足元トリガー用の子GameObjectを作成.
-    auto groundCheckObj = std::make_unique<GameObject>(u8"FootTrigger");
-
-    // トリガーコライダーを追加（足元に配置、小さめのサイズ）.
-    auto collider = groundCheckObj->AddComponent<AABBCollider>();
-    collider->center = Vector3(0, 0, 0);
-    collider->size = Vector3(0.2f, 0.1f, 0.2f);  // 足元の小さなボックス.
-    collider->isTrigger = true;
-    collider->layer = Layer::Player;
-    // Groundレイヤーとのみ衝突.
-    collider->layerMask = LayerMask::GetMask(Layer::Ground);
-
-    // GroundCheckコンポーネントを追加.
-    auto groundCheck = groundCheckObj->AddComponent<GroundCheck>();
-    groundCheck->player = this;
-
-    // 足元の位置に配置（プレイヤーの下端）.
-    groundCheckObj->transform->localPosition = Vector3(0, -0.15f, 0);
-
-    // 子オブジェクトとして追加.
-    Transform::SetParent(std::move(groundCheckObj), transform);
+    if (hit.collider->name == "Coin"_sid)
+    {
+        MainGame::getInstance()->AddScore(1);
+        ObjectPool::Release(hit.collider->gameObject);
+    }
 }
 
@@ -6,6 +6,8 @@
 
 #include <UniDx.h>
 #include <UniDx/PlayerLoop.h>
+#include <UniDx/InputReplay.h>
+#include <UniDx/Profiler.h>
 
 #define MAX_LOADSTRING 100
 
@@ -43,7 +45,50 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
         return FALSE;
     }
 
-    int result = PlayerLoop::getInstance()->MainLoop();
+    // 入力の記録・再生（性能の比較用）
+    //   -record <ファイル> : 操作を記録する
+    //   -replay <ファイル> : 記録した操作を再生し、終わったらフレーム時間を <ファイル>.frametimes.csv に書き出して終了する
+    //   -trace <ファイル>  : 区間の記録をとり、終了時に chrome://tracing 形式で書き出す（スレッドごとに直近の分だけ残る）
+    u8string recordPath, replayPath, tracePath;
+    for (int i = 1; i + 1 < __argc; ++i)
+    {
+        if (wcscmp(__wargv[i], L"-record") == 0) recordPath = ToUtf8(__wargv[i + 1]);
+        if (wcscmp(__wargv[i], L"-replay") == 0) replayPath = ToUtf8(__wargv[i + 1]);
+        if (wcscmp(__wargv[i], L"-trace") == 0) tracePath = ToUtf8(__wargv[i + 1]);
+    }
+    if (!replayPath.empty())
+    {
+        InputReplay::StartReplay(replayPath);
+    }
+    else if (!recordPath.empty())
+    {
+        InputReplay::StartRecording();
+    }
+
+    if (!tracePath.empty())
+    {
+        Profiler::BeginCapture();
+    }
+
+    int result = PlayerLoop::Run();
+
+    if (!tracePath.empty())
+    {
+        Profiler::EndCapture();
+        Profiler::WriteChromeTrace(tracePath);
+    }
+
+    if (!replayPath.empty())
+    {
+        InputReplay::WriteFrameTimes(replayPath + u8".frametimes.csv");
+        auto stats = InputReplay::frameTimeStats();
+        Debug::Log(u8"frames " + ToString(stats.count) + u8" mean " + ToString(stats.mean * 1000.0) + u8"ms p95 " + ToString(stats.p95 * 1000.0) + u8"ms max " + ToString(stats.max * 1000.0) + u8"ms");
+    }
+    else if (!recordPath.empty())
+    {
+        InputReplay::StopRecording(recordPath);
+    }
+
     return (int) result;
 }
 
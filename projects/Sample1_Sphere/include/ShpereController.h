@@ -6,6 +6,8 @@
 class ShpereController : public UniDx::Behaviour
 {
 public:
+    static constexpr bool parallelUpdate = true;
+
     virtual void Update() override;
 
 private:
@@ -43,7 +43,8 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
         return FALSE;
     }
 
-    int result = PlayerLoop::getInstance()->MainLoop();
+    int result = PlayerLoop::Run();
+
     return (int) result;
 }
 